@@ -1,3 +1,4 @@
+import json
 import numpy as np
 import matplotlib.pyplot as plt
 import argparse
@@ -8,65 +9,57 @@ parser.add_argument('--show-plot', action='store_true', help='Display the plot')
 parser.add_argument('--coo', action='store_true', help='Show COO data')
 parser.add_argument('--csr', action='store_true', help='Show sequential CSR data')
 parser.add_argument('--par-csr', action='store_true', help='Show parallel CSR data')
+parser.add_argument('--par-sell', action='store_true', help='Show parallel SELL-C-sigma data')
+parser.add_argument('--bench', action='append', default=[], help='Show the records of another binary (repeatable)')
+parser.add_argument('--results', default='results.jsonl', help='JSON Lines file written by the benchmarks')
 args = parser.parse_args()
 
-show_all = not(args.coo or args.csr or args.par_csr)
+# flag -> bench name of the records, label, colours (times, median, p90)
+series = [
+    (args.coo, 'spmv_coo', 'COO', ('red', 'red', 'purple')),
+    (args.csr, 'spmv_csr', 'CSR', ('blue', 'blue', 'gold')),
+    (args.par_csr, 'parallel_spmv_csr', 'Parallel CSR', ('green', 'green', 'yellow')),
+    (args.par_sell, 'parallel_spmv_sell', 'Parallel SELL', ('magenta', 'magenta', 'orange')),
+]
+show_all = not(any(s[0] for s in series) or args.bench)
+selected = [s for s in series if s[0] or show_all]
+selected += [(True, b, b, (None, None, None)) for b in args.bench]
 
-# Function to read benchmarks times
-def readTimes(filename):
-    with open (filename, 'r') as f:
-        return [float(line.strip()) for line in f if line.strip()]
+# Function to read the benchmark records
+def readRecords(filename):
+    with open(filename, 'r') as f:
+        return [json.loads(line) for line in f if line.strip()]
 
-# Load data
-coo_times = None
-csr_times = None
-parallel_csr_times = None
-coo_avg = None
-csr_avg = None
-parallel_csr_avg = None
-coo_90 = None
-csr_90 = None
-parallel_csr_90 = None
+# latest record of every (bench, kernel): earlier runs stay in the file as history
+records = readRecords(args.results)
+latest = {}
+for rec in records:
+    latest[(rec['bench'], rec['kernel'])] = rec
 
-# Compute statistics
-if args.coo or show_all:
-    coo_times = readTimes("COO_exec_times.txt")
-    coo_avg = np.mean(coo_times)
-    coo_90 = np.percentile(coo_times, 90)
-    print(f"COO average: {coo_avg:.8f} ms")
-    print(f"COO 90th percentile: {coo_90:.8f} ms")
+# Compute statistics and create plot
+for _, bench, label, colours in selected:
+    runs = [rec for (b, _), rec in latest.items() if b == bench]
+    if not runs:
+        print(f"{label}: no records of {bench} in {args.results}")
+        continue
+    for rec in runs:
+        name = label if len(runs) == 1 else f"{label} [{rec['kernel']}]"
+        times = rec['times_ms']
+        p90 = np.percentile(times, 90)
+        print(f"{name} ({rec['matrix']}, {rec['threads']} threads, {rec['git_rev']}):")
+        print(f"  median {rec['median_ms']:.8f} ms +- {rec['ci95_ms']:.8f} (95% CI), "
+              f"{rec['samples']} samples{'' if rec['converged'] else ', not converged'}")
+        print(f"  min {rec['min_ms']:.8f} ms, mean {rec['mean_ms']:.8f} ms, "
+              f"90th percentile {p90:.8f} ms, 99th percentile {rec['p99_ms']:.8f} ms")
 
-if args.csr or show_all:
-    csr_times = readTimes("CSR_exec_times.txt")
-    csr_avg = np.mean(csr_times)
-    csr_90 = np.percentile(csr_times, 90)
-    print(f"CSR average: {csr_avg:.8f} ms")
-    print(f"CSR 90th percentile: {csr_90:.8f} ms")
+        color, median_color, p90_color = colours if len(runs) == 1 else (None, None, None)
+        line, = plt.plot(times, 'o-', color=color, markersize=3, label=f'{name} times')
+        plt.axhline(rec['median_ms'], color=median_color or line.get_color(), linestyle='--',
+                    label=f"{name} median ({rec['median_ms']:.5f} ms)")
+        plt.axhline(p90, color=p90_color or line.get_color(), linestyle='-.',
+                    label=f'{name} 90% ({p90:.5f} ms)')
 
-if args.par_csr or show_all:
-    parallel_csr_times = readTimes("Parallel_CSR_exec_times.txt")
-    parallel_csr_avg = np.mean(parallel_csr_times)
-    parallel_csr_90 = np.percentile(parallel_csr_times, 90)
-    print(f"Parallel CSR average: {parallel_csr_avg:.8f} ms")
-    print(f"Parallel CSR 90th percentile: {parallel_csr_90:.8f} ms")
-
-# Create plot
-if coo_times is not None:
-    plt.plot(coo_times, 'ro-', label='COO times')
-    plt.axhline(coo_avg, color='red', linestyle='--', label=f'COO avg ({coo_avg:.5f} ms)')
-    plt.axhline(coo_90, color='purple', linestyle='-.', label=f'COO 90% ({coo_90:.5f} ms)')
-
-if csr_times is not None:
-    plt.plot(csr_times, 'bo-', label='CSR times')
-    plt.axhline(csr_avg, color='blue', linestyle='--', label=f'CSR avg ({csr_avg:.5f} ms)')
-    plt.axhline(csr_90, color='gold', linestyle='-.', label=f'CSR 90% ({csr_90:.5f} ms)')
-
-if parallel_csr_times is not None:
-    plt.plot(parallel_csr_times, 'go-', label='Parallel CSR times')
-    plt.axhline(parallel_csr_avg, color='green', linestyle='--', label=f'Parallel CSR avg ({parallel_csr_avg:.5f} ms)')
-    plt.axhline(parallel_csr_90, color='yellow', linestyle='-.', label=f'Parallel CSR 90% ({parallel_csr_90:.5f} ms)')
-
-plt.title('Benchmark: COO vs CSR execution times')
+plt.title('Benchmark: execution times of the latest runs')
 plt.xlabel('Run #')
 plt.ylabel('Time (ms)')
 plt.legend()
@@ -76,4 +69,4 @@ plt.savefig('benchmark_plot.png')
 
 # Checks for argument in order to show plot
 if args.show_plot:
-    plt.show()
\ No newline at end of file
+    plt.show()
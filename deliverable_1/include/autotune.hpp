@@ -0,0 +1,189 @@
+#ifndef AUTOTUNE_HPP
+#define AUTOTUNE_HPP
+
+/*
+ * @file autotune.hpp
+ * @brief Runtime format/kernel selection with a persistent tuning cache
+ *
+ * The best storage format depends on the matrix: long regular rows favour
+ * SELL-C-sigma, small dense blocks favour BCSR, very skewed row lengths
+ * favour the nnz-balanced COO and merge-path kernels. The tuner computes a
+ * few cheap structural features to prune hopeless candidates, times short
+ * trial runs of the rest (conversion cost included) and remembers the
+ * winner in a text file keyed by a hash of the sparsity pattern, so the
+ * search only runs the first time a matrix is seen.
+*/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "coo_parallel.hpp"
+#include "merge_path.hpp"
+#include "sell.hpp"
+#include "bcsr.hpp"
+
+enum SpmvFormat {
+    FORMAT_COO = 0,         // row-sorted COO, segmented reduction
+    FORMAT_CSR,             // CSR, guided row schedule
+    FORMAT_CSR_MERGE,       // CSR, merge-path partition
+    FORMAT_SELL,            // SELL-C-sigma
+    FORMAT_BCSR,            // register-blocked CSR
+    FORMAT_COUNT
+};
+
+/**
+ * @brief Short name of a format, as stored in the tuning cache
+*/
+const char* spmv_format_name(SpmvFormat format);
+
+/**
+ * @brief Inverse of spmv_format_name()
+ *
+ * @return false if the name is unknown
+*/
+bool spmv_format_from_name(const std::string& name, SpmvFormat& format);
+
+/**
+ * Structural features, all computed in one pass over the CSR arrays
+ * (plus the sampled BCSR fill estimate).
+*/
+struct MatrixFeatures {
+    int M = 0;
+    int N = 0;
+    long long nnz = 0;
+    double row_mean = 0.0;          // average nonzeros per row
+    double row_var = 0.0;           // variance of the nonzeros per row
+    int row_max = 0;                // longest row
+    int empty_rows = 0;             // rows without nonzeros
+    int bandwidth = 0;              // max |i - j| over the nonzeros
+    int block_r = 1;                // BCSR block shape with the least estimated traffic
+    int block_c = 1;
+    double block_density = 1.0;     // true nonzeros / stored entries with that shape
+};
+
+/**
+ * @brief Computes the structural features of a CSR matrix
+ *
+ * @param M                 number of rows
+ * @param N                 number of columns
+ * @param row_ptr           CSR row pointers
+ * @param col_idx           CSR column indices
+ * @param f                 [out] features
+*/
+void compute_features(int M, int N, const int* row_ptr, const int* col_idx, MatrixFeatures& f);
+
+/**
+ * @brief 64-bit FNV-1a hash of the dimensions and sparsity pattern
+ *
+ * Values are not hashed: they do not change the performance of any kernel.
+*/
+uint64_t matrix_hash(int M, int N, const int* row_ptr, const int* col_idx);
+
+/**
+ * One line of the tuning cache:
+ *   <hash> <key> <threads> <kernel> <param1> <param2> <time_ms>
+ * key tells what was tuned (e.g. "format"), so several tuners share the file.
+*/
+struct TuningEntry {
+    uint64_t hash = 0;
+    std::string key;
+    int threads = 0;
+    std::string kernel;
+    int param1 = 0;
+    int param2 = 0;
+    double time_ms = 0.0;
+};
+
+/**
+ * @brief Looks up (hash, key, threads) in the tuning cache
+ *
+ * @return false if the file does not exist or has no such entry
+*/
+bool tuning_cache_lookup(const std::string& path, uint64_t hash, const std::string& key,
+                         int threads, TuningEntry& entry);
+
+/**
+ * @brief Adds an entry to the tuning cache, replacing the one with the same
+ *        (hash, key, threads)
+ *
+ * @return false if the file cannot be written
+*/
+bool tuning_cache_store(const std::string& path, const TuningEntry& entry);
+
+/**
+ * A matrix converted to one of the formats, ready to be multiplied.
+ * The CSR arrays are borrowed from the caller; everything else is owned.
+*/
+struct SpmvDispatch {
+    SpmvFormat format = FORMAT_CSR;
+    int M = 0;
+    int N = 0;
+    int param1 = 0;                 // SELL: C,  BCSR: r
+    int param2 = 0;                 // SELL: sigma, BCSR: c
+    const int* row_ptr = nullptr;
+    const int* col_idx = nullptr;
+    const double* values = nullptr;
+
+    std::vector<int> row_coo;       // COO rows (columns and values are the CSR arrays)
+    CooPlan coo_plan;
+    MergePathPlan merge_plan;
+    SellMatrix sell;
+    BcsrMatrix bcsr;
+};
+
+/**
+ * @brief Builds the data structures of a format from CSR
+ *
+ * @param d                 [out] dispatcher
+ * @param format            target format
+ * @param param1            SELL chunk height / BCSR block rows (0 = default)
+ * @param param2            SELL sigma / BCSR block columns (0 = default)
+ * @param num_threads       number of threads the kernel will run with
+ * @return conversion time in ms
+*/
+double dispatch_prepare(SpmvDispatch& d, SpmvFormat format, int param1, int param2, int num_threads,
+                        int M, int N, const int* row_ptr, const int* col_idx, const double* values);
+
+/**
+ * @brief y = A * x with the prepared format
+*/
+void dispatch_spmv(SpmvDispatch& d, const double* x, double* y);
+
+/**
+ * @brief Frees the converted data, keeps the borrowed CSR pointers
+*/
+void dispatch_release(SpmvDispatch& d);
+
+/**
+ * Outcome of the trial run of one candidate.
+*/
+struct TrialResult {
+    SpmvFormat format = FORMAT_CSR;
+    int param1 = 0;
+    int param2 = 0;
+    bool skipped = false;           // pruned by the features, never run
+    std::string note;               // reason for skipping
+    double convert_ms = 0.0;        // CSR -> format
+    double spmv_ms = 0.0;           // best trial time
+    double break_even = -1.0;       // iterations to recover convert_ms vs CSR (-1 = never)
+};
+
+/**
+ * @brief Times every candidate format and returns the fastest
+ *
+ * With expected_iters > 0 the winner minimises convert_ms + expected_iters * spmv_ms,
+ * otherwise the conversion is assumed to be amortised and only spmv_ms counts.
+ *
+ * @param f                 features of the matrix (used to prune candidates)
+ * @param num_threads       number of threads
+ * @param trial_iters       timed runs per candidate
+ * @param expected_iters    SpMVs the caller will run (0 = many)
+ * @param trials            [out] one entry per format, indexed by SpmvFormat
+ * @return index of the winner in trials
+*/
+int autotune_search(int M, int N, const int* row_ptr, const int* col_idx, const double* values,
+                    const MatrixFeatures& f, int num_threads, int trial_iters, long long expected_iters,
+                    std::vector<TrialResult>& trials);
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef AXPBY_HPP
+#define AXPBY_HPP
+
+/*
+ * @file axpby.hpp
+ * @brief Fused y = alpha * A * x + beta * y CSR kernels (BLAS-style)
+ *
+ * The initialisation of y is folded into the row loop: with beta = 0 every
+ * y[r] is written exactly once (no zeroing pass, no read of the old value),
+ * otherwise it is read and written once.
+ *
+ * With beta = 0 a normal store still reads the cache line of y before
+ * writing it (read for ownership), so y costs 16 bytes per row of memory
+ * traffic when it does not stay in cache between SpMVs. Non-temporal
+ * (streaming) stores write the line straight to memory: 8 bytes per row.
+ * They are only a win when y is larger than the last-level cache, otherwise
+ * they evict a y the next SpMV would have found in cache; STORES_AUTO checks
+ * that. Short rows gain the most, y being a large share of their traffic.
+*/
+
+#include <cstring>
+#include <string>
+#include <vector>
+#if defined(__SSE2__) && defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "numa_alloc.hpp"
+
+// rows per guided chunk
+#define AXPBY_BLOCK_SIZE 10
+
+enum StorePolicy {
+    STORES_AUTO = 0,        // streaming when beta = 0 and y does not fit in the LLC
+    STORES_REGULAR,
+    STORES_STREAMING        // streaming whenever beta = 0
+};
+
+/**
+ * @brief Parses "auto", "regular" or "streaming"
+*/
+bool store_policy_from_name(const std::string& name, StorePolicy& policy);
+
+/**
+ * @brief Name of a policy, inverse of store_policy_from_name()
+*/
+const char* store_policy_name(StorePolicy policy);
+
+/**
+ * @brief Whether a y of M doubles is written with streaming stores (when beta = 0)
+*/
+bool axpby_streaming(StorePolicy policy, int M);
+
+// how a row result is stored (shared with the hand-vectorised kernels)
+enum AxpbyMode {
+    AXPBY_OVERWRITE,        // y = alpha * Ax
+    AXPBY_STREAM,           // y = alpha * Ax, non-temporal store
+    AXPBY_UPDATE            // y = alpha * Ax + beta * y
+};
+
+template <int MODE>
+inline void axpby_store_row(double* y, int r, double alpha, double sum, double beta) {
+    if (MODE == AXPBY_UPDATE) {
+        y[r] = alpha * sum + beta * y[r];
+    } else if (MODE == AXPBY_STREAM) {
+#if defined(__SSE2__) && defined(__x86_64__)
+        const double v = alpha * sum;
+        long long bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        _mm_stream_si64(reinterpret_cast<long long*>(y + r), bits);
+#else
+        y[r] = alpha * sum;
+#endif
+    } else {
+        y[r] = alpha * sum;
+    }
+}
+
+// streaming stores are weakly ordered: make them visible before the barrier
+inline void axpby_store_fence() {
+#if defined(__SSE2__) && defined(__x86_64__)
+    _mm_sfence();
+#endif
+}
+
+/**
+ * @brief y = alpha * A * x + beta * y, rows in guided chunks
+ *
+ * @param streaming     non-temporal stores for y (only used when beta = 0)
+*/
+void spmv_csr_axpby(int M, const int* row_ptr, const int* col_idx, const double* values,
+                    double alpha, const double* x, double beta, double* y, bool streaming);
+
+/**
+ * @brief y = alpha * A * x + beta * y on a first-touch placed matrix, thread p
+ *        computes the rows of part p (same partition as the placement); a
+ *        smaller team than A.num_parts still covers every part
+ *
+ * @param thread_ms     [out] optional, time spent on the rows of every part
+*/
+void spmv_csr_numa_axpby(const NumaCsr& A, double alpha, const double* x, double beta, double* y,
+                         bool streaming, std::vector<double>* thread_ms = nullptr);
+
+/**
+ * @brief y = alpha * t + beta * y (for kernels without a fused update)
+*/
+void axpby_update(int M, double alpha, const double* t, double beta, double* y);
+
+#endif
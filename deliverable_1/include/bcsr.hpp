@@ -0,0 +1,92 @@
+#ifndef BCSR_HPP
+#define BCSR_HPP
+
+/*
+ * @file bcsr.hpp
+ * @brief Register-blocked CSR (BCSR) format with unrolled r x c kernels and
+ *        fill-ratio based block size selection
+ *
+ * The matrix is tiled in aligned r x c blocks; every block that contains at
+ * least one nonzero is stored densely (explicit zeros fill the holes) with a
+ * single column index. For matrices made of small dense blocks (several
+ * degrees of freedom per node) this removes most of the col_idx traffic and
+ * lets the kernel keep r partial sums and c entries of x in registers.
+*/
+
+#include <vector>
+
+#define BCSR_MAX_BLOCK 8
+
+struct BcsrMatrix {
+    int M = 0;                      // number of rows
+    int N = 0;                      // number of columns
+    int r = 1;                      // block rows
+    int c = 1;                      // block columns
+    int mb = 0;                     // number of block rows = ceil(M / r)
+    long long nnz = 0;              // real nonzeros (without explicit zeros)
+
+    std::vector<int> brow_ptr;      // block row pointers (size = mb+1)
+    std::vector<int> bcol_idx;      // first column of each block (scalar index)
+    std::vector<double> values;     // r*c values per block, row-major
+};
+
+/**
+ * @brief Estimates the fill ratio of every r x c block shape up to 8 x 8
+ *
+ * fill(r,c) = (stored entries with r x c blocks) / (true nonzeros).
+ * Like OSKI, only a fraction of the block rows is scanned, so the estimate
+ * costs a few percent of one conversion.
+ *
+ * @param M                 number of rows
+ * @param N                 number of columns
+ * @param row_ptr           CSR row pointers
+ * @param col_idx           CSR column indices
+ * @param sample_fraction   fraction of block rows to scan (1.0 = exact)
+ * @param fill              [out] fill[(r-1)*8 + (c-1)] for r,c in 1..8
+*/
+void bcsr_estimate_fill(int M, int N, const int* row_ptr, const int* col_idx,
+                        double sample_fraction, std::vector<double>& fill);
+
+/**
+ * @brief Model of the bytes moved per true nonzero by an r x c BCSR SpMV
+ *
+ * fill * (8 bytes of value + 4 bytes of index shared by the r*c entries),
+ * plus the block row pointer amortised over the block row.
+*/
+double bcsr_bytes_per_nnz(int r, int c, double fill, double nnz_per_row);
+
+/**
+ * @brief Picks the block shape with the smallest estimated traffic
+ *
+ * @param fill              fill table from bcsr_estimate_fill()
+ * @param nnz_per_row       average nonzeros per row
+ * @param r                 [out] selected block rows
+ * @param c                 [out] selected block columns
+*/
+void bcsr_select_block(const std::vector<double>& fill, double nnz_per_row, int& r, int& c);
+
+/**
+ * @brief Converts CSR to BCSR with r x c blocks (1 <= r, c <= 8)
+ *
+ * Block columns are sorted inside each block row. The last block column is
+ * shifted left to start at N - c so the kernel never reads past the end of x
+ * (this needs N >= c); the last block row is guarded in the kernel.
+*/
+void csr_to_bcsr(int M, int N, const int* row_ptr, const int* col_idx,
+                 const double* values, int r, int c, BcsrMatrix& A);
+
+/**
+ * @brief y = A * x with A in BCSR format (OpenMP over block rows)
+ *
+ * Dispatches to a kernel unrolled at compile time for the r x c shape.
+*/
+void spmv_bcsr(const BcsrMatrix& A, const double* x, double* y);
+
+/**
+ * @brief Number of stored blocks
+*/
+inline long long bcsr_num_blocks(const BcsrMatrix& A) {
+    return A.brow_ptr.empty() ? 0 : A.brow_ptr.back();
+}
+
+#endif
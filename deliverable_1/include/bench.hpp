@@ -0,0 +1,121 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+/*
+ * @file bench.hpp
+ * @brief Shared benchmark harness: adaptive warm-up, confidence-interval
+ *        stopping, summary statistics and structured result records
+ *
+ * Warm-up runs the kernel until the last BENCH_WARMUP_WINDOW times agree
+ * within BENCH_WARMUP_TOL (page faults, frequency ramp-up and cold caches
+ * are over), between BENCH_MIN_WARMUP and BENCH_MAX_WARMUP iterations.
+ * Sampling then runs at least BENCH_MIN_SAMPLES timed iterations and
+ * stops as soon as the 95% confidence interval of the median (order
+ * statistics, no distribution assumed) is within BENCH_CI_TARGET of the
+ * median, or when BENCH_MAX_SAMPLES / BENCH_MAX_SECONDS is reached
+ * (reported as not converged).
+ *
+ * Every measurement is appended to a CSV file (one summary row) and to a
+ * JSON Lines file (summary and every sample), tagged with the benchmark,
+ * matrix, kernel, thread count, host and git revision.
+ *
+ * The limits can be changed without recompiling through the environment:
+ *   SPMV_BENCH_CI           relative CI half-width target (e.g. 0.01)
+ *   SPMV_BENCH_MIN_SAMPLES  / SPMV_BENCH_MAX_SAMPLES
+ *   SPMV_BENCH_MAX_TIME     seconds of sampling per measurement
+ *   SPMV_BENCH_CSV / SPMV_BENCH_JSON   output files ("" disables)
+ *   SPMV_GIT_REV            revision tag (default: git describe of the cwd)
+*/
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#define BENCH_MIN_WARMUP 2
+#define BENCH_MAX_WARMUP 50
+#define BENCH_WARMUP_WINDOW 3
+#define BENCH_WARMUP_TOL 0.05
+#define BENCH_MIN_SAMPLES 10
+#define BENCH_MAX_SAMPLES 500
+#define BENCH_CI_TARGET 0.02
+#define BENCH_MAX_SECONDS 10.0
+#define BENCH_DEFAULT_CSV "../benchmarks/results.csv"
+#define BENCH_DEFAULT_JSON "../benchmarks/results.jsonl"
+
+struct BenchConfig {
+    int min_warmup = BENCH_MIN_WARMUP;
+    int max_warmup = BENCH_MAX_WARMUP;
+    int warmup_window = BENCH_WARMUP_WINDOW;
+    double warmup_tol = BENCH_WARMUP_TOL;
+    int min_samples = BENCH_MIN_SAMPLES;
+    int max_samples = BENCH_MAX_SAMPLES;
+    double ci_target = BENCH_CI_TARGET;
+    double max_seconds = BENCH_MAX_SECONDS;
+    std::string csv_path = BENCH_DEFAULT_CSV;
+    std::string json_path = BENCH_DEFAULT_JSON;
+    bool verbose = false;           // print every sample ("Multiplication took ...")
+};
+
+struct BenchStats {
+    int warmup_iters = 0;
+    int samples = 0;
+    bool converged = false;         // CI target reached before the limits
+    double min_ms = 0.0;
+    double median_ms = 0.0;
+    double mean_ms = 0.0;
+    double p90_ms = 0.0;
+    double p99_ms = 0.0;
+    double stddev_ms = 0.0;
+    double ci_ms = 0.0;             // half-width of the 95% CI of the median
+    std::vector<double> times_ms;   // in run order
+};
+
+/**
+ * @brief Default configuration with the SPMV_BENCH_* environment overrides
+*/
+BenchConfig bench_config_from_env(bool verbose);
+
+/**
+ * @brief Runs fn until its time is stable
+ *
+ * @param setup         run untimed before every fn (e.g. resetting y), optional
+ * @return number of warm-up iterations
+*/
+int bench_warmup(const BenchConfig& cfg, const std::function<void()>& fn,
+                 const std::function<void()>& setup = nullptr);
+
+/**
+ * @brief Times fn until the CI of the median is tight (or a limit is hit)
+ *
+ * @param setup         run untimed before every fn, optional
+ * @param stats         [out] samples and statistics (warmup_iters is kept)
+*/
+void bench_sample(const BenchConfig& cfg, const std::function<void()>& fn, BenchStats& stats,
+                  const std::function<void()>& setup = nullptr);
+
+/**
+ * @brief Recomputes the statistics of stats.times_ms
+*/
+void bench_compute_stats(BenchStats& stats);
+
+/**
+ * @brief Appends one record to the CSV and JSON Lines files of the configuration
+ *
+ * @param bench         binary / experiment name (e.g. "parallel_spmv_csr")
+ * @param kernel        kernel and its settings (e.g. "csr/avx2")
+ * @return false (warning on stderr) if a file cannot be written
+*/
+bool bench_record(const BenchConfig& cfg, const std::string& bench, const std::string& matrix,
+                  const std::string& kernel, int threads, const BenchStats& stats);
+
+/**
+ * @brief Host name used to tag the records ("unknown" if not available)
+*/
+std::string bench_host_name();
+
+/**
+ * @brief One-line summary: "median 1.234 ms (min 1.2, p90 ..., +-0.5%, 37 samples)"
+*/
+std::string bench_summary(const BenchStats& stats);
+
+#endif
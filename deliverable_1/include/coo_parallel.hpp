@@ -0,0 +1,65 @@
+#ifndef COO_PARALLEL_HPP
+#define COO_PARALLEL_HPP
+
+/*
+ * @file coo_parallel.hpp
+ * @brief Multithreaded COO SpMV with segmented reduction
+ *
+ * The COO entries are sorted by row once, then split in chunks with the
+ * same number of nonzeros (one per thread). Inside a chunk the products
+ * val[k] * x[col[k]] are computed with SIMD and summed per row segment,
+ * so no two threads ever write the same y entry during the parallel part:
+ * rows that start or end at a chunk boundary are returned as carries and
+ * added in a short serial fix-up.
+*/
+
+#include <vector>
+
+/**
+ * Chunk boundaries and carry buffers, built once and reused in every SpMV.
+*/
+struct CooPlan {
+    int num_parts = 0;
+    std::vector<int> nz_start;      // first entry of each chunk (size = num_parts+1)
+    std::vector<int> first_row;     // row of the first entry of each chunk (-1 if empty)
+    std::vector<int> last_row;      // row of the last entry of each chunk (-1 if empty)
+    std::vector<int> zero_end;      // rows (last_row, zero_end) have no entries: zeroed by the chunk
+    std::vector<double> carry_first;    // partial sum of first_row
+    std::vector<double> carry_last;     // partial sum of last_row (if different from first_row)
+};
+
+/**
+ * @brief Sorts COO entries by row (stable counting sort, O(nz + M))
+ *
+ * Entries of the same row keep their relative order.
+*/
+void coo_sort_by_row(int M, int nz, std::vector<int>& row_coo, std::vector<int>& col_coo,
+                     std::vector<double>& val_coo);
+
+/**
+ * @brief Splits a row-sorted COO matrix in num_parts nnz-balanced chunks
+ *
+ * @param M             number of rows
+ * @param nz            number of entries
+ * @param row_coo       row indices, sorted
+ * @param num_parts     number of chunks (usually the number of threads)
+ * @param plan          [out] chunk boundaries and carry buffers
+*/
+void coo_partition(int M, int nz, const int* row_coo, int num_parts, CooPlan& plan);
+
+/**
+ * @brief y = A * x with A in row-sorted COO format
+ *
+ * @param plan          plan built by coo_partition()
+ * @param M             number of rows
+ * @param row_coo       row indices, sorted
+ * @param col_coo       column indices
+ * @param val_coo       values
+ * @param x             input vector
+ * @param y             [out] result vector (size = M)
+*/
+void spmv_coo_parallel(CooPlan& plan, int M,
+                       const int* row_coo, const int* col_coo, const double* val_coo,
+                       const double* x, double* y);
+
+#endif
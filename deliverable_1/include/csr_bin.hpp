@@ -0,0 +1,132 @@
+#ifndef CSR_BIN_HPP
+#define CSR_BIN_HPP
+
+/*
+ * @file csr_bin.hpp
+ * @brief Versioned binary CSR container (.csrb) with zero-copy mmap loading
+ *
+ * Layout (little endian, every section starts on a 64-byte boundary):
+ *
+ *   [ CsrBinHeader, 128 bytes ][ row_ptr (M+1) ][ col_idx (nnz) ][ values (nnz) ]
+ *
+ * The matrix is stored in full (symmetric files are expanded by the
+ * converter, symmetry only records what the source file declared), rows in
+ * the order of the .mtx reader. Loading maps the file read-only and points
+ * row_ptr / col_idx / values straight into the mapping: no parse, no copy,
+ * pages are faulted in by the first SpMV.
+ *
+ * The checksum is a word-wise FNV-1a over everything after the header; it is
+ * only recomputed when verification is requested (it reads the whole file).
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "matrix_io.hpp"
+
+#define CSRBIN_MAGIC "SPMVCSR"
+#define CSRBIN_VERSION 1
+#define CSRBIN_ALIGN 64
+
+enum CsrBinSymmetry {
+    CSRBIN_GENERAL = 0,
+    CSRBIN_SYMMETRIC,
+    CSRBIN_SKEW_SYMMETRIC
+};
+
+struct CsrBinHeader {
+    char magic[8];              // CSRBIN_MAGIC, '\0' terminated
+    uint32_t version;           // CSRBIN_VERSION
+    uint32_t index_width;       // bytes per row_ptr / col_idx entry (4)
+    uint32_t value_width;       // bytes per value (8)
+    uint32_t symmetry;          // CsrBinSymmetry of the source file
+    int64_t M;
+    int64_t N;
+    int64_t nnz;
+    uint64_t row_ptr_offset;    // byte offsets from the start of the file
+    uint64_t col_idx_offset;
+    uint64_t values_offset;
+    uint64_t file_size;
+    uint64_t checksum;
+    // structural stats, computed once by the writer
+    int32_t row_min;            // fewest / most nonzeros in a row
+    int32_t row_max;
+    int64_t empty_rows;
+    int64_t bandwidth;          // max |i - j|
+    int64_t diagonal;           // stored entries with i == j
+    uint8_t reserved[8];
+};
+
+/**
+ * CSR matrix that is either mapped from a .csrb file (row_ptr / col_idx /
+ * values point into the mapping) or owned (read from a .mtx file into the
+ * *_store vectors). Not copyable; the mapping is released by the destructor.
+*/
+struct LoadedCsr {
+    int M = 0;
+    int N = 0;
+    int nnz = 0;
+    const int* row_ptr = nullptr;
+    const int* col_idx = nullptr;
+    const double* values = nullptr;
+
+    bool mapped = false;
+    CsrBinHeader header;            // valid if mapped
+    void* map_base = nullptr;
+    size_t map_size = 0;
+
+    std::vector<int> row_ptr_store;
+    std::vector<int> col_idx_store;
+    std::vector<double> values_store;
+
+    LoadedCsr() {}
+    ~LoadedCsr();
+    LoadedCsr(const LoadedCsr&) = delete;
+    LoadedCsr& operator=(const LoadedCsr&) = delete;
+};
+
+/**
+ * @brief True if the file starts with the .csrb magic
+*/
+bool csr_bin_is_file(const std::string& filename);
+
+/**
+ * @brief Writes a CSR matrix to a .csrb file (header stats and checksum included)
+ *
+ * @param symmetry      symmetry declared by the source file (informational)
+ * @param header        [out] optional, the header that was written
+ * @return false (message on stderr) if the file cannot be written
+*/
+bool csr_bin_write(const std::string& filename, int M, int N, const int* row_ptr,
+                   const int* col_idx, const double* values, CsrBinSymmetry symmetry,
+                   CsrBinHeader* header = nullptr);
+
+/**
+ * @brief Maps a .csrb file read-only and points A into it
+ *
+ * The header is validated (magic, version, widths, section bounds,
+ * row_ptr[0] = 0 and row_ptr[M] = nnz), then the arrays in one parallel
+ * pass: row_ptr non-decreasing, columns in [0, N) and sorted inside every
+ * row. With verify the checksum is recomputed as well. A is only modified
+ * when every check passes.
+ *
+ * @return false (message on stderr) if the file is not a valid container
+*/
+bool csr_bin_map(const std::string& filename, LoadedCsr& A, bool verify = false);
+
+/**
+ * @brief Checksum of the sections of a mapped file (as stored in the header)
+*/
+uint64_t csr_bin_checksum(const LoadedCsr& A);
+
+/**
+ * @brief Loads a matrix from a .csrb (mapped) or a .mtx file (parsed)
+ *
+ * The format is chosen by the magic, not by the extension. load_stats
+ * reports the mapping time for binary files (parse_ms = 0).
+*/
+bool load_csr(const std::string& filename, LoadedCsr& A, MtxLoadStats* load_stats = nullptr);
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef CSR_CONVERT_HPP
+#define CSR_CONVERT_HPP
+
+/*
+ * @file csr_convert.hpp
+ * @brief Parallel COO -> CSR conversion
+ *
+ * The entries are split in one contiguous block per thread:
+ *   1. every thread counts the rows of its block in a private histogram
+ *   2. the row counts are summed and exclusive-scanned in parallel into
+ *      row_ptr; the histograms are turned into per-thread write offsets
+ *      (thread t writes row r after threads 0..t-1)
+ *   3. every thread scatters its block through its own offsets, so entries
+ *      of a row keep their input order (stable) without atomics
+ *   4. the columns of every row are sorted (stable) and duplicate (i, j)
+ *      entries are summed, in input order
+ *
+ * The histograms take threads * M ints; the number of threads used for the
+ * count and the scatter is capped so they stay below CSR_CONVERT_HIST_RATIO
+ * times the COO index arrays (the sort and merge always use every thread).
+*/
+
+#include <vector>
+
+// histograms may take up to this fraction of the 2 * nz COO index ints
+#define CSR_CONVERT_HIST_RATIO 1
+// rows up to this length are sorted by insertion sort
+#define CSR_CONVERT_INSERTION_SORT 32
+
+/**
+ * @brief Converts COO arrays (any order, 0-based) to CSR with sorted columns
+ *        and merged duplicates
+ *
+ * @param M             number of rows
+ * @param nz            number of COO entries
+ * @param row_coo       COO row indices
+ * @param col_coo       COO column indices
+ * @param val_coo       COO values
+ * @param row_ptr       [out] CSR row pointers (size = M+1)
+ * @param col_idx       [out] CSR column indices, increasing inside every row
+ * @param values        [out] CSR values (duplicates summed)
+ * @return number of CSR entries (= row_ptr[M], nz minus the merged duplicates)
+*/
+int coo_to_csr_parallel(int M, int nz, const int* row_coo, const int* col_coo, const double* val_coo,
+                        std::vector<int>& row_ptr, std::vector<int>& col_idx,
+                        std::vector<double>& values);
+
+/**
+ * @brief Sorts the columns of every row (stable) and sums duplicate columns
+ *        in place; row_ptr and the arrays are compacted if entries were merged
+ *
+ * @return number of entries after merging (= row_ptr[M])
+*/
+int csr_sort_and_merge(int M, std::vector<int>& row_ptr, std::vector<int>& col_idx,
+                       std::vector<double>& values);
+
+/**
+ * @brief Parallel exclusive prefix sum: out[0] = 0, out[i+1] = out[i] + in[i]
+ *
+ * @param n             number of input elements
+ * @param in            input (size = n)
+ * @param out           [out] prefix sums (size = n+1, must not overlap in)
+*/
+void exclusive_scan_parallel(int n, const int* in, int* out);
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef CSR_DU_HPP
+#define CSR_DU_HPP
+
+/*
+ * @file csr_du.hpp
+ * @brief CSR with delta-compressed column indices (CSR-DU style)
+ *
+ * After the values, col_idx (4 bytes per nonzero) is the largest stream of
+ * a CSR SpMV. Here the columns of every row are stored in a byte stream of
+ * units. A unit has a one byte header (length, offset width), its base
+ * column as a variable-length delta from the previous column of the row
+ * (from the row index for the first unit), and for each entry the offset
+ * col - base in 8 or 16 bits, whichever fits. Offsets are taken from the
+ * unit base and not from the previous entry, so decoding needs no prefix
+ * sum: the kernel loads a vector of offsets, widens them and gathers from
+ * x + base. Banded matrices (FEM, bcsstk*) get mostly 8-bit units.
+*/
+
+#include <cstdint>
+#include <vector>
+
+// entries per unit (length - 1 is stored in the low 7 bits of the header)
+#define CSRDU_MAX_UNIT 128
+// an 8-bit unit is opened when at least this many entries fit it,
+// shorter 8-bit runs are absorbed by a 16-bit unit
+#define CSRDU_MIN_UNIT8 4
+
+struct CsrduMatrix {
+    int M = 0;                          // number of rows
+    int N = 0;                          // number of columns
+    long long nnz = 0;
+    long long num_units = 0;
+    long long units8 = 0;               // units with 8-bit offsets
+
+    std::vector<int> row_ptr;           // first nonzero of each row (size = M+1)
+    std::vector<int> row_off;           // first byte of each row in ctl (size = M+1, always even)
+    std::vector<uint8_t> ctl;           // unit headers, bases and offsets (16-bit offsets 2-byte aligned)
+    std::vector<double> values;
+};
+
+/**
+ * @brief Converts CSR (sorted column indices) to CSR-DU
+ *
+ * @param M             number of rows
+ * @param N             number of columns
+ * @param row_ptr       CSR row pointers
+ * @param col_idx       CSR column indices, sorted inside each row
+ * @param values        CSR values
+ * @param A             [out] compressed matrix
+ * @return false (message on stderr) if a row is not sorted or a column is
+ *         outside [0, N): the offsets from the unit base must be non-negative
+*/
+bool csr_to_csrdu(int M, int N, const int* row_ptr, const int* col_idx, const double* values,
+                  CsrduMatrix& A);
+
+/**
+ * @brief y = A * x, OpenMP over rows, SIMD decode of the offsets
+*/
+void spmv_csrdu(const CsrduMatrix& A, const double* x, double* y);
+
+/**
+ * @brief Bytes of index data read by one SpMV (row_ptr + row_off + ctl)
+*/
+inline long long csrdu_index_bytes(const CsrduMatrix& A) {
+    return 8LL * (A.M + 1) + static_cast<long long>(A.ctl.size());
+}
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef CSR_SIMD_HPP
+#define CSR_SIMD_HPP
+
+/*
+ * @file csr_simd.hpp
+ * @brief Hand-vectorised CSR kernels (AVX2 / AVX-512 gathers) with runtime
+ *        CPU dispatch
+ *
+ * Every kernel is compiled for its own instruction set through
+ * __attribute__((target)), independently of -march, and the one to run is
+ * picked from cpuid at startup. A binary built for a generic x86-64 target
+ * (make PORTABLE=1) therefore still runs full-width gathers on the nodes
+ * that have them and the scalar kernel on the others.
+ *
+ * Inside a row, the nonzeros are processed one vector at a time (4 doubles
+ * with AVX2, 8 with AVX-512): contiguous loads of values and column indices,
+ * a gather of x, an FMA into a vector accumulator. The last partial vector
+ * of the row uses masked loads and a masked gather (no scalar tail loop, no
+ * read past the end of the arrays), and the accumulator is reduced once per
+ * row. The row loop, the guided schedule and the y update are the ones of
+ * the fused alpha/beta kernel (axpby.hpp).
+*/
+
+#include <string>
+
+// SIMD_AUTO: mean nonzeros per row from which the gather kernels pay off
+// (shorter rows are dominated by the masked remainder and the reduction)
+#define SIMD_AVX2_MIN_ROW 8
+#define SIMD_AVX512_MIN_ROW 32
+
+enum SimdIsa {
+    SIMD_AUTO = 0,          // best kernel the CPU supports
+    SIMD_COMPILER,          // compiler-vectorised loop (spmv_csr_axpby, follows -march)
+    SIMD_SCALAR,            // plain scalar loop, never vectorised (reference, only when selected)
+    SIMD_AVX2,              // 4-wide gathers + FMA
+    SIMD_AVX512             // 8-wide gathers + FMA, masked remainders
+};
+
+/**
+ * @brief Parses "auto", "compiler", "scalar", "avx2" or "avx512"
+*/
+bool simd_isa_from_name(const std::string& name, SimdIsa& isa);
+
+/**
+ * @brief Name of an ISA, inverse of simd_isa_from_name()
+*/
+const char* simd_isa_name(SimdIsa isa);
+
+/**
+ * @brief Best hand-vectorised kernel of this CPU (cpuid, checked once),
+ *        SIMD_COMPILER when it has neither AVX2 nor AVX-512
+*/
+SimdIsa simd_detect();
+
+/**
+ * @brief Whether the CPU can run the kernel of an ISA
+*/
+bool simd_supported(SimdIsa isa);
+
+/**
+ * @brief Kernel that will actually run for a matrix
+ *
+ * SIMD_AUTO picks the widest kernel whose vector the mean row fills
+ * (SIMD_AVX2_MIN_ROW, SIMD_AVX512_MIN_ROW), within what the CPU supports,
+ * and the compiler-vectorised loop below the thresholds; an explicit ISA
+ * the CPU lacks falls back to simd_detect().
+*/
+SimdIsa simd_resolve(SimdIsa isa, int M, long long nnz);
+
+/**
+ * @brief y = alpha * A * x + beta * y with the kernel of one ISA
+ *
+ * @param isa           resolved ISA (SIMD_COMPILER runs spmv_csr_axpby())
+ * @param streaming     non-temporal stores for y (only used when beta = 0)
+*/
+void spmv_csr_simd(SimdIsa isa, int M, const int* row_ptr, const int* col_idx, const double* values,
+                   double alpha, const double* x, double beta, double* y, bool streaming);
+
+#endif
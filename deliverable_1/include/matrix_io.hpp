@@ -0,0 +1,118 @@
+#ifndef MATRIX_IO_HPP
+#define MATRIX_IO_HPP
+
+/*
+ * @file matrix_io.hpp
+ * @brief Shared Matrix Market reader and COO -> CSR conversion used by the
+ *        SpMV benchmark binaries
+ *
+ * The banner and the size line are read with mmio.c; the entries are parsed
+ * from a read-only mapping of the file: the data section is split at line
+ * boundaries into one chunk per OpenMP thread, every thread counts its
+ * entries, an exclusive scan gives the first entry of every chunk and the
+ * chunks are then parsed in parallel straight into the COO arrays.
+*/
+
+#include <cstddef>
+#include <vector>
+#include <string>
+
+// files smaller than this per thread are parsed by fewer threads
+#define MTX_MIN_CHUNK_BYTES (1 << 20)
+
+/**
+ * Timing of the last read: parse throughput = data_bytes / parse_ms.
+*/
+struct MtxLoadStats {
+    size_t data_bytes = 0;      // bytes of the entry section (after the size line)
+    int threads = 0;            // threads that parsed the entries
+    double parse_ms = 0.0;      // count + parse of the entries
+    double convert_ms = 0.0;    // COO -> CSR (read_matrix_market only)
+    double total_ms = 0.0;      // whole read, banner to (expanded) COO arrays
+
+    double parse_mb_per_s() const {
+        return parse_ms > 0.0 ? data_bytes / (parse_ms / 1000.0) / 1e6 : 0.0;
+    }
+};
+
+/**
+ * @brief Reads a Matrix Market file (.mtx) into COO arrays
+ *
+ * The file is expected to contain a sparse real or integer matrix in
+ * coordinate format (i j value), or a pattern matrix (i j, values set to 1).
+ * Input indices are 1-based → converted to 0-based.
+ *
+ * Symmetric and skew-symmetric files store only one triangle:
+ *   - symmetric == nullptr: the missing triangle is generated, so the
+ *     arrays always describe the full matrix (nz is updated)
+ *   - symmetric != nullptr: *symmetric tells whether the file is symmetric;
+ *     if so only the lower triangle is returned (entries stored above the
+ *     diagonal are mirrored below it). Skew-symmetric files are always
+ *     expanded and reported as not symmetric.
+ *
+ * On failure an error message is printed to stderr and false is returned.
+ *
+ * @param filename      Path to the .mtx file
+ * @param M             [out] number of rows
+ * @param N             [out] number of columns
+ * @param nz            [out] number of stored entries
+ * @param row_coo       [out] row indices    (size = nz)
+ * @param col_coo       [out] column indices (size = nz)
+ * @param val_coo       [out] values         (size = nz)
+ * @param symmetric     [out] optional, see above
+ * @param load_stats    [out] optional, parse time and throughput
+ * @return              true if the matrix was read successfully
+*/
+bool read_matrix_market_coo(const std::string& filename, int& M, int& N, int& nz,
+                            std::vector<int>& row_coo, std::vector<int>& col_coo,
+                            std::vector<double>& val_coo, bool* symmetric = nullptr,
+                            MtxLoadStats* load_stats = nullptr);
+
+/**
+ * @brief Adds the mirrored entry (j, i) of every off-diagonal entry (i, j)
+ *
+ * @param sign          +1 for symmetric, -1 for skew-symmetric matrices
+ * @param nz            [in/out] number of entries
+*/
+void expand_symmetric_coo(int& nz, std::vector<int>& row_coo, std::vector<int>& col_coo,
+                          std::vector<double>& val_coo, double sign = 1.0);
+
+/**
+ * @brief Converts COO arrays to CSR (parallel counting sort by row, see
+ *        coo_to_csr_parallel())
+ *
+ * Columns are sorted inside each row and duplicate entries are summed, so
+ * the CSR arrays hold row_ptr[M] <= nz entries.
+ *
+ * @param M             number of rows
+ * @param nz            number of entries
+ * @param row_coo       COO row indices
+ * @param col_coo       COO column indices
+ * @param val_coo       COO values
+ * @param row_ptr       [out] CSR row pointers (size = M+1)
+ * @param col_idx       [out] CSR column indices (size = nz)
+ * @param values        [out] CSR nonzero values (size = nz)
+ * @return number of CSR entries (= row_ptr[M], nz minus the merged duplicates)
+*/
+int coo_to_csr(int M, int nz,
+               const std::vector<int>& row_coo, const std::vector<int>& col_coo,
+               const std::vector<double>& val_coo,
+               std::vector<int>& row_ptr, std::vector<int>& col_idx,
+               std::vector<double>& values);
+
+/**
+ * @brief Reads a Matrix Market file (.mtx) and converts it to CSR format
+ *
+ * Convenience wrapper around read_matrix_market_coo() + coo_to_csr().
+ * The symmetric and load_stats parameters have the same meaning as in
+ * read_matrix_market_coo() (total_ms includes the conversion). nz is the
+ * number of CSR entries, after merging duplicates.
+ *
+ * @return              true if the matrix was read successfully
+*/
+bool read_matrix_market(const std::string& filename, int& M, int& N, int& nz,
+                        std::vector<int>& row_ptr, std::vector<int>& col_idx,
+                        std::vector<double>& values, bool* symmetric = nullptr,
+                        MtxLoadStats* load_stats = nullptr);
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef MERGE_PATH_HPP
+#define MERGE_PATH_HPP
+
+/*
+ * @file merge_path.hpp
+ * @brief Merge-path (nnz-balanced) work partitioning for the parallel CSR kernel
+ *
+ * The CSR product is seen as a merge of two sorted lists: the row end
+ * offsets (row_ptr[1..M]) and the nonzero indices (0..nnz-1). The merge
+ * path has M + nnz steps and every thread gets the same number of steps,
+ * so the work is balanced both in rows and in nonzeros. A thread may stop
+ * in the middle of a row: the partial sum of that row is stored as a
+ * carry-out and added to y after all threads are done.
+ *
+ * The search and the carry fix-up only pay off when there is load
+ * imbalance to remove: with one thread, or fewer than MERGE_PATH_MIN_NNZ
+ * nonzeros, the plan has a single part and the kernel runs the plain CSR
+ * row loop.
+*/
+
+#include <vector>
+
+// below this many nonzeros the merge path is not used (plain CSR loop)
+#define MERGE_PATH_MIN_NNZ (1 << 15)
+
+/**
+ * Partition of the merge path, built once and reused in every SpMV.
+ * Also owns the carry-out buffers so the kernel does not allocate.
+*/
+struct MergePathPlan {
+    int num_parts = 0;
+    std::vector<int> row_start;     // first row of each part (size = num_parts+1)
+    std::vector<int> nz_start;      // first nonzero of each part (size = num_parts+1)
+    std::vector<int> carry_row;     // row left unfinished by each part
+    std::vector<double> carry_val;  // partial sum of that row
+};
+
+/**
+ * @brief Splits the merge path of a CSR matrix in num_parts equal pieces
+ *
+ * Each part gets ceil((M + nnz) / num_parts) merge steps; the start
+ * coordinate of every part is found with a binary search on its diagonal.
+ * A single part is used when num_parts is 1 or nnz < MERGE_PATH_MIN_NNZ.
+ *
+ * @param M             number of rows
+ * @param row_ptr       CSR row pointers (size = M+1)
+ * @param num_parts     number of parts (usually the number of threads)
+ * @param plan          [out] partition and carry-out buffers
+*/
+void merge_path_partition(int M, const int* row_ptr, int num_parts, MergePathPlan& plan);
+
+/**
+ * @brief y = A * x using a merge-path partition
+ *
+ * Every part computes its full rows directly into y and the partial sum of
+ * the row it ends in into its carry-out slot; the carries are then added
+ * serially (one per part). A single-part plan runs the plain CSR loop
+ * (guided rows, parallel when more than one thread is available).
+ *
+ * @param plan          partition built by merge_path_partition()
+ * @param M             number of rows
+ * @param row_ptr       CSR row pointers
+ * @param col_idx       CSR column indices
+ * @param values        CSR values
+ * @param x             input vector
+ * @param y             [out] result vector (size = M)
+*/
+void spmv_csr_merge(MergePathPlan& plan, int M,
+                    const int* row_ptr, const int* col_idx, const double* values,
+                    const double* x, double* y);
+
+#endif
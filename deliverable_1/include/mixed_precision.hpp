@@ -0,0 +1,191 @@
+#ifndef MIXED_PRECISION_HPP
+#define MIXED_PRECISION_HPP
+
+/*
+ * @file mixed_precision.hpp
+ * @brief CSR SpMV with reduced-precision matrix values and double accumulation
+ *
+ * SpMV is bandwidth bound and the values are 2/3 of the matrix stream
+ * (8 of the 12 bytes per nonzero). Storing them as float (4 bytes) or as a
+ * 16-bit type (bfloat16 / IEEE half, 2 bytes) cuts the traffic to 8 or 6
+ * bytes per nonzero. Each value is widened before the multiply and every
+ * row is accumulated in double, so only the rounding of the stored values
+ * shows up in y; x and y stay in double.
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+/**
+ * bfloat16: the upper 16 bits of an IEEE float (8-bit exponent, 7-bit mantissa).
+ * Same range as float, about 3 significant decimal digits.
+*/
+struct bf16_t {
+    uint16_t bits;
+};
+
+/**
+ * IEEE 754 half (5-bit exponent, 10-bit mantissa).
+ * About 3.3 significant digits but range limited to ~6.5e4.
+*/
+struct fp16_t {
+    uint16_t bits;
+};
+
+inline float to_float(float v) {
+    return v;
+}
+
+inline float to_float(bf16_t v) {
+    uint32_t u = static_cast<uint32_t>(v.bits) << 16;
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+inline float to_float(fp16_t v) {
+#if defined(__F16C__)
+    return _cvtsh_ss(v.bits);
+#else
+    const uint32_t sign = static_cast<uint32_t>(v.bits & 0x8000u) << 16;
+    uint32_t exp = (v.bits >> 10) & 0x1fu;
+    uint32_t mant = v.bits & 0x3ffu;
+    uint32_t u;
+    if (exp == 0x1fu) {
+        u = sign | 0x7f800000u | (mant << 13);               // inf / NaN
+    } else if (exp != 0) {
+        u = sign | ((exp + 112) << 23) | (mant << 13);       // normal
+    } else if (mant == 0) {
+        u = sign;                                            // zero
+    } else {
+        // subnormal half: normalise the mantissa
+        exp = 113;
+        while ((mant & 0x400u) == 0) {
+            mant <<= 1;
+            --exp;
+        }
+        u = sign | (exp << 23) | ((mant & 0x3ffu) << 13);
+    }
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+#endif
+}
+
+/**
+ * @brief Name of a value type ("double", "float", "bf16", "fp16")
+*/
+template <typename V> const char* value_type_name();
+// specialised in mixed_precision.cpp
+template <> const char* value_type_name<double>();
+template <> const char* value_type_name<float>();
+template <> const char* value_type_name<bf16_t>();
+template <> const char* value_type_name<fp16_t>();
+
+/**
+ * @brief Rounds n doubles to the storage type V (round to nearest even)
+ *
+ * Uses AVX-512-BF16 (bf16) and F16C (fp16) conversion instructions when the
+ * compiler targets them, a scalar bit-level conversion otherwise.
+ *
+ * @param n             number of values
+ * @param src           double values
+ * @param dst           [out] converted values (size = n)
+*/
+template <typename V>
+void convert_values(long long n, const double* src, V* dst);
+// specialised in mixed_precision.cpp
+template <> void convert_values<float>(long long n, const double* src, float* dst);
+template <> void convert_values<bf16_t>(long long n, const double* src, bf16_t* dst);
+template <> void convert_values<fp16_t>(long long n, const double* src, fp16_t* dst);
+
+/**
+ * @brief y = A * x with CSR values stored as V, double accumulation
+ *
+ * Same guided row schedule as the double kernel of parallel_spmv_csr;
+ * every row is written exactly once, so y needs no zeroing.
+ *
+ * @param M             number of rows
+ * @param row_ptr       CSR row pointers
+ * @param col_idx       CSR column indices
+ * @param values        CSR values in reduced precision
+ * @param x             input vector (double)
+ * @param y             [out] result vector (double)
+*/
+template <typename V>
+void spmv_csr_mixed(int M, const int* row_ptr, const int* col_idx, const V* values,
+                    const double* x, double* y);
+
+enum ValueType {
+    VALUE_DOUBLE = 0,
+    VALUE_FLOAT,
+    VALUE_BF16,
+    VALUE_FP16
+};
+
+/**
+ * @brief Parses "double", "float", "bf16" or "fp16"
+*/
+bool value_type_from_name(const std::string& name, ValueType& type);
+
+/**
+ * @brief Name of a value type, inverse of value_type_from_name()
+*/
+const char* value_type_name(ValueType type);
+
+/**
+ * @brief Bytes of one stored value
+*/
+int value_type_bytes(ValueType type);
+
+/**
+ * Reduced-precision copy of the CSR values (only the array of the type is filled).
+*/
+struct MixedValues {
+    ValueType type = VALUE_DOUBLE;
+    std::vector<float> f;
+    std::vector<bf16_t> bf16;
+    std::vector<fp16_t> fp16;
+    double convert_ms = 0.0;
+};
+
+/**
+ * @brief Rounds the values to the given type (nothing is stored for VALUE_DOUBLE)
+ *
+ * @param mixed         [out] converted values and conversion time
+*/
+void mixed_values_convert(ValueType type, long long nnz, const double* values, MixedValues& mixed);
+
+/**
+ * @brief y = A * x with the values of a MixedValues copy (not VALUE_DOUBLE)
+*/
+void spmv_csr_mixed(const MixedValues& mixed, int M, const int* row_ptr, const int* col_idx,
+                    const double* x, double* y);
+
+/**
+ * Rounding of the stored values and its effect on y.
+*/
+struct MixedError {
+    double max_value_err = 0.0;     // largest relative rounding of a finite value
+    int out_of_range = 0;           // values beyond the range of the type (stored as inf)
+    double rel_max_err = 0.0;       // max |y - y_double| / max |y_double|
+    double rel_l2_err = 0.0;        // ||y - y_double|| / ||y_double||
+};
+
+/**
+ * @brief Compares the stored values with the double ones and y with a
+ *        serial double product
+ *
+ * @param y             result of spmv_csr_mixed() for x
+ * @param err           [out] value rounding and error of y
+*/
+void mixed_values_error(const MixedValues& mixed, int M, const int* row_ptr, const int* col_idx,
+                        const double* values, const double* x, const double* y, MixedError& err);
+
+#endif
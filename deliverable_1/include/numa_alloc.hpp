@@ -0,0 +1,138 @@
+#ifndef NUMA_ALLOC_HPP
+#define NUMA_ALLOC_HPP
+
+/*
+ * @file numa_alloc.hpp
+ * @brief NUMA-aware first-touch placement, thread pinning and the cache
+ *        and node topology of the machine
+ *
+ * Linux places a page on the node of the thread that first writes it. When
+ * the CSR arrays are filled by the serial COO -> CSR loop every page ends up
+ * on socket 0 and the threads of the other socket read remotely. Here the
+ * arrays are allocated without initialisation and copied in parallel, every
+ * thread writing exactly the rows (and nonzeros) it will later multiply, so
+ * each socket streams its part of the matrix from local memory. The kernel
+ * for the placed matrix is spmv_csr_numa_axpby() (axpby.hpp).
+ *
+ * The topology is read from /sys/devices/system/node (no libnuma needed);
+ * machines without it are treated as a single node.
+*/
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * std::allocator that default-initialises instead of value-initialising:
+ * vector<double, default_init_allocator<double>> v(n) does not write (and
+ * therefore does not place) its pages.
+*/
+template <typename T>
+struct default_init_allocator : std::allocator<T> {
+    template <typename U>
+    struct rebind {
+        typedef default_init_allocator<U> other;
+    };
+
+    default_init_allocator() = default;
+    template <typename U>
+    default_init_allocator(const default_init_allocator<U>&) {}
+
+    template <typename U>
+    void construct(U* p) {
+        ::new (static_cast<void*>(p)) U;
+    }
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+template <typename T>
+using first_touch_vector = std::vector<T, default_init_allocator<T> >;
+
+struct NumaTopology {
+    int num_nodes = 1;
+    std::vector<std::vector<int> > node_cpus;   // usable CPUs of every node
+    std::vector<int> cpu_node;                  // node of every CPU id (-1 = not usable)
+};
+
+enum AffinityPolicy {
+    AFFINITY_NONE = 0,      // leave placement to the OS / OMP_PROC_BIND
+    AFFINITY_COMPACT,       // fill the CPUs of node 0 first, then node 1, ...
+    AFFINITY_SCATTER,       // round-robin over the nodes
+    AFFINITY_SOCKET         // contiguous thread blocks per node, balanced
+};
+
+/**
+ * @brief Parses "none", "compact", "scatter" or "socket"
+*/
+bool affinity_from_name(const std::string& name, AffinityPolicy& policy);
+
+/**
+ * @brief Name of a policy, inverse of affinity_from_name()
+*/
+const char* affinity_name(AffinityPolicy policy);
+
+/**
+ * @brief Reads the NUMA nodes and their CPUs (restricted to the CPUs this
+ *        process may run on)
+*/
+void numa_read_topology(NumaTopology& topo);
+
+/**
+ * @brief Size of the last-level cache of the whole machine in bytes (every
+ *        instance counted once, e.g. one L3 per socket), 0 if unknown
+ *
+ * @param instances     [out] number of distinct instances (1 if unknown), optional
+*/
+long long llc_total_bytes(int* instances = nullptr);
+
+/**
+ * @brief Pins every OpenMP thread to one CPU according to the policy
+ *
+ * Runs one parallel region with num_threads threads; OpenMP reuses the same
+ * threads in the following regions, so the pinning sticks.
+ *
+ * @param topo          topology from numa_read_topology()
+ * @param policy        placement policy (AFFINITY_NONE only records the current CPUs)
+ * @param num_threads   number of threads
+ * @param thread_node   [out] node every thread runs on
+ * @return false if a thread could not be pinned
+*/
+bool pin_threads(const NumaTopology& topo, AffinityPolicy policy, int num_threads,
+                 std::vector<int>& thread_node);
+
+/**
+ * CSR matrix placed by first touch under a static nnz-balanced row partition.
+*/
+struct NumaCsr {
+    int M = 0;
+    int N = 0;
+    int num_parts = 0;
+    std::vector<int> row_start;             // rows of thread t: row_start[t] .. row_start[t+1]-1
+    first_touch_vector<int> row_ptr;
+    first_touch_vector<int> col_idx;
+    first_touch_vector<double> values;
+};
+
+/**
+ * @brief Splits the rows in num_parts contiguous blocks with about the same
+ *        number of nonzeros
+*/
+void numa_partition_rows(int M, const int* row_ptr, int num_parts, std::vector<int>& row_start);
+
+/**
+ * @brief Copies a CSR matrix into first-touch arrays, every thread writing its own rows
+*/
+void numa_first_touch_csr(int M, int N, const int* row_ptr, const int* col_idx, const double* values,
+                          int num_threads, NumaCsr& A);
+
+/**
+ * @brief Copies a vector of length n into a first-touch array; element i is
+ *        written by the thread owning row i * M / n
+*/
+void numa_first_touch_vector(const NumaCsr& A, int n, const double* src, first_touch_vector<double>& dst);
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef PANEL_CSR_HPP
+#define PANEL_CSR_HPP
+
+/*
+ * @file panel_csr.hpp
+ * @brief Column-panel (cache-blocked) CSR for matrices whose x exceeds the LLC
+ *
+ * The columns are cut into panels of W consecutive columns, W chosen so
+ * that W doubles of x fit in a cache budget. Every panel is stored as its
+ * own sub-CSR: only the rows that have nonzeros in the panel (global row
+ * ids), and column indices local to the panel. The product sweeps the
+ * panels one after the other; inside a panel the threads share the rows
+ * and add their partial sums into y, so the x values a panel gathers stay
+ * in cache while it runs. The price is one read-modify-write of y per
+ * panel row instead of one write per row.
+ *
+ * The default budget is PANEL_CACHE_FRACTION of one last-level cache
+ * instance (the threads of a socket share it; the rest is left to the
+ * matrix and y streams).
+*/
+
+#include <vector>
+
+// fraction of one LLC instance given to the x panel when no budget is set
+#define PANEL_CACHE_FRACTION 0.5
+
+struct PanelCsr {
+    int M = 0;
+    int N = 0;
+    int num_panels = 0;
+    int width = 0;                  // columns per panel (the last one may be narrower)
+
+    std::vector<int> row_off;       // panel p owns panel rows row_off[p] .. row_off[p+1]-1 (size num_panels+1)
+    std::vector<int> rows;          // global row of every panel row
+    std::vector<int> row_ptr;       // nonzeros of panel row i: row_ptr[i] .. row_ptr[i+1]-1
+    std::vector<int> col_idx;       // column relative to the first column of the panel
+    std::vector<double> values;
+    double build_ms = 0.0;
+};
+
+/**
+ * @brief Cache budget of the x panel in bytes: cache_budget if positive,
+ *        PANEL_CACHE_FRACTION of one LLC instance otherwise (0 if unknown)
+*/
+long long panel_cache_budget(long long cache_budget);
+
+/**
+ * @brief Panel width for a cache budget
+ *
+ * @param cache_budget      bytes of x per panel (<= 0: PANEL_CACHE_FRACTION of one LLC instance)
+ * @return columns per panel, a multiple of a cache line of doubles, at most N
+*/
+int panel_width_for_cache(int N, long long cache_budget);
+
+/**
+ * @brief Splits a CSR matrix (sorted columns) into column panels (parallel)
+ *
+ * Every thread counts the panel rows of a block of rows, the counts are
+ * scanned into per-thread offsets and every thread writes its rows, so the
+ * rows of each panel stay in increasing order.
+ *
+ * @param width             columns per panel (from panel_width_for_cache())
+ * @param P                 [out] panel matrix
+*/
+void panel_csr_build(int M, int N, const int* row_ptr, const int* col_idx, const double* values,
+                     int width, PanelCsr& P);
+
+/**
+ * @brief y = alpha * A * x + beta * y, panel by panel
+*/
+void spmv_panel_csr(const PanelCsr& P, double alpha, const double* x, double beta, double* y);
+
+/**
+ * @brief Frees the panel arrays
+*/
+void panel_csr_release(PanelCsr& P);
+
+#endif
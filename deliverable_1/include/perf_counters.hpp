@@ -0,0 +1,125 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+/*
+ * @file perf_counters.hpp
+ * @brief Hardware performance counters around a kernel (Linux perf_event_open)
+ *
+ * One counter is opened by every OpenMP thread of the team for that thread
+ * (counters do not follow threads that already exist), enabled and disabled
+ * around the measured code and summed. When the kernel, the permissions
+ * (perf_event_paranoid) or a virtual machine do not expose the PMU the
+ * counters report themselves unavailable, with the reason, and every read
+ * returns -1: callers print "n/a" and carry on. Events the CPU lacks (no
+ * generic back-end stall event on many Intel cores, for instance) fail on
+ * their own without affecting the others.
+ *
+ * A PerfRegion bundles every event: begin/end around the timed loop adds
+ * the per-thread counts of each pass, and the report divides them by the
+ * number of products and nonzeros. When more events are open than the PMU
+ * has counters the kernel time-multiplexes them; the counts are scaled by
+ * enabled / running time, as perf stat does.
+*/
+
+#include <string>
+#include <vector>
+
+enum PerfEvent {
+    PERF_LLC_MISSES = 0,    // last-level cache misses (loads and stores)
+    PERF_L1D_MISSES,        // L1 data cache load misses
+    PERF_CYCLES,            // core cycles
+    PERF_INSTRUCTIONS,      // retired instructions
+    PERF_DTLB_MISSES,       // data TLB load misses
+    PERF_MEM_STALLS,        // cycles stalled in the back end (mostly waiting on memory)
+    PERF_EVENT_COUNT
+};
+
+// the cache-miss events come first (compared by the prefetch report)
+#define PERF_CACHE_EVENTS 2
+
+/**
+ * @brief Short name of an event ("llc_misses", "l1d_misses", "cycles", ...)
+*/
+const char* perf_event_name(PerfEvent event);
+
+/**
+ * One event counted on every thread of the team.
+*/
+struct PerfCounters {
+    PerfEvent event = PERF_LLC_MISSES;
+    std::vector<int> fds;           // one per thread, -1 if it could not be opened
+    bool available = false;         // every thread has a counter
+    std::string error;              // why not (if !available)
+};
+
+/**
+ * @brief Opens the counter of one event on num_threads OpenMP threads
+ *
+ * @param pc            [out] counters (closed and reopened if already open)
+ * @return pc.available
+*/
+bool perf_counters_open(PerfCounters& pc, PerfEvent event, int num_threads);
+
+/**
+ * @brief Resets and starts the counters
+*/
+void perf_counters_start(PerfCounters& pc);
+
+/**
+ * @brief Stops the counters and returns the sum over the threads (-1 if unavailable)
+ *
+ * @param per_thread    [out] count of every thread, optional
+*/
+long long perf_counters_stop(PerfCounters& pc, std::vector<long long>* per_thread = nullptr);
+
+/**
+ * @brief Closes the file descriptors
+*/
+void perf_counters_close(PerfCounters& pc);
+
+/**
+ * Every event on every thread of the team, accumulated over begin/end pairs.
+*/
+struct PerfRegion {
+    int num_threads = 0;
+    int passes = 0;                                 // begin/end pairs
+    PerfCounters counters[PERF_EVENT_COUNT];
+    std::vector<long long> counts[PERF_EVENT_COUNT];    // per thread, empty if unavailable
+};
+
+/**
+ * @brief Opens every event on num_threads OpenMP threads and clears the counts
+ *
+ * @return false if no event at all is available
+*/
+bool perf_region_open(PerfRegion& region, int num_threads);
+
+/**
+ * @brief Starts the counters of the available events
+*/
+void perf_region_begin(PerfRegion& region);
+
+/**
+ * @brief Stops the counters and adds this pass to the per-thread counts
+*/
+void perf_region_end(PerfRegion& region);
+
+/**
+ * @brief Sum of an event over the threads and passes (-1 if unavailable)
+*/
+long long perf_region_total(const PerfRegion& region, PerfEvent event);
+
+/**
+ * @brief Prints every event per product and per nonzero, IPC, the share of
+ *        stalled cycles and the spread of the cycles over the threads
+ *
+ * @param products      number of products run inside the region
+*/
+void perf_region_print(const PerfRegion& region, long long nnz, long long products);
+
+/**
+ * @brief Closes every counter
+*/
+void perf_region_close(PerfRegion& region);
+
+#endif
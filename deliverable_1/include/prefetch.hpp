@@ -0,0 +1,90 @@
+#ifndef PREFETCH_HPP
+#define PREFETCH_HPP
+
+/*
+ * @file prefetch.hpp
+ * @brief CSR kernel with software prefetching of x and of the matrix streams
+ *
+ * When x does not fit in cache, the gather x[col_idx[k]] misses on every
+ * random column and the row loop waits on it. The kernel issues, while
+ * working on nonzero k, a prefetch of x[col_idx[k + d]] (col_idx[k + d]
+ * itself is a plain load, so it never runs past the end of the array),
+ * and at every row start prefetches of the cache lines of values d
+ * nonzeros ahead and of col_idx 2d nonzeros ahead, which the x prefetches
+ * will read. Distance 0 is the same loop without any prefetch.
+ *
+ * The best d depends on the memory latency, on the thread count and on
+ * how much work a row does per nonzero, so it is found by trial runs per
+ * matrix and kept in the tuning cache (key "prefetch").
+*/
+
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "csr_simd.hpp"
+#include "perf_counters.hpp"
+
+// distances tried by prefetch_autotune() (nonzeros ahead; 0 = no prefetch)
+#define PREFETCH_DISTANCES {0, 4, 8, 16, 32, 64, 128, 256}
+
+/**
+ * @brief y = alpha * A * x + beta * y with prefetches d nonzeros ahead
+ *
+ * @param distance      prefetch distance d in nonzeros (0 = none)
+ * @param streaming     non-temporal stores for y (only used when beta = 0)
+*/
+void spmv_csr_prefetch(int M, const int* row_ptr, const int* col_idx, const double* values,
+                       double alpha, const double* x, double beta, double* y, int distance, bool streaming);
+
+/**
+ * Trial run of one distance.
+*/
+struct PrefetchTrial {
+    int distance = 0;
+    double spmv_ms = 0.0;           // best trial time
+};
+
+/**
+ * @brief Times every distance of PREFETCH_DISTANCES and returns the fastest
+ *
+ * Distance 0 is timed with the kernel that runs without prefetching
+ * (spmv_csr_simd() with baseline_isa), so 0 wins only against that kernel.
+ *
+ * @param baseline_isa      resolved CSR kernel of the plan
+ * @param trial_iters       timed runs per distance
+ * @param trials            [out] one entry per distance
+ * @return best distance (0 if prefetching does not help)
+*/
+int prefetch_autotune(int M, int N, const int* row_ptr, const int* col_idx, const double* values,
+                      SimdIsa baseline_isa, int trial_iters, std::vector<PrefetchTrial>& trials);
+
+/**
+ * The plan's kernel without prefetching against the prefetching one.
+*/
+struct PrefetchComparison {
+    SimdIsa baseline_isa = SIMD_COMPILER;
+    int distance = 0;
+    double ms[2] = {0.0, 0.0};                      // best time: [0] no prefetch, [1] distance
+    long long misses[2][PERF_CACHE_EVENTS] = {};    // of one product, -1 if not measured
+    bool counters_available = false;
+    std::string counters_error;
+};
+
+/**
+ * @brief Times both kernels with the bench harness and counts the cache
+ *        misses of one product of each (y is a private scratch vector)
+ *
+ * @param baseline_isa      resolved CSR kernel of the plan (the "off" variant)
+ * @param cmp               [out] times and misses of both variants
+*/
+void prefetch_compare(int M, const int* row_ptr, const int* col_idx, const double* values,
+                      double alpha, const double* x, double beta, SimdIsa baseline_isa, int distance,
+                      bool streaming, int num_threads, const BenchConfig& cfg, PrefetchComparison& cmp);
+
+/**
+ * @brief Prints the comparison table with the time and miss reductions
+*/
+void prefetch_compare_print(const PrefetchComparison& cmp);
+
+#endif
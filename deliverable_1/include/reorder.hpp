@@ -0,0 +1,111 @@
+#ifndef REORDER_HPP
+#define REORDER_HPP
+
+/*
+ * @file reorder.hpp
+ * @brief Symmetric row/column reordering of CSR matrices
+ *
+ * The locality of the x accesses in sum += values[k] * x[col_idx[k]]
+ * depends only on how close the columns of a row (and of consecutive rows)
+ * are. A symmetric permutation B = P A P^T keeps the problem the same
+ * (y = A x  <=>  P y = B (P x)) while moving the nonzeros towards the
+ * diagonal:
+ *  - RCM:    reverse Cuthill-McKee, BFS from a pseudo-peripheral node,
+ *            minimises the bandwidth of banded/mesh matrices
+ *  - degree: rows sorted by decreasing degree, groups the hubs of
+ *            power-law graphs so their x entries stay in cache
+ *  - gorder: greedy graph ordering (Wei et al.) that places next the node
+ *            sharing the most neighbours with the last w placed nodes
+ * The orderings work on the pattern of A + A^T and need a square matrix.
+*/
+
+#include <string>
+#include <vector>
+
+// sliding window of the Gorder score
+#define GORDER_WINDOW 5
+// neighbours with a larger degree are not expanded by Gorder (hubs)
+#define GORDER_HUB_DEGREE 256
+
+enum ReorderMethod {
+    REORDER_NONE = 0,
+    REORDER_RCM,
+    REORDER_DEGREE,
+    REORDER_GORDER
+};
+
+/**
+ * @brief Parses "none", "rcm", "degree" or "gorder"
+ *
+ * @return false if the name is unknown
+*/
+bool reorder_from_name(const std::string& name, ReorderMethod& method);
+
+/**
+ * @brief Name of a method, inverse of reorder_from_name()
+*/
+const char* reorder_name(ReorderMethod method);
+
+/**
+ * @brief Computes a symmetric permutation of a square CSR matrix
+ *
+ * @param method        ordering algorithm
+ * @param M             number of rows (= columns)
+ * @param row_ptr       CSR row pointers
+ * @param col_idx       CSR column indices
+ * @param perm          [out] perm[new] = old (size = M)
+*/
+void compute_permutation(ReorderMethod method, int M, const int* row_ptr, const int* col_idx,
+                         std::vector<int>& perm);
+
+/**
+ * @brief B = P A P^T: row i of B is row perm[i] of A, columns renumbered
+ *        and sorted (OpenMP over rows)
+*/
+void permute_csr(int M, const int* row_ptr, const int* col_idx, const double* values,
+                 const std::vector<int>& perm,
+                 std::vector<int>& new_row_ptr, std::vector<int>& new_col_idx,
+                 std::vector<double>& new_values);
+
+/**
+ * @brief dst = P src, i.e. dst[i] = src[perm[i]] (OpenMP)
+*/
+void permute_vector(int n, const std::vector<int>& perm, const double* src, double* dst);
+
+/**
+ * @brief dst = P^T src, i.e. dst[perm[i]] = src[i] (OpenMP)
+*/
+void unpermute_vector(int n, const std::vector<int>& perm, const double* src, double* dst);
+
+/**
+ * @brief Bandwidth max |i - j| and profile sum_i (i - min_j) over the
+ *        rows whose first column is left of the diagonal
+*/
+void bandwidth_profile(int M, const int* row_ptr, const int* col_idx,
+                       long long& bandwidth, long long& profile);
+
+/**
+ * Reordered copy B = P A P^T with the cost and the effect of the ordering.
+*/
+struct ReorderedCsr {
+    ReorderMethod method = REORDER_NONE;
+    std::vector<int> perm;                  // perm[new] = old
+    std::vector<int> row_ptr;
+    std::vector<int> col_idx;
+    std::vector<double> values;
+    double order_ms = 0.0;                  // compute_permutation()
+    double permute_ms = 0.0;                // permute_csr()
+    long long bandwidth_before = 0, bandwidth_after = 0;
+    long long profile_before = 0, profile_after = 0;
+};
+
+/**
+ * @brief Orders and permutes a square CSR matrix, timing both steps
+ *
+ * @param B             [out] permuted matrix, permutation, times and
+ *                      bandwidth / profile before and after
+*/
+void reorder_csr(ReorderMethod method, int M, const int* row_ptr, const int* col_idx, const double* values,
+                 ReorderedCsr& B);
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef ROOFLINE_HPP
+#define ROOFLINE_HPP
+
+/*
+ * @file roofline.hpp
+ * @brief Roofline calibration of the node: sustainable memory bandwidth
+ *        and peak floating-point throughput per thread count
+ *
+ * The memory roofs are measured with STREAM-style loops over arrays of
+ * 4x the last-level cache (clamped to ROOFLINE_MIN/MAX_ARRAY_BYTES), first
+ * touched by the same static partition that then reads them:
+ *   copy    a[i] = b[i]                   16 bytes per element
+ *   triad   a[i] = b[i] + s * c[i]        24 bytes per element
+ *   gather  sum += v[k] * x[idx[k]]       12 bytes + one cache line of x
+ * The gather probe is the CSR inner loop with idx random over the whole
+ * array, so every x access misses the caches (and mostly the TLB): the
+ * bandwidth an irregular matrix sustains, to compare with triad. It runs
+ * over 1/ROOFLINE_GATHER_FRACTION of the elements to keep it short.
+ *
+ * The SpMV reports count the matrix and y traffic, so their roof is the
+ * triad bandwidth: attainable = min(peak, intensity * triad). The compute
+ * roof is ROOFLINE_FP_CHAINS independent multiply-add chains per thread,
+ * the peak of the instruction set this build targets (-march), not of the
+ * silicon.
+ *
+ * Calibrations are stored in a small text cache keyed by host name and
+ * thread count; the reports only look them up, calibrating is explicit
+ * (parallel_spmv_csr --calibrate), since it takes a few seconds per
+ * thread count.
+*/
+
+#include <string>
+#include <vector>
+
+#define ROOFLINE_DEFAULT_CACHE "../benchmarks/roofline_cache.txt"
+#define ROOFLINE_MIN_ARRAY_BYTES (32LL << 20)
+#define ROOFLINE_MAX_ARRAY_BYTES (512LL << 20)
+#define ROOFLINE_TRIALS 3                   // timed runs per probe, best one kept
+#define ROOFLINE_GATHER_FRACTION 8          // gather probe length: array elements / 8
+#define ROOFLINE_LINE_BYTES 64
+#define ROOFLINE_FP_CHAINS 64               // independent accumulators per thread
+#define ROOFLINE_FP_ITERS (1 << 22)         // multiply-adds per chain
+
+struct RooflineCalib {
+    std::string host;
+    int threads = 0;                        // 0: not calibrated
+    double copy_gbs = 0.0;
+    double triad_gbs = 0.0;
+    double gather_gbs = 0.0;
+    double peak_gflops = 0.0;
+    double calib_ms = 0.0;                  // 0 when read from the cache
+};
+
+/**
+ * @brief Runs the four probes with a given number of threads
+ *
+ * @param calib             [out] roofs of this host and thread count
+*/
+void roofline_calibrate(int threads, RooflineCalib& calib);
+
+/**
+ * @brief Calibrates 1, 2, 4, ... threads up to max_threads (always included)
+ *        and stores every result in the cache
+ *
+ * @param calibs            [out] one entry per thread count
+ * @return false if the cache cannot be written
+*/
+bool roofline_calibrate_sweep(const std::string& path, int max_threads, std::vector<RooflineCalib>& calibs);
+
+/**
+ * @brief Looks up the calibration of this host for a thread count
+ *
+ * @return false if the file does not exist or has no such entry
+*/
+bool roofline_cache_lookup(const std::string& path, int threads, RooflineCalib& calib);
+
+/**
+ * @brief Adds a calibration to the cache, replacing the one of the same host and thread count
+ *
+ * @return false if the file cannot be written
+*/
+bool roofline_cache_store(const std::string& path, const RooflineCalib& calib);
+
+/**
+ * @brief Bytes of one CSR SpMV under the traffic model of the reports: value
+ *        and column index per nonzero, y per row; x is not counted (its
+ *        reuse depends on the matrix)
+ *
+ * @param value_bytes       bytes per stored value (8 for double)
+ * @param y_bytes           bytes of y per row (8 written, 16 when y is read too)
+*/
+double csr_spmv_bytes(long long nnz, long long M, double value_bytes = 8.0, double y_bytes = 8.0);
+
+/**
+ * @brief Attainable GFLOPS at an arithmetic intensity under one bandwidth roof:
+ *        min(peak, intensity * bandwidth)
+*/
+double roofline_attainable(const RooflineCalib& calib, double intensity, double bandwidth_gbs);
+
+/**
+ * @brief Achieved GFLOPS as a percentage of the triad roof (-1 if not calibrated)
+*/
+double roofline_percent(const RooflineCalib& calib, double gflops, double intensity);
+
+/**
+ * @brief Prints the roofs and the percentage of attainable performance of a
+ *        kernel in the format of the benchmark reports
+*/
+void roofline_print(const RooflineCalib& calib, int threads, double gflops, double intensity);
+
+/**
+ * @brief Prints the roofs of every calibrated thread count (one row each)
+*/
+void roofline_print_calibration(const std::vector<RooflineCalib>& calibs);
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef SCALING_HPP
+#define SCALING_HPP
+
+/*
+ * @file scaling.hpp
+ * @brief Thread-scaling sweep of the CSR kernel over OpenMP schedules
+ *
+ * The CSR row loop runs with schedule(runtime), so one binary can time
+ * every thread count and every schedule / chunk in the same run instead
+ * of one job per combination. For every thread count the sweep keeps the
+ * fastest schedule and derives:
+ *   speedup      T(t0) / T(t), t0 the smallest thread count swept
+ *   efficiency   speedup / (t / t0)
+ *   bandwidth    csr_spmv_bytes() / T(t), the model of the other reports
+ * The knee is the first thread count whose bandwidth is within
+ * SCALING_KNEE_FRACTION of the best one: past it the memory system is
+ * saturated and more threads only add contention.
+ *
+ * The best configuration is stored in the tuning cache (key "scaling"):
+ * one entry per thread count with its fastest schedule, and one with
+ * threads = 0 for the overall choice (thread count in param2), the fewest
+ * threads within SCALING_TIE of the fastest time.
+*/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+// schedules tried by default (chunk 0 = the OpenMP default of the kind)
+#define SCALING_SCHEDULES "static,static:64,dynamic:16,dynamic:64,dynamic:256,guided:1,guided:10,guided:64"
+#define SCALING_KNEE_FRACTION 0.9
+#define SCALING_TIE 0.02                    // relative time within which fewer threads win
+#define SCALING_MAX_SECONDS 1.0             // sampling budget per (threads, schedule) point
+
+enum ScheduleKind {
+    SCHED_STATIC = 0,
+    SCHED_DYNAMIC,
+    SCHED_GUIDED
+};
+
+struct ScheduleChoice {
+    ScheduleKind kind = SCHED_GUIDED;
+    int chunk = 0;                          // 0: default chunk of the kind
+};
+
+/**
+ * @brief Name of a schedule kind ("static", "dynamic", "guided")
+*/
+const char* schedule_kind_name(ScheduleKind kind);
+
+/**
+ * @brief Parses "kind" or "kind:chunk" (also "kind,chunk")
+ *
+ * @return false if the kind is unknown or the chunk is not positive
+*/
+bool schedule_from_string(const std::string& text, ScheduleChoice& sched);
+
+/**
+ * @brief "kind" or "kind:chunk", the inverse of schedule_from_string()
+*/
+std::string schedule_describe(const ScheduleChoice& sched);
+
+/**
+ * @brief Parses a comma separated list of schedules (chunks after ':')
+*/
+bool schedule_list_from_string(const std::string& text, std::vector<ScheduleChoice>& scheds);
+
+/**
+ * @brief y = A * x, rows distributed with the given OpenMP schedule
+*/
+void spmv_csr_schedule(const ScheduleChoice& sched, int M, const int* row_ptr, const int* col_idx,
+                       const double* values, const double* x, double* y);
+
+/**
+ * One timed (thread count, schedule) pair.
+*/
+struct ScalingPoint {
+    int threads = 0;
+    ScheduleChoice sched;
+    BenchStats stats;
+};
+
+/**
+ * Fastest schedule of one thread count and the derived figures.
+*/
+struct ScalingRow {
+    int threads = 0;
+    int best = -1;                          // index into ScalingSweep::points
+    double median_ms = 0.0;
+    double speedup = 0.0;
+    double efficiency = 0.0;
+    double gbs = 0.0;
+};
+
+struct ScalingSweep {
+    std::vector<ScalingPoint> points;
+    std::vector<ScalingRow> rows;           // one per thread count, in sweep order
+    int knee_threads = 0;                   // bandwidth within SCALING_KNEE_FRACTION of the best
+    int best_row = -1;                      // configuration to use in production
+};
+
+/**
+ * @brief Times every schedule at every thread count with the bench harness
+ *
+ * Each point gets a warm-up and at most SCALING_MAX_SECONDS of sampling
+ * (or less if the configuration asks for less). Leaves the OpenMP thread
+ * count at the last one swept.
+ *
+ * @param sweep         [out] points, per-thread-count rows, knee and best choice
+*/
+void scaling_sweep(int M, const int* row_ptr, const int* col_idx, const double* values,
+                   const double* x, double* y, const std::vector<int>& threads,
+                   const std::vector<ScheduleChoice>& scheds, const BenchConfig& cfg, ScalingSweep& sweep);
+
+/**
+ * @brief Records every point of a sweep with bench_record(), tagged
+ *        "csr/<schedule>"
+*/
+void scaling_record(const BenchConfig& cfg, const std::string& bench, const std::string& matrix,
+                    const ScalingSweep& sweep);
+
+/**
+ * @brief Prints the sweep report: per thread count the fastest schedule,
+ *        speedup, efficiency, GFLOPS, bandwidth and % of the roofline, then
+ *        the knee and the best configuration (verbose: the median of every
+ *        point as well)
+ *
+ * @param cache_path    tuning cache the best configuration was stored in
+*/
+void scaling_print(const ScalingSweep& sweep, const std::string& matrix, int M, int N, int nnz,
+                   const std::string& cache_path, bool verbose);
+
+/**
+ * @brief Stores the per-thread-count and overall choices under key "scaling"
+ *
+ * @return false if the cache cannot be written
+*/
+bool scaling_cache_store(const std::string& path, uint64_t hash, const ScalingSweep& sweep);
+
+/**
+ * @brief Looks up a stored choice: threads > 0 gives the schedule of that
+ *        thread count, threads = 0 the overall choice
+ *
+ * @param best_threads  [out] thread count of the choice
+ * @return false if the matrix was never swept (for that thread count)
+*/
+bool scaling_cache_lookup(const std::string& path, uint64_t hash, int threads,
+                          ScheduleChoice& sched, int& best_threads);
+
+#endif
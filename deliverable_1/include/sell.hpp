@@ -0,0 +1,94 @@
+#ifndef SELL_HPP
+#define SELL_HPP
+
+/*
+ * @file sell.hpp
+ * @brief SELL-C-sigma (sliced ELLPACK) storage format and OpenMP+SIMD SpMV kernel
+ *
+ * Rows are grouped in chunks of C consecutive rows. Inside a chunk every row
+ * is padded to the length of the longest one and the entries are stored
+ * column-major, so one SIMD instruction processes the j-th entry of C rows
+ * at the same time. Before chunking, rows are sorted by decreasing length
+ * inside windows of sigma rows to reduce the padding.
+*/
+
+#include <vector>
+
+// Default chunk height = number of doubles in one vector register
+#if defined(__AVX512F__)
+#define SELL_DEFAULT_C 8
+#elif defined(__AVX__)
+#define SELL_DEFAULT_C 4
+#else
+#define SELL_DEFAULT_C 2
+#endif
+
+// Default sorting window (in rows)
+#define SELL_DEFAULT_SIGMA 256
+
+struct SellMatrix {
+    int M = 0;                      // number of rows
+    int N = 0;                      // number of columns
+    int C = SELL_DEFAULT_C;         // chunk height
+    int sigma = 1;                  // sorting window
+    int num_chunks = 0;
+    long long nnz = 0;              // real nonzeros (without padding)
+
+    std::vector<int> chunk_ptr;     // offset of each chunk in col_idx/values (size = num_chunks+1)
+    std::vector<int> chunk_len;     // padded row length of each chunk
+    std::vector<int> perm;          // perm[i] = original row stored at position i (size = num_chunks*C)
+    std::vector<int> col_idx;       // column indices, column-major inside each chunk
+    std::vector<double> values;     // values, zero for padding entries
+};
+
+/**
+ * @brief Converts a CSR matrix to SELL-C-sigma
+ *
+ * Rows are sorted by decreasing length inside each window of sigma rows
+ * (sigma = 1 keeps the original order). Padding entries get value 0 and
+ * repeat the last valid column of their row, so they do not touch new
+ * cache lines of x.
+ *
+ * @param M             number of rows
+ * @param N             number of columns
+ * @param row_ptr       CSR row pointers (size = M+1)
+ * @param col_idx       CSR column indices
+ * @param values        CSR values
+ * @param C             chunk height (rows processed in lockstep)
+ * @param sigma         sorting window, rounded up to a multiple of C
+ * @param sell          [out] SELL-C-sigma matrix
+*/
+void csr_to_sell(int M, int N, const int* row_ptr, const int* col_idx,
+                 const double* values, int C, int sigma, SellMatrix& sell);
+
+/**
+ * @brief Converts COO arrays to SELL-C-sigma (through an intermediate CSR,
+ *        duplicates summed: sell.nnz counts the merged entries)
+*/
+void coo_to_sell(int M, int N, int nz,
+                 const std::vector<int>& row_coo, const std::vector<int>& col_coo,
+                 const std::vector<double>& val_coo,
+                 int C, int sigma, SellMatrix& sell);
+
+/**
+ * @brief y = A * x with A in SELL-C-sigma format
+ *
+ * Chunks are distributed over OpenMP threads; inside a chunk the C rows are
+ * computed in lockstep with an `omp simd` loop. Results are scattered back
+ * to the original row order through perm, so y has the original numbering.
+ * Chunk heights 2, 4, 8, 16 and 32 use a compile-time specialised kernel.
+ *
+ * @param A             SELL-C-sigma matrix
+ * @param x             input vector (size = N)
+ * @param y             [out] result vector (size = M)
+*/
+void spmv_sell(const SellMatrix& A, const double* x, double* y);
+
+/**
+ * @brief Number of stored entries (real nonzeros + padding)
+*/
+inline long long sell_stored_entries(const SellMatrix& A) {
+    return A.chunk_ptr.empty() ? 0 : A.chunk_ptr.back();
+}
+
+#endif
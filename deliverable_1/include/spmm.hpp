@@ -0,0 +1,32 @@
+#ifndef SPMM_HPP
+#define SPMM_HPP
+
+/*
+ * @file spmm.hpp
+ * @brief CSR sparse x tall-skinny dense product (multiple right-hand sides)
+ *
+ * Y = A * X where X is N x k and Y is M x k, both row-major. Every nonzero
+ * a_ij is loaded once and multiplied with the k contiguous entries of row j
+ * of X, so the matrix stream (col_idx + values) is amortised over k vectors
+ * and the innermost loop is vectorised across k.
+*/
+
+/**
+ * @brief Y = A * X with X, Y row-major with k columns
+ *
+ * k = 1, 2, 4, 8 and 16 use a kernel where k is a template parameter (the
+ * k-loop is fully unrolled into SIMD registers); other k use a generic
+ * kernel. OpenMP over rows with the same guided schedule as the CSR SpMV.
+ *
+ * @param M             number of rows
+ * @param row_ptr       CSR row pointers
+ * @param col_idx       CSR column indices
+ * @param values        CSR values
+ * @param k             number of right-hand sides
+ * @param X             input block (size = N*k, row-major)
+ * @param Y             [out] result block (size = M*k, row-major)
+*/
+void spmm_csr(int M, const int* row_ptr, const int* col_idx, const double* values,
+              int k, const double* X, double* Y);
+
+#endif
@@ -0,0 +1,211 @@
+#ifndef SPMV_HPP
+#define SPMV_HPP
+
+/*
+ * @file spmv.hpp
+ * @brief libspmv: plan once, multiply many times
+ *
+ * The public entry point of the library. A CsrMatrix is a read-only view of
+ * CSR arrays owned by the caller (vectors, a mapped .csrb file, ...). An
+ * SpmvPlan holds every decision and every buffer an SpMV needs: the storage
+ * format (fixed or autotuned through the tuning cache), its work partition,
+ * the thread pinning and the NUMA first-touch copies. All the allocation,
+ * conversion and placement happens in spmv_plan_create(); spmv_execute()
+ * only runs the kernel and never allocates, so it can sit in a solver loop.
+ * spmv_execute_axpby() computes y = alpha * A * x + beta * y; CSR plans fuse
+ * the update into the row loop, the other formats go through a scratch
+ * vector allocated with the plan. Plans created with opt.transpose also
+ * prepare A^T x (spmv_execute_transpose()). CSR plans can also store the
+ * values in reduced precision (opt.value_type) or run the row loop with
+ * an OpenMP schedule chosen at run time, explicitly or from a previous
+ * thread-scaling sweep (opt.runtime_schedule, opt.tuned_schedule).
+ *
+ *   CsrMatrix A = csr_matrix_view(loaded);
+ *   SpmvOptions opt;
+ *   opt.format = FORMAT_CSR_MERGE;
+ *   SpmvPlan plan;
+ *   if (!spmv_plan_create(A, opt, plan)) ...
+ *   for (...) spmv_execute(plan, x, y);
+ *
+ * The matrix arrays must outlive the plan. Kernels run with the thread count
+ * the plan was created for.
+*/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "autotune.hpp"
+#include "axpby.hpp"
+#include "csr_bin.hpp"
+#include "csr_simd.hpp"
+#include "mixed_precision.hpp"
+#include "numa_alloc.hpp"
+#include "panel_csr.hpp"
+#include "prefetch.hpp"
+#include "scaling.hpp"
+#include "transpose.hpp"
+
+#define SPMV_TRIAL_ITERS 5
+#define SPMV_DEFAULT_TUNING_CACHE "../benchmarks/tuning_cache.txt"
+// SpmvOptions::prefetch: find the distance by trial runs (cached under "prefetch")
+#define SPMV_PREFETCH_AUTO -1
+
+/**
+ * Non-owning view of a CSR matrix (0-based, sorted columns).
+*/
+struct CsrMatrix {
+    int M = 0;
+    int N = 0;
+    int nnz = 0;
+    const int* row_ptr = nullptr;
+    const int* col_idx = nullptr;
+    const double* values = nullptr;
+};
+
+/**
+ * @brief View of a loaded (mapped or parsed) matrix
+*/
+CsrMatrix csr_matrix_view(const LoadedCsr& A);
+
+/**
+ * @brief View of CSR arrays held elsewhere
+*/
+CsrMatrix csr_matrix_view(int M, int N, const int* row_ptr, const int* col_idx, const double* values);
+
+struct SpmvOptions {
+    SpmvFormat format = FORMAT_CSR;     // ignored with autotune
+    int param1 = 0;                     // SELL C / BCSR r (0 = default)
+    int param2 = 0;                     // SELL sigma / BCSR c (0 = default)
+    int num_threads = 0;                // 0 = omp_get_max_threads() (tuned_schedule: the swept choice)
+
+    bool autotune = false;              // pick the format by trial runs (cached)
+    bool retune = false;                // ignore a cached choice
+    std::string tuning_cache = SPMV_DEFAULT_TUNING_CACHE;
+    int trial_iters = SPMV_TRIAL_ITERS;
+    long long expected_iters = 0;       // SpMVs that will amortise the conversion (0 = many)
+
+    bool numa = false;                  // first-touch copies, static nnz-balanced CSR (FORMAT_CSR only)
+    AffinityPolicy affinity = AFFINITY_NONE;
+    StorePolicy stores = STORES_AUTO;   // streaming stores for y (CSR plans, beta = 0)
+    SimdIsa simd = SIMD_AUTO;           // CSR kernel (non-NUMA CSR plans)
+    int prefetch = 0;                   // CSR prefetch distance in nonzeros (0 = off, SPMV_PREFETCH_AUTO)
+    bool panels = false;                // column-panel blocking (FORMAT_CSR only)
+    long long panel_budget = 0;         // bytes of x per panel (0 = from the LLC size)
+
+    // variants of the guided CSR kernel (FORMAT_CSR, no NUMA, prefetching or panels)
+    ValueType value_type = VALUE_DOUBLE;    // stored values, double accumulation
+    bool runtime_schedule = false;      // schedule(runtime) row loop with `schedule` (double values)
+    ScheduleChoice schedule;
+    bool tuned_schedule = false;        // schedule from a sweep in the tuning cache (key "scaling")
+
+    bool transpose = false;             // also prepare the transposed product
+    TransposeMethod transpose_method = TRANSPOSE_AUTO;
+};
+
+struct SpmvPlan {
+    CsrMatrix A;
+    SpmvFormat format = FORMAT_CSR;
+    int num_threads = 0;
+    bool numa = false;
+    bool streaming = false;             // y written with non-temporal stores when beta = 0
+    SimdIsa isa = SIMD_COMPILER;        // resolved CSR kernel (never AUTO)
+    int prefetch_distance = 0;          // > 0: the prefetching CSR kernel runs instead of isa
+    bool prefetch_cache_hit = false;
+    std::vector<PrefetchTrial> prefetch_trials;     // empty unless searched
+    PanelCsr panel;                     // column panels (used if num_panels > 1)
+    ValueType value_type = VALUE_DOUBLE;
+    MixedValues mixed;                  // reduced-precision values (value_type != VALUE_DOUBLE)
+    bool runtime_schedule = false;      // the schedule(runtime) row loop runs with `schedule`
+    ScheduleChoice schedule;
+    bool schedule_cache_hit = false;    // schedule (and thread count) from a sweep
+
+    // autotuning (valid if the options asked for it)
+    bool tuned = false;
+    bool cache_hit = false;
+    uint64_t hash = 0;
+    MatrixFeatures features;
+    std::vector<TrialResult> trials;    // empty on a cache hit
+    double tune_ms = 0.0;               // features + cache lookup + search
+
+    double setup_ms = 0.0;              // format conversion / first-touch placement
+
+    SpmvDispatch dispatch;
+    NumaTopology topo;
+    std::vector<int> thread_node;       // node of every thread (after pinning)
+    NumaCsr numa_A;
+    first_touch_vector<double> numa_x;  // x and y placed like the rows (NUMA plans)
+    first_touch_vector<double> numa_y;
+    std::vector<double> scratch;        // A * x of kernels without a fused update
+    TransposePlan transpose;            // A^T x engine (if requested)
+};
+
+/**
+ * @brief Chooses the format, converts the matrix and places the data
+ *
+ * Sets the OpenMP thread count to opt.num_threads (if given) and pins the
+ * threads when an affinity policy or NUMA placement is requested.
+ *
+ * With opt.tuned_schedule the plan looks up the sweep of this matrix: with
+ * opt.num_threads > 0 the best schedule of that thread count, otherwise
+ * the overall choice, thread count included. Without a sweep it warns and
+ * keeps the guided kernel.
+ *
+ * @param A             matrix (borrowed, must outlive the plan)
+ * @param opt           options
+ * @param plan          [out] plan, ready for spmv_execute()
+ * @return false (message on stderr) if the options are inconsistent
+*/
+bool spmv_plan_create(const CsrMatrix& A, const SpmvOptions& opt, SpmvPlan& plan);
+
+/**
+ * @brief y = A * x with the plan, no allocation
+ *
+ * NUMA plans compute on their first-touched plan.numa_x / plan.numa_y.
+ * Passing other buffers costs a copy of x in and of y out on every call,
+ * in extra parallel regions, which can cost more than the product: fill
+ * plan.numa_x once and pass plan.numa_x.data() / plan.numa_y.data().
+*/
+void spmv_execute(SpmvPlan& plan, const double* x, double* y);
+
+/**
+ * @brief y = alpha * A * x + beta * y with the plan, no allocation
+ *
+ * With beta = 0 the old content of y is never read (it may be uninitialised).
+ * NUMA plans copy foreign x / y on every call, as in spmv_execute() (y in
+ * as well when beta != 0).
+*/
+void spmv_execute_axpby(SpmvPlan& plan, double alpha, const double* x, double beta, double* y);
+
+/**
+ * @brief y = alpha * A^T * x + beta * y (x of size M, y of size N), no allocation
+ *
+ * The plan must have been created with opt.transpose.
+*/
+void spmv_execute_transpose(SpmvPlan& plan, double alpha, const double* x, double beta, double* y);
+
+/**
+ * @brief Frees everything the plan owns (the matrix view stays valid)
+*/
+void spmv_plan_destroy(SpmvPlan& plan);
+
+/**
+ * @brief Short description of the plan, e.g. "sell (C = 8, sigma = 256)"
+*/
+std::string spmv_plan_describe(const SpmvPlan& plan);
+
+/**
+ * @brief Tag of the kernel that runs, for bench_record(), e.g. "csr/avx2",
+ *        "csr/numa", "csr_float", "csr/dynamic:64"
+*/
+std::string spmv_plan_tag(const SpmvPlan& plan);
+
+/**
+ * @brief Per-node table of a NUMA plan: threads, rows, nonzeros, time of the
+ *        slowest thread and bandwidth (one more product, with per-thread timers)
+ *
+ * @param y_bytes       bytes of y per row (8, 16 when beta != 0)
+*/
+void spmv_print_numa_nodes(SpmvPlan& plan, double alpha, double beta, double y_bytes);
+
+#endif
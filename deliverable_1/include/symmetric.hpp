@@ -0,0 +1,61 @@
+#ifndef SYMMETRIC_HPP
+#define SYMMETRIC_HPP
+
+/*
+ * @file symmetric.hpp
+ * @brief Parallel SpMV for symmetric matrices stored as their lower triangle
+ *
+ * Only the entries with col <= row are kept (CSR). Every off-diagonal entry
+ * a_ij is applied twice:
+ *     y_i += a_ij * x_j      (gather, like plain CSR)
+ *     y_j += a_ij * x_i      (scatter to an earlier row)
+ * which roughly halves the matrix traffic of SPD workloads.
+ *
+ * Race-free scatter: rows are split in contiguous, nnz-balanced blocks, one
+ * per thread. Scatters that land inside the thread's own block go straight
+ * into y; the ones that land in earlier blocks go to a thread-private
+ * partial y covering [lowest column touched, first own row), which is
+ * reduced into y after a barrier.
+*/
+
+#include <vector>
+
+/**
+ * Thread partition and private partial-y buffers, built once and reused
+ * in every SpMV (execute does not allocate).
+*/
+struct SymSpmvPlan {
+    int M = 0;
+    int num_parts = 0;
+    std::vector<int> row_start;                 // first row of each part (size = num_parts+1)
+    std::vector<int> col_min;                   // lowest column touched by each part
+    std::vector<std::vector<double>> partial;   // partial[p][j - col_min[p]], j < row_start[p]
+};
+
+/**
+ * @brief Builds the partition and sizes the partial-y buffers
+ *
+ * @param M             number of rows (== columns)
+ * @param row_ptr       lower-triangle CSR row pointers
+ * @param col_idx       lower-triangle CSR column indices
+ * @param num_parts     number of parts (usually the number of threads)
+ * @param plan          [out] partition and buffers
+*/
+void sym_spmv_setup(int M, const int* row_ptr, const int* col_idx,
+                    int num_parts, SymSpmvPlan& plan);
+
+/**
+ * @brief y = A * x with A symmetric, lower triangle in CSR
+ *
+ * @param plan          plan built by sym_spmv_setup()
+ * @param row_ptr       lower-triangle CSR row pointers
+ * @param col_idx       lower-triangle CSR column indices (col <= row)
+ * @param values        lower-triangle CSR values
+ * @param x             input vector (size = M)
+ * @param y             [out] result vector (size = M)
+*/
+void spmv_sym_lower(SymSpmvPlan& plan,
+                    const int* row_ptr, const int* col_idx, const double* values,
+                    const double* x, double* y);
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef TRANSPOSE_HPP
+#define TRANSPOSE_HPP
+
+/*
+ * @file transpose.hpp
+ * @brief Transposed SpMV y = alpha * A^T * x + beta * y on a CSR matrix
+ *
+ * Two engines:
+ *   - CSC: A is transposed once (parallel CSR -> CSC, i.e. the CSR arrays
+ *     of A^T) and every product is a forward CSR product of A^T. Costs a
+ *     conversion of a few SpMVs and a second copy of the matrix.
+ *   - private: no conversion. Row r of A scatters values * x[r] into the
+ *     columns it touches; every thread scatters its rows (nnz-balanced
+ *     blocks) into a private buffer covering only the column range of its
+ *     rows, and the buffers are summed column by column into y. Costs the
+ *     zeroing and reduction of the buffers in every product.
+ *
+ * TRANSPOSE_AUTO amortises the conversion: the CSC engine is chosen when
+ * the per-product traffic of the private buffers (which grows with the
+ * thread count and with the column span of the row blocks) times the
+ * number of products exceeds the conversion cost. With an unknown number
+ * of products (0) the conversion cost is ignored, as in the autotuner, so
+ * the private engine is kept only while it adds no traffic (one thread).
+*/
+
+#include <string>
+#include <vector>
+
+// estimated cost of the CSC conversion, in bytes of matrix traffic per matrix byte
+#define TRANSPOSE_CONVERT_COST 4.0
+// columns reduced together by the private engine
+#define TRANSPOSE_TILE 512
+
+enum TransposeMethod {
+    TRANSPOSE_AUTO = 0,
+    TRANSPOSE_CSC,          // transpose once, forward kernel on A^T
+    TRANSPOSE_PRIVATE       // scatter into thread-private buffers + reduction
+};
+
+/**
+ * @brief Parses "auto", "csc" or "private"
+*/
+bool transpose_method_from_name(const std::string& name, TransposeMethod& method);
+
+/**
+ * @brief Name of a method, inverse of transpose_method_from_name()
+*/
+const char* transpose_method_name(TransposeMethod method);
+
+/**
+ * Transposed product, prepared once. The CSR arrays of A are borrowed;
+ * the CSC arrays and the private buffers are owned, so the kernel does
+ * not allocate.
+*/
+struct TransposePlan {
+    TransposeMethod method = TRANSPOSE_CSC;     // resolved (never AUTO after prepare)
+    int M = 0;
+    int N = 0;
+    int num_parts = 0;
+    const int* row_ptr = nullptr;
+    const int* col_idx = nullptr;
+    const double* values = nullptr;
+
+    // CSC: CSR arrays of A^T (rows sorted inside every column)
+    std::vector<int> col_ptr;                   // size = N+1
+    std::vector<int> row_idx;
+    std::vector<double> csc_values;
+
+    // private: row block, column range and buffer of every part
+    std::vector<int> row_start;                 // size = num_parts+1
+    std::vector<int> col_lo;                    // buffer of part t covers columns col_lo[t] .. col_hi[t]-1
+    std::vector<int> col_hi;
+    std::vector<long long> buf_start;           // offset of the buffer of part t in partial
+    std::vector<double> partial;
+
+    double private_bytes = 0.0;                 // extra traffic of the private engine per product
+    double setup_ms = 0.0;                      // conversion / partition time
+};
+
+/**
+ * @brief Parallel CSR -> CSC conversion (the CSR arrays of A^T)
+ *
+ * Every thread counts the columns of an nnz-balanced block of rows in a
+ * private histogram, the column counts are scanned into col_ptr and every
+ * thread scatters its rows through its own offsets, so the rows of each
+ * column come out sorted without atomics or a sort.
+ *
+ * @param col_ptr       [out] column pointers (size = N+1)
+ * @param row_idx       [out] row indices, increasing inside every column
+ * @param csc_values    [out] values
+*/
+void csr_to_csc_parallel(int M, int N, const int* row_ptr, const int* col_idx, const double* values,
+                         std::vector<int>& col_ptr, std::vector<int>& row_idx,
+                         std::vector<double>& csc_values);
+
+/**
+ * @brief Chooses the engine (if method is TRANSPOSE_AUTO) and builds it
+ *
+ * @param method            requested engine
+ * @param num_threads       number of threads the kernel will run with
+ * @param expected_iters    products the caller will run (0 = unbounded)
+ * @param plan              [out] prepared engine
+*/
+void transpose_prepare(TransposePlan& plan, TransposeMethod method, int num_threads, long long expected_iters,
+                       int M, int N, const int* row_ptr, const int* col_idx, const double* values);
+
+/**
+ * @brief y = alpha * A^T * x + beta * y (x of size M, y of size N)
+*/
+void spmv_transpose(TransposePlan& plan, double alpha, const double* x, double beta, double* y);
+
+/**
+ * @brief Frees the CSC arrays and the buffers, keeps the borrowed CSR pointers
+*/
+void transpose_release(TransposePlan& plan);
+
+#endif
@@ -0,0 +1,306 @@
+#include "../include/autotune.hpp"
+#include "../include/axpby.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <omp.h>
+
+// fraction of block rows scanned by the BCSR fill estimate
+#define AUTOTUNE_FILL_SAMPLE 0.05
+// SELL is not tried when stddev / mean of the row lengths is above this
+#define AUTOTUNE_SELL_MAX_CV 2.0
+
+static const char* const format_names[FORMAT_COUNT] = {"coo", "csr", "csr-merge", "sell", "bcsr"};
+
+const char* spmv_format_name(SpmvFormat format) {
+    return (format >= 0 && format < FORMAT_COUNT) ? format_names[format] : "unknown";
+}
+
+bool spmv_format_from_name(const std::string& name, SpmvFormat& format) {
+    for (int i = 0; i < FORMAT_COUNT; ++i) {
+        if (name == format_names[i]) {
+            format = static_cast<SpmvFormat>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void compute_features(int M, int N, const int* row_ptr, const int* col_idx, MatrixFeatures& f) {
+    f = MatrixFeatures();
+    f.M = M;
+    f.N = N;
+    f.nnz = M > 0 ? row_ptr[M] : 0;
+    if (M == 0) return;
+
+    f.row_mean = static_cast<double>(f.nnz) / M;
+
+    double var = 0.0;
+    int row_max = 0, empty_rows = 0, bandwidth = 0;
+    const double mean = f.row_mean;
+    #pragma omp parallel for schedule(static) reduction(+:var, empty_rows) reduction(max:row_max, bandwidth)
+    for (int r = 0; r < M; ++r) {
+        const int len = row_ptr[r + 1] - row_ptr[r];
+        var += (len - mean) * (len - mean);
+        row_max = std::max(row_max, len);
+        if (len == 0) {
+            empty_rows++;
+            continue;
+        }
+        // column indices are sorted: the extremes are the first and last entry
+        bandwidth = std::max(bandwidth, std::abs(r - col_idx[row_ptr[r]]));
+        bandwidth = std::max(bandwidth, std::abs(col_idx[row_ptr[r + 1] - 1] - r));
+    }
+    f.row_var = var / M;
+    f.row_max = row_max;
+    f.empty_rows = empty_rows;
+    f.bandwidth = bandwidth;
+
+    std::vector<double> fill;
+    bcsr_estimate_fill(M, N, row_ptr, col_idx, AUTOTUNE_FILL_SAMPLE, fill);
+    bcsr_select_block(fill, f.row_mean, f.block_r, f.block_c);
+    f.block_density = 1.0 / fill[(f.block_r - 1) * BCSR_MAX_BLOCK + (f.block_c - 1)];
+}
+
+uint64_t matrix_hash(int M, int N, const int* row_ptr, const int* col_idx) {
+    uint64_t h = 14695981039346656037ULL;
+    auto mix = [&h](uint32_t v) {
+        for (int b = 0; b < 4; ++b) {
+            h ^= (v >> (8 * b)) & 0xffu;
+            h *= 1099511628211ULL;
+        }
+    };
+    mix(static_cast<uint32_t>(M));
+    mix(static_cast<uint32_t>(N));
+    for (int r = 0; r <= M; ++r) mix(static_cast<uint32_t>(row_ptr[r]));
+    const int nnz = M > 0 ? row_ptr[M] : 0;
+    for (int k = 0; k < nnz; ++k) mix(static_cast<uint32_t>(col_idx[k]));
+    return h;
+}
+
+// ================= Tuning cache =================
+
+static bool parse_entry(const std::string& line, TuningEntry& e) {
+    if (line.empty() || line[0] == '#') return false;
+    std::istringstream in(line);
+    std::string hash_hex;
+    if (!(in >> hash_hex >> e.key >> e.threads >> e.kernel >> e.param1 >> e.param2 >> e.time_ms)) {
+        return false;
+    }
+    e.hash = std::strtoull(hash_hex.c_str(), nullptr, 16);
+    return true;
+}
+
+static std::string format_entry(const TuningEntry& e) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%016llx %s %d %s %d %d %.6f",
+                  static_cast<unsigned long long>(e.hash), e.key.c_str(), e.threads,
+                  e.kernel.c_str(), e.param1, e.param2, e.time_ms);
+    return line;
+}
+
+bool tuning_cache_lookup(const std::string& path, uint64_t hash, const std::string& key,
+                         int threads, TuningEntry& entry) {
+    std::ifstream in(path);
+    if (!in.is_open()) return false;
+
+    std::string line;
+    TuningEntry e;
+    while (std::getline(in, line)) {
+        if (parse_entry(line, e) && e.hash == hash && e.key == key && e.threads == threads) {
+            entry = e;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool tuning_cache_store(const std::string& path, const TuningEntry& entry) {
+    std::vector<std::string> lines;
+    {
+        std::ifstream in(path);
+        std::string line;
+        TuningEntry e;
+        while (std::getline(in, line)) {
+            if (parse_entry(line, e) && e.hash == entry.hash && e.key == entry.key &&
+                e.threads == entry.threads) {
+                continue;
+            }
+            if (!line.empty()) lines.push_back(line);
+        }
+    }
+    if (lines.empty()) {
+        lines.push_back("# hash key threads kernel param1 param2 time_ms");
+    }
+    lines.push_back(format_entry(entry));
+
+    std::ofstream out(path, std::ofstream::out | std::ofstream::trunc);
+    if (!out.is_open()) return false;
+    for (size_t i = 0; i < lines.size(); ++i) out << lines[i] << "\n";
+    return static_cast<bool>(out);
+}
+
+// ================= Dispatcher =================
+
+double dispatch_prepare(SpmvDispatch& d, SpmvFormat format, int param1, int param2, int num_threads,
+                        int M, int N, const int* row_ptr, const int* col_idx, const double* values) {
+    dispatch_release(d);
+    d.format = format;
+    d.M = M;
+    d.N = N;
+    d.row_ptr = row_ptr;
+    d.col_idx = col_idx;
+    d.values = values;
+    d.param1 = param1;
+    d.param2 = param2;
+
+    auto start = std::chrono::steady_clock::now();
+    switch (format) {
+        case FORMAT_COO: {
+            // CSR is already row-sorted COO: only the row array is missing
+            const int nnz = row_ptr[M];
+            d.row_coo.resize(nnz);
+            #pragma omp parallel for schedule(static)
+            for (int r = 0; r < M; ++r) {
+                for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) d.row_coo[k] = r;
+            }
+            coo_partition(M, nnz, d.row_coo.data(), num_threads, d.coo_plan);
+            break;
+        }
+        case FORMAT_CSR:
+            break;
+        case FORMAT_CSR_MERGE:
+            merge_path_partition(M, row_ptr, num_threads, d.merge_plan);
+            break;
+        case FORMAT_SELL:
+            if (d.param1 <= 0) d.param1 = SELL_DEFAULT_C;
+            if (d.param2 <= 0) d.param2 = SELL_DEFAULT_SIGMA;
+            csr_to_sell(M, N, row_ptr, col_idx, values, d.param1, d.param2, d.sell);
+            break;
+        case FORMAT_BCSR:
+            if (d.param1 <= 0 || d.param2 <= 0) {
+                std::vector<double> fill;
+                bcsr_estimate_fill(M, N, row_ptr, col_idx, AUTOTUNE_FILL_SAMPLE, fill);
+                bcsr_select_block(fill, M > 0 ? static_cast<double>(row_ptr[M]) / M : 0.0,
+                                  d.param1, d.param2);
+            }
+            csr_to_bcsr(M, N, row_ptr, col_idx, values, d.param1, d.param2, d.bcsr);
+            break;
+        default:
+            break;
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void dispatch_spmv(SpmvDispatch& d, const double* x, double* y) {
+    switch (d.format) {
+        case FORMAT_COO:
+            spmv_coo_parallel(d.coo_plan, d.M, d.row_coo.data(), d.col_idx, d.values, x, y);
+            break;
+        case FORMAT_CSR_MERGE:
+            spmv_csr_merge(d.merge_plan, d.M, d.row_ptr, d.col_idx, d.values, x, y);
+            break;
+        case FORMAT_SELL:
+            spmv_sell(d.sell, x, y);
+            break;
+        case FORMAT_BCSR:
+            spmv_bcsr(d.bcsr, x, y);
+            break;
+        case FORMAT_CSR:
+        default:
+            spmv_csr_axpby(d.M, d.row_ptr, d.col_idx, d.values, 1.0, x, 0.0, y, false);
+            break;
+    }
+}
+
+void dispatch_release(SpmvDispatch& d) {
+    std::vector<int>().swap(d.row_coo);
+    d.coo_plan = CooPlan();
+    d.merge_plan = MergePathPlan();
+    d.sell = SellMatrix();
+    d.bcsr = BcsrMatrix();
+}
+
+// ================= Search =================
+
+int autotune_search(int M, int N, const int* row_ptr, const int* col_idx, const double* values,
+                    const MatrixFeatures& f, int num_threads, int trial_iters, long long expected_iters,
+                    std::vector<TrialResult>& trials) {
+    if (trial_iters < 1) trial_iters = 1;
+    trials.assign(FORMAT_COUNT, TrialResult());
+
+    std::vector<double> x(N, 1.0), y(M, 0.0);
+    for (int j = 0; j < N; ++j) x[j] = 1.0 + (j % 7) * 0.125;
+
+    SpmvDispatch d;
+    for (int fi = 0; fi < FORMAT_COUNT; ++fi) {
+        TrialResult& t = trials[fi];
+        t.format = static_cast<SpmvFormat>(fi);
+        if (t.format == FORMAT_BCSR) {
+            t.param1 = f.block_r;
+            t.param2 = f.block_c;
+        }
+
+        // prune the candidates the features already rule out
+        if (t.format == FORMAT_BCSR && f.block_r * f.block_c == 1) {
+            t.skipped = true;
+            t.note = "no dense blocks (best shape 1x1)";
+            continue;
+        }
+        if (t.format == FORMAT_SELL && f.row_mean > 0.0 && std::sqrt(f.row_var) / f.row_mean > AUTOTUNE_SELL_MAX_CV) {
+            t.skipped = true;
+            t.note = "row lengths too irregular for padding";
+            continue;
+        }
+
+        t.convert_ms = dispatch_prepare(d, t.format, t.param1, t.param2, num_threads,
+                                        M, N, row_ptr, col_idx, values);
+        t.param1 = d.param1;
+        t.param2 = d.param2;
+
+        // one untimed run to fault in the converted arrays
+        dispatch_spmv(d, x.data(), y.data());
+        double best = 0.0;
+        for (int i = 0; i < trial_iters; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            dispatch_spmv(d, x.data(), y.data());
+            auto end = std::chrono::steady_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            if (i == 0 || ms < best) best = ms;
+        }
+        t.spmv_ms = best;
+    }
+    dispatch_release(d);
+
+    // break-even against plain CSR, which needs no conversion
+    const double csr_ms = trials[FORMAT_CSR].spmv_ms;
+    for (int fi = 0; fi < FORMAT_COUNT; ++fi) {
+        TrialResult& t = trials[fi];
+        if (t.skipped) continue;
+        if (t.convert_ms == 0.0 || fi == FORMAT_CSR) {
+            t.break_even = 0.0;
+        } else if (t.spmv_ms < csr_ms) {
+            t.break_even = std::ceil(t.convert_ms / (csr_ms - t.spmv_ms));
+        }
+    }
+
+    // CSR is never pruned, so there is always a winner
+    int winner = -1;
+    double best_cost = 0.0;
+    for (int fi = 0; fi < FORMAT_COUNT; ++fi) {
+        const TrialResult& t = trials[fi];
+        if (t.skipped) continue;
+        double cost = expected_iters > 0 ? t.convert_ms + expected_iters * t.spmv_ms : t.spmv_ms;
+        if (winner < 0 || cost < best_cost) {
+            best_cost = cost;
+            winner = fi;
+        }
+    }
+    return winner;
+}
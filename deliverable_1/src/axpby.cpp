@@ -0,0 +1,105 @@
+#include "../include/axpby.hpp"
+
+#include <omp.h>
+
+static const char* const store_names[] = {"auto", "regular", "streaming"};
+
+bool store_policy_from_name(const std::string& name, StorePolicy& policy) {
+    for (int i = 0; i <= STORES_STREAMING; ++i) {
+        if (name == store_names[i]) {
+            policy = static_cast<StorePolicy>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* store_policy_name(StorePolicy policy) {
+    return (policy >= STORES_AUTO && policy <= STORES_STREAMING) ? store_names[policy] : "unknown";
+}
+
+bool axpby_streaming(StorePolicy policy, int M) {
+    if (policy != STORES_AUTO) return policy == STORES_STREAMING;
+    static const long long llc = llc_total_bytes();
+    return llc > 0 && static_cast<long long>(M) * static_cast<long long>(sizeof(double)) > llc;
+}
+
+template <int MODE>
+static void csr_axpby_guided(int M, const int* __restrict__ row_ptr, const int* __restrict__ col_idx,
+                             const double* __restrict__ values, double alpha, const double* __restrict__ x,
+                             double beta, double* __restrict__ y) {
+    #pragma omp parallel
+    {
+        #pragma omp for schedule(guided, AXPBY_BLOCK_SIZE) nowait
+        for (int r = 0; r < M; ++r) {
+            double sum = 0.0;
+            #pragma omp simd reduction(+:sum)
+            for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+                sum += values[k] * x[col_idx[k]];
+            }
+            axpby_store_row<MODE>(y, r, alpha, sum, beta);
+        }
+        if (MODE == AXPBY_STREAM) axpby_store_fence();
+    }
+}
+
+template <int MODE>
+static void csr_axpby_numa(const NumaCsr& A, double alpha, const double* __restrict__ x, double beta,
+                           double* __restrict__ y, std::vector<double>* thread_ms) {
+    const int* __restrict__ row_ptr = A.row_ptr.data();
+    const int* __restrict__ col_idx = A.col_idx.data();
+    const double* __restrict__ values = A.values.data();
+
+    // with the full team part p runs on thread p (the one that first-touched it);
+    // a smaller team still covers every part
+    #pragma omp parallel num_threads(A.num_parts)
+    {
+        #pragma omp for schedule(static, 1) nowait
+        for (int p = 0; p < A.num_parts; ++p) {
+            const double start = thread_ms ? omp_get_wtime() : 0.0;
+            for (int r = A.row_start[p]; r < A.row_start[p + 1]; ++r) {
+                double sum = 0.0;
+                #pragma omp simd reduction(+:sum)
+                for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+                    sum += values[k] * x[col_idx[k]];
+                }
+                axpby_store_row<MODE>(y, r, alpha, sum, beta);
+            }
+            if (thread_ms) (*thread_ms)[p] = (omp_get_wtime() - start) * 1000.0;
+        }
+        if (MODE == AXPBY_STREAM) axpby_store_fence();
+    }
+}
+
+void spmv_csr_axpby(int M, const int* row_ptr, const int* col_idx, const double* values,
+                    double alpha, const double* x, double beta, double* y, bool streaming) {
+    if (beta != 0.0) {
+        csr_axpby_guided<AXPBY_UPDATE>(M, row_ptr, col_idx, values, alpha, x, beta, y);
+    } else if (streaming) {
+        csr_axpby_guided<AXPBY_STREAM>(M, row_ptr, col_idx, values, alpha, x, beta, y);
+    } else {
+        csr_axpby_guided<AXPBY_OVERWRITE>(M, row_ptr, col_idx, values, alpha, x, beta, y);
+    }
+}
+
+void spmv_csr_numa_axpby(const NumaCsr& A, double alpha, const double* x, double beta, double* y,
+                         bool streaming, std::vector<double>* thread_ms) {
+    if (thread_ms) thread_ms->assign(A.num_parts, 0.0);
+    if (beta != 0.0) {
+        csr_axpby_numa<AXPBY_UPDATE>(A, alpha, x, beta, y, thread_ms);
+    } else if (streaming) {
+        csr_axpby_numa<AXPBY_STREAM>(A, alpha, x, beta, y, thread_ms);
+    } else {
+        csr_axpby_numa<AXPBY_OVERWRITE>(A, alpha, x, beta, y, thread_ms);
+    }
+}
+
+void axpby_update(int M, double alpha, const double* __restrict__ t, double beta, double* __restrict__ y) {
+    if (beta == 0.0) {
+        #pragma omp parallel for simd schedule(static)
+        for (int r = 0; r < M; ++r) y[r] = alpha * t[r];
+    } else {
+        #pragma omp parallel for simd schedule(static)
+        for (int r = 0; r < M; ++r) y[r] = alpha * t[r] + beta * y[r];
+    }
+}
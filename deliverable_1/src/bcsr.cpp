@@ -0,0 +1,209 @@
+#include "../include/bcsr.hpp"
+
+#include <algorithm>
+#include <omp.h>
+
+#define BCSR_BLOCK_ROWS_PER_TASK 16
+
+void bcsr_estimate_fill(int M, int N, const int* row_ptr, const int* col_idx,
+                        double sample_fraction, std::vector<double>& fill) {
+    fill.assign(BCSR_MAX_BLOCK * BCSR_MAX_BLOCK, 1.0);
+    if (M == 0 || row_ptr[M] == 0) return;
+
+    int stride = 1;
+    if (sample_fraction > 0.0 && sample_fraction < 1.0) {
+        stride = static_cast<int>(1.0 / sample_fraction + 0.5);
+    }
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int r = 1; r <= BCSR_MAX_BLOCK; ++r) {
+        // one marker array per block width: marker[c-1][j / c] == stamp if already counted
+        std::vector<std::vector<int>> marker(BCSR_MAX_BLOCK);
+        for (int c = 1; c <= BCSR_MAX_BLOCK; ++c) {
+            marker[c - 1].assign(N / c + 1, -1);
+        }
+        long long blocks[BCSR_MAX_BLOCK] = {0};
+        long long sampled_nnz = 0;
+
+        const int mb = (M + r - 1) / r;
+        for (int ib = 0; ib < mb; ib += stride) {
+            const int row_begin = ib * r;
+            const int row_end = std::min(row_begin + r, M);
+            sampled_nnz += row_ptr[row_end] - row_ptr[row_begin];
+            for (int c = 1; c <= BCSR_MAX_BLOCK; ++c) {
+                std::vector<int>& mark = marker[c - 1];
+                for (int k = row_ptr[row_begin]; k < row_ptr[row_end]; ++k) {
+                    int jb = col_idx[k] / c;
+                    if (mark[jb] != ib) {
+                        mark[jb] = ib;
+                        blocks[c - 1]++;
+                    }
+                }
+            }
+        }
+
+        for (int c = 1; c <= BCSR_MAX_BLOCK; ++c) {
+            if (sampled_nnz > 0) {
+                fill[(r - 1) * BCSR_MAX_BLOCK + (c - 1)] =
+                    static_cast<double>(blocks[c - 1]) * r * c / sampled_nnz;
+            }
+        }
+    }
+}
+
+double bcsr_bytes_per_nnz(int r, int c, double fill, double nnz_per_row) {
+    double bytes = fill * (8.0 + 4.0 / (r * c));        // values + one index per block
+    if (nnz_per_row > 0.0) bytes += 4.0 / (r * nnz_per_row);   // block row pointer
+    return bytes;
+}
+
+void bcsr_select_block(const std::vector<double>& fill, double nnz_per_row, int& r, int& c) {
+    r = 1;
+    c = 1;
+    double best = bcsr_bytes_per_nnz(1, 1, fill[0], nnz_per_row);
+    for (int br = 1; br <= BCSR_MAX_BLOCK; ++br) {
+        for (int bc = 1; bc <= BCSR_MAX_BLOCK; ++bc) {
+            double bytes = bcsr_bytes_per_nnz(br, bc, fill[(br - 1) * BCSR_MAX_BLOCK + (bc - 1)], nnz_per_row);
+            // a bigger block must save at least 2% to pay for the extra flops
+            if (bytes < 0.98 * best) {
+                best = bytes;
+                r = br;
+                c = bc;
+            }
+        }
+    }
+}
+
+void csr_to_bcsr(int M, int N, const int* row_ptr, const int* col_idx,
+                 const double* values, int r, int c, BcsrMatrix& A) {
+    r = std::max(1, std::min(r, BCSR_MAX_BLOCK));
+    c = std::max(1, std::min(std::min(c, BCSR_MAX_BLOCK), std::max(N, 1)));
+
+    A.M = M;
+    A.N = N;
+    A.r = r;
+    A.c = c;
+    A.mb = (M + r - 1) / r;
+    A.nnz = row_ptr[M];
+    A.brow_ptr.assign(A.mb + 1, 0);
+
+    const int nbc = (N + c - 1) / c;           // number of aligned block columns
+    const int last_start = std::max(N - c, 0); // start of the (shifted) last block column
+
+    // ===== Pass 1: count distinct block columns per block row =====
+    #pragma omp parallel
+    {
+        std::vector<int> mark(nbc, -1);
+        #pragma omp for schedule(dynamic, BCSR_BLOCK_ROWS_PER_TASK)
+        for (int ib = 0; ib < A.mb; ++ib) {
+            const int row_end = std::min((ib + 1) * r, M);
+            int count = 0;
+            for (int k = row_ptr[ib * r]; k < row_ptr[row_end]; ++k) {
+                int jb = col_idx[k] / c;
+                if (mark[jb] != ib) {
+                    mark[jb] = ib;
+                    ++count;
+                }
+            }
+            A.brow_ptr[ib + 1] = count;
+        }
+    }
+    for (int ib = 0; ib < A.mb; ++ib) {
+        A.brow_ptr[ib + 1] += A.brow_ptr[ib];
+    }
+
+    const long long num_blocks = A.brow_ptr[A.mb];
+    A.bcol_idx.resize(num_blocks);
+    A.values.assign(num_blocks * r * c, 0.0);
+
+    // ===== Pass 2: sorted block columns, then scatter the values =====
+    #pragma omp parallel
+    {
+        std::vector<int> pos(nbc, -1);
+        std::vector<int> cols;
+        #pragma omp for schedule(dynamic, BCSR_BLOCK_ROWS_PER_TASK)
+        for (int ib = 0; ib < A.mb; ++ib) {
+            const int row_begin = ib * r;
+            const int row_end = std::min(row_begin + r, M);
+
+            cols.clear();
+            for (int k = row_ptr[row_begin]; k < row_ptr[row_end]; ++k) {
+                int jb = col_idx[k] / c;
+                if (pos[jb] < 0) {
+                    pos[jb] = 0;
+                    cols.push_back(jb);
+                }
+            }
+            std::sort(cols.begin(), cols.end());
+
+            const int base = A.brow_ptr[ib];
+            for (size_t b = 0; b < cols.size(); ++b) {
+                pos[cols[b]] = base + static_cast<int>(b);
+                A.bcol_idx[base + b] = std::min(cols[b] * c, last_start);
+            }
+
+            for (int i = row_begin; i < row_end; ++i) {
+                for (int k = row_ptr[i]; k < row_ptr[i + 1]; ++k) {
+                    int b = pos[col_idx[k] / c];
+                    int j = col_idx[k] - A.bcol_idx[b];
+                    // += so duplicate entries are summed like in the CSR kernel
+                    A.values[(static_cast<long long>(b) * r + (i - row_begin)) * c + j] += values[k];
+                }
+            }
+
+            for (size_t b = 0; b < cols.size(); ++b) pos[cols[b]] = -1;
+        }
+    }
+}
+
+// r x c known at compile time: both block loops are fully unrolled and the
+// r partial sums stay in registers.
+template <int R, int C>
+static void spmv_bcsr_fixed(const BcsrMatrix& A, const double* x, double* y) {
+    const int* __restrict__ brow_ptr = A.brow_ptr.data();
+    const int* __restrict__ bcol_idx = A.bcol_idx.data();
+    const double* __restrict__ vals = A.values.data();
+    const int M = A.M;
+
+    #pragma omp parallel for schedule(guided, BCSR_BLOCK_ROWS_PER_TASK)
+    for (int ib = 0; ib < A.mb; ++ib) {
+        double acc[R];
+        #pragma GCC unroll 8
+        for (int i = 0; i < R; ++i) acc[i] = 0.0;
+
+        for (int b = brow_ptr[ib]; b < brow_ptr[ib + 1]; ++b) {
+            const double* blk = vals + static_cast<long long>(b) * (R * C);
+            const double* xb = x + bcol_idx[b];
+            #pragma GCC unroll 8
+            for (int i = 0; i < R; ++i) {
+                #pragma GCC unroll 8
+                for (int j = 0; j < C; ++j) {
+                    acc[i] += blk[i * C + j] * xb[j];
+                }
+            }
+        }
+
+        const int row0 = ib * R;
+        if (row0 + R <= M) {
+            #pragma GCC unroll 8
+            for (int i = 0; i < R; ++i) y[row0 + i] = acc[i];
+        } else {
+            for (int i = 0; row0 + i < M; ++i) y[row0 + i] = acc[i];
+        }
+    }
+}
+
+typedef void (*BcsrKernel)(const BcsrMatrix&, const double*, double*);
+
+#define BCSR_ROW_KERNELS(R) \
+    { &spmv_bcsr_fixed<R, 1>, &spmv_bcsr_fixed<R, 2>, &spmv_bcsr_fixed<R, 3>, &spmv_bcsr_fixed<R, 4>, \
+      &spmv_bcsr_fixed<R, 5>, &spmv_bcsr_fixed<R, 6>, &spmv_bcsr_fixed<R, 7>, &spmv_bcsr_fixed<R, 8> }
+
+static const BcsrKernel bcsr_kernels[BCSR_MAX_BLOCK][BCSR_MAX_BLOCK] = {
+    BCSR_ROW_KERNELS(1), BCSR_ROW_KERNELS(2), BCSR_ROW_KERNELS(3), BCSR_ROW_KERNELS(4),
+    BCSR_ROW_KERNELS(5), BCSR_ROW_KERNELS(6), BCSR_ROW_KERNELS(7), BCSR_ROW_KERNELS(8)
+};
+
+void spmv_bcsr(const BcsrMatrix& A, const double* x, double* y) {
+    bcsr_kernels[A.r - 1][A.c - 1](A, x, y);
+}
@@ -0,0 +1,254 @@
+#include "../include/bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+// ================= Configuration =================
+
+BenchConfig bench_config_from_env(bool verbose) {
+    BenchConfig cfg;
+    cfg.verbose = verbose;
+    if (const char* s = getenv("SPMV_BENCH_CI")) cfg.ci_target = std::atof(s);
+    if (const char* s = getenv("SPMV_BENCH_MIN_SAMPLES")) cfg.min_samples = std::max(1, std::atoi(s));
+    if (const char* s = getenv("SPMV_BENCH_MAX_SAMPLES")) cfg.max_samples = std::max(1, std::atoi(s));
+    if (const char* s = getenv("SPMV_BENCH_MAX_TIME")) cfg.max_seconds = std::atof(s);
+    if (const char* s = getenv("SPMV_BENCH_CSV")) cfg.csv_path = s;
+    if (const char* s = getenv("SPMV_BENCH_JSON")) cfg.json_path = s;
+    cfg.max_samples = std::max(cfg.max_samples, cfg.min_samples);
+    return cfg;
+}
+
+// ================= Measurement =================
+
+static double time_once(const std::function<void()>& fn, const std::function<void()>& setup) {
+    if (setup) setup();
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int bench_warmup(const BenchConfig& cfg, const std::function<void()>& fn,
+                 const std::function<void()>& setup) {
+    std::vector<double> times;
+    double elapsed_ms = 0.0;
+    while (static_cast<int>(times.size()) < cfg.max_warmup) {
+        times.push_back(time_once(fn, setup));
+        elapsed_ms += times.back();
+        const int n = static_cast<int>(times.size());
+        if (n < cfg.min_warmup || n < cfg.warmup_window) continue;
+        // stable: the last window spreads by at most warmup_tol
+        auto first = times.end() - cfg.warmup_window;
+        const double lo = *std::min_element(first, times.end());
+        const double hi = *std::max_element(first, times.end());
+        if (hi - lo <= cfg.warmup_tol * lo) break;
+        if (elapsed_ms > 1000.0 * cfg.max_seconds) break;
+    }
+    return static_cast<int>(times.size());
+}
+
+// linear interpolation between order statistics (numpy's default)
+static double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    const double pos = q * (sorted.size() - 1);
+    const size_t i = static_cast<size_t>(pos);
+    if (i + 1 >= sorted.size()) return sorted.back();
+    return sorted[i] + (pos - i) * (sorted[i + 1] - sorted[i]);
+}
+
+// half-width of the 95% confidence interval of the median: order statistics
+// n/2 -+ 1.96 sqrt(n)/2 of the sorted samples
+static double median_ci(const std::vector<double>& sorted) {
+    const int n = static_cast<int>(sorted.size());
+    if (n < 2) return 0.0;
+    const double half = 0.98 * std::sqrt(static_cast<double>(n));
+    const int lo = std::max(0, static_cast<int>(std::floor(n / 2.0 - half)));
+    const int hi = std::min(n - 1, static_cast<int>(std::ceil(n / 2.0 + half)));
+    return 0.5 * (sorted[hi] - sorted[lo]);
+}
+
+void bench_compute_stats(BenchStats& stats) {
+    std::vector<double> sorted = stats.times_ms;
+    std::sort(sorted.begin(), sorted.end());
+    const int n = static_cast<int>(sorted.size());
+    stats.samples = n;
+    if (n == 0) return;
+
+    double sum = 0.0;
+    for (double t : sorted) sum += t;
+    stats.mean_ms = sum / n;
+    double var = 0.0;
+    for (double t : sorted) var += (t - stats.mean_ms) * (t - stats.mean_ms);
+    stats.stddev_ms = n > 1 ? std::sqrt(var / (n - 1)) : 0.0;
+
+    stats.min_ms = sorted.front();
+    stats.median_ms = percentile(sorted, 0.5);
+    stats.p90_ms = percentile(sorted, 0.9);
+    stats.p99_ms = percentile(sorted, 0.99);
+    stats.ci_ms = median_ci(sorted);
+}
+
+void bench_sample(const BenchConfig& cfg, const std::function<void()>& fn, BenchStats& stats,
+                  const std::function<void()>& setup) {
+    stats.times_ms.clear();
+    stats.converged = false;
+    double elapsed_ms = 0.0;
+    std::vector<double> sorted;
+
+    while (static_cast<int>(stats.times_ms.size()) < cfg.max_samples) {
+        const double ms = time_once(fn, setup);
+        if (cfg.verbose) {
+            std::cout << "Multiplication took " << ms << " ms" << std::endl;
+        }
+        stats.times_ms.push_back(ms);
+        elapsed_ms += ms;
+
+        const int n = static_cast<int>(stats.times_ms.size());
+        if (n < cfg.min_samples) continue;
+        sorted = stats.times_ms;
+        std::sort(sorted.begin(), sorted.end());
+        if (median_ci(sorted) <= cfg.ci_target * percentile(sorted, 0.5)) {
+            stats.converged = true;
+            break;
+        }
+        if (elapsed_ms > 1000.0 * cfg.max_seconds) break;
+    }
+    bench_compute_stats(stats);
+}
+
+// ================= Records =================
+
+std::string bench_host_name() {
+    char buf[256] = {0};
+    if (gethostname(buf, sizeof(buf) - 1) != 0) return "unknown";
+    return buf;
+}
+
+static std::string git_revision() {
+    static std::string rev;
+    if (!rev.empty()) return rev;
+    if (const char* s = getenv("SPMV_GIT_REV")) {
+        rev = s;
+        return rev;
+    }
+    rev = "unknown";
+    if (FILE* p = popen("git describe --always --dirty 2>/dev/null", "r")) {
+        char buf[128] = {0};
+        if (fgets(buf, sizeof(buf), p)) {
+            std::string s(buf);
+            s.erase(s.find_last_not_of(" \n\r\t") + 1);
+            if (!s.empty()) rev = s;
+        }
+        pclose(p);
+    }
+    return rev;
+}
+
+static std::string utc_timestamp() {
+    std::time_t now = std::time(nullptr);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buf;
+}
+
+static std::string csv_field(const std::string& s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) return s;
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+static std::string json_string(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+static bool file_is_empty(const std::string& path) {
+    std::ifstream in(path);
+    return !in.is_open() || in.peek() == std::ifstream::traits_type::eof();
+}
+
+bool bench_record(const BenchConfig& cfg, const std::string& bench, const std::string& matrix,
+                  const std::string& kernel, int threads, const BenchStats& stats) {
+    const std::string host = bench_host_name(), rev = git_revision(), when = utc_timestamp();
+    bool ok = true;
+
+    if (!cfg.csv_path.empty()) {
+        const bool header = file_is_empty(cfg.csv_path);
+        std::ofstream out(cfg.csv_path, std::ios_base::app);
+        if (!out.is_open()) {
+            std::cerr << "Warning: unable to open " << cfg.csv_path << " for writing\n";
+            ok = false;
+        } else {
+            if (header) {
+                out << "timestamp,host,git_rev,bench,matrix,kernel,threads,warmup,samples,converged,"
+                    << "min_ms,median_ms,mean_ms,p90_ms,p99_ms,stddev_ms,ci95_ms\n";
+            }
+            char nums[256];
+            std::snprintf(nums, sizeof(nums), "%d,%d,%d,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f",
+                          threads, stats.warmup_iters, stats.samples, stats.converged ? 1 : 0,
+                          stats.min_ms, stats.median_ms, stats.mean_ms, stats.p90_ms, stats.p99_ms,
+                          stats.stddev_ms, stats.ci_ms);
+            out << when << ',' << csv_field(host) << ',' << csv_field(rev) << ',' << csv_field(bench) << ','
+                << csv_field(matrix) << ',' << csv_field(kernel) << ',' << nums << "\n";
+        }
+    }
+
+    if (!cfg.json_path.empty()) {
+        std::ofstream out(cfg.json_path, std::ios_base::app);
+        if (!out.is_open()) {
+            std::cerr << "Warning: unable to open " << cfg.json_path << " for writing\n";
+            ok = false;
+        } else {
+            std::ostringstream rec;
+            rec.precision(9);
+            rec << "{\"timestamp\":" << json_string(when) << ",\"host\":" << json_string(host)
+                << ",\"git_rev\":" << json_string(rev) << ",\"bench\":" << json_string(bench)
+                << ",\"matrix\":" << json_string(matrix) << ",\"kernel\":" << json_string(kernel)
+                << ",\"threads\":" << threads << ",\"warmup\":" << stats.warmup_iters
+                << ",\"samples\":" << stats.samples << ",\"converged\":" << (stats.converged ? "true" : "false")
+                << ",\"min_ms\":" << stats.min_ms << ",\"median_ms\":" << stats.median_ms
+                << ",\"mean_ms\":" << stats.mean_ms << ",\"p90_ms\":" << stats.p90_ms
+                << ",\"p99_ms\":" << stats.p99_ms << ",\"stddev_ms\":" << stats.stddev_ms
+                << ",\"ci95_ms\":" << stats.ci_ms << ",\"times_ms\":[";
+            for (size_t i = 0; i < stats.times_ms.size(); ++i) {
+                rec << (i ? "," : "") << stats.times_ms[i];
+            }
+            rec << "]}";
+            out << rec.str() << "\n";
+        }
+    }
+    return ok;
+}
+
+std::string bench_summary(const BenchStats& stats) {
+    char buf[256];
+    std::snprintf(buf, sizeof(buf), "median %.3f ms (min %.3f, p90 %.3f, +-%.1f%%, %d samples%s)",
+                  stats.median_ms, stats.min_ms, stats.p90_ms,
+                  stats.median_ms > 0.0 ? 100.0 * stats.ci_ms / stats.median_ms : 0.0, stats.samples,
+                  stats.converged ? "" : ", not converged");
+    return buf;
+}
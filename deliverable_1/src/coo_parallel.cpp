@@ -0,0 +1,140 @@
+#include "../include/coo_parallel.hpp"
+
+#include <algorithm>
+#include <omp.h>
+
+// entries multiplied per SIMD block before the segmented sum
+#define COO_SIMD_BLOCK 64
+
+void coo_sort_by_row(int M, int nz, std::vector<int>& row_coo, std::vector<int>& col_coo,
+                     std::vector<double>& val_coo) {
+    std::vector<int> offset(M + 1, 0);
+    for (int i = 0; i < nz; ++i) offset[row_coo[i] + 1]++;
+    for (int r = 0; r < M; ++r) offset[r + 1] += offset[r];
+
+    std::vector<int> sorted_col(nz);
+    std::vector<double> sorted_val(nz);
+    for (int i = 0; i < nz; ++i) {
+        int dest = offset[row_coo[i]]++;
+        sorted_col[dest] = col_coo[i];
+        sorted_val[dest] = val_coo[i];
+    }
+
+    // offset[r] is now the end of row r: rebuild the row array
+    #pragma omp parallel for schedule(static)
+    for (int r = 0; r < M; ++r) {
+        int begin = (r == 0) ? 0 : offset[r - 1];
+        for (int i = begin; i < offset[r]; ++i) row_coo[i] = r;
+    }
+    col_coo.swap(sorted_col);
+    val_coo.swap(sorted_val);
+}
+
+void coo_partition(int M, int nz, const int* row_coo, int num_parts, CooPlan& plan) {
+    if (num_parts < 1) num_parts = 1;
+
+    plan.num_parts = num_parts;
+    plan.nz_start.resize(num_parts + 1);
+    plan.first_row.assign(num_parts, -1);
+    plan.last_row.assign(num_parts, -1);
+    plan.zero_end.assign(num_parts, 0);
+    plan.carry_first.assign(num_parts, 0.0);
+    plan.carry_last.assign(num_parts, 0.0);
+
+    for (int p = 0; p <= num_parts; ++p) {
+        plan.nz_start[p] = static_cast<int>(static_cast<long long>(nz) * p / num_parts);
+    }
+    for (int p = 0; p < num_parts; ++p) {
+        if (plan.nz_start[p] < plan.nz_start[p + 1]) {
+            plan.first_row[p] = row_coo[plan.nz_start[p]];
+            plan.last_row[p] = row_coo[plan.nz_start[p + 1] - 1];
+        }
+    }
+
+    // empty rows after each chunk, up to the first row of the next non-empty chunk
+    int next_first = M;
+    for (int p = num_parts - 1; p >= 0; --p) {
+        plan.zero_end[p] = next_first;
+        if (plan.first_row[p] >= 0) next_first = plan.first_row[p];
+    }
+    // rows before the very first entry are zeroed by the fix-up
+}
+
+void spmv_coo_parallel(CooPlan& plan, int M,
+                       const int* row_coo, const int* col_coo, const double* val_coo,
+                       const double* x, double* y) {
+    const int num_parts = plan.num_parts;
+
+    #pragma omp parallel for schedule(static, 1)
+    for (int p = 0; p < num_parts; ++p) {
+        const int k_begin = plan.nz_start[p];
+        const int k_end = plan.nz_start[p + 1];
+        if (k_begin == k_end) continue;
+
+        const int first = plan.first_row[p];
+        double prod[COO_SIMD_BLOCK];
+        int cur_row = first;
+        double sum = 0.0;
+        bool first_segment = true;
+
+        for (int b = k_begin; b < k_end; b += COO_SIMD_BLOCK) {
+            const int len = std::min(COO_SIMD_BLOCK, k_end - b);
+
+            // vectorised products (gather on x)
+            #pragma omp simd
+            for (int i = 0; i < len; ++i) {
+                prod[i] = val_coo[b + i] * x[col_coo[b + i]];
+            }
+
+            // segmented sum: flush every time the row changes
+            for (int i = 0; i < len; ++i) {
+                const int r = row_coo[b + i];
+                if (r != cur_row) {
+                    if (first_segment) {
+                        plan.carry_first[p] = sum;
+                        first_segment = false;
+                    } else {
+                        y[cur_row] = sum;
+                    }
+                    // rows without entries inside the chunk
+                    for (int z = cur_row + 1; z < r; ++z) y[z] = 0.0;
+                    cur_row = r;
+                    sum = 0.0;
+                }
+                sum += prod[i];
+            }
+        }
+
+        // last segment: may continue in the next chunk
+        if (first_segment) {
+            plan.carry_first[p] = sum;
+            plan.carry_last[p] = 0.0;
+        } else {
+            plan.carry_last[p] = sum;
+        }
+        for (int z = plan.last_row[p] + 1; z < plan.zero_end[p]; ++z) y[z] = 0.0;
+    }
+
+    // ===== Boundary fix-up =====
+    int lead = M;
+    for (int p = 0; p < num_parts; ++p) {
+        if (plan.first_row[p] >= 0) {
+            lead = plan.first_row[p];
+            break;
+        }
+    }
+    for (int z = 0; z < lead; ++z) y[z] = 0.0;
+
+    for (int p = 0; p < num_parts; ++p) {
+        if (plan.first_row[p] < 0) continue;
+        y[plan.first_row[p]] = 0.0;
+        y[plan.last_row[p]] = 0.0;
+    }
+    for (int p = 0; p < num_parts; ++p) {
+        if (plan.first_row[p] < 0) continue;
+        y[plan.first_row[p]] += plan.carry_first[p];
+        if (plan.last_row[p] != plan.first_row[p]) {
+            y[plan.last_row[p]] += plan.carry_last[p];
+        }
+    }
+}
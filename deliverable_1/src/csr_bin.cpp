@@ -0,0 +1,280 @@
+#include "../include/csr_bin.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(sizeof(CsrBinHeader) == 128, "CsrBinHeader must stay 128 bytes");
+
+static const uint64_t FNV_OFFSET = 1469598103934665603ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+static inline uint64_t align_up(uint64_t n) {
+    return (n + CSRBIN_ALIGN - 1) / CSRBIN_ALIGN * CSRBIN_ALIGN;
+}
+
+/*
+ * FNV-1a over 64-bit little-endian words of a byte stream; a trailing
+ * partial word is padded with zeros. Fed in pieces by the writer and in one
+ * go over the mapping by the reader, both give the same value.
+*/
+struct WordHasher {
+    uint64_t h = FNV_OFFSET;
+    unsigned char tail[8];
+    size_t tail_len = 0;
+
+    void add(const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        while (bytes > 0 && tail_len > 0) {
+            tail[tail_len++] = *p++;
+            --bytes;
+            if (tail_len == 8) flush();
+        }
+        for (; bytes >= 8; p += 8, bytes -= 8) {
+            uint64_t w;
+            std::memcpy(&w, p, 8);
+            h = (h ^ w) * FNV_PRIME;
+        }
+        for (; bytes > 0; --bytes) tail[tail_len++] = *p++;
+    }
+    void flush() {
+        if (tail_len == 0) return;
+        std::memset(tail + tail_len, 0, 8 - tail_len);
+        uint64_t w;
+        std::memcpy(&w, tail, 8);
+        h = (h ^ w) * FNV_PRIME;
+        tail_len = 0;
+    }
+    uint64_t value() {
+        flush();
+        return h;
+    }
+};
+
+LoadedCsr::~LoadedCsr() {
+    if (map_base != nullptr) {
+        munmap(map_base, map_size);
+    }
+}
+
+bool csr_bin_is_file(const std::string& filename) {
+    char magic[8] = {0};
+    FILE* f = fopen(filename.c_str(), "rb");
+    if (f == nullptr) return false;
+    const bool ok = fread(magic, 1, sizeof(magic), f) == sizeof(magic);
+    fclose(f);
+    return ok && std::memcmp(magic, CSRBIN_MAGIC, sizeof(magic)) == 0;
+}
+
+bool csr_bin_write(const std::string& filename, int M, int N, const int* row_ptr,
+                   const int* col_idx, const double* values, CsrBinSymmetry symmetry,
+                   CsrBinHeader* header_out) {
+    const int64_t nnz = row_ptr[M];
+
+    CsrBinHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, CSRBIN_MAGIC, sizeof(CSRBIN_MAGIC));
+    h.version = CSRBIN_VERSION;
+    h.index_width = sizeof(int);
+    h.value_width = sizeof(double);
+    h.symmetry = symmetry;
+    h.M = M;
+    h.N = N;
+    h.nnz = nnz;
+    h.row_ptr_offset = align_up(sizeof(CsrBinHeader));
+    h.col_idx_offset = align_up(h.row_ptr_offset + (M + 1) * sizeof(int));
+    h.values_offset = align_up(h.col_idx_offset + nnz * sizeof(int));
+    h.file_size = align_up(h.values_offset + nnz * sizeof(double));
+
+    // structural stats
+    h.row_min = M > 0 ? nnz : 0;
+    for (int r = 0; r < M; ++r) {
+        const int len = row_ptr[r + 1] - row_ptr[r];
+        h.row_min = std::min(h.row_min, len);
+        h.row_max = std::max(h.row_max, len);
+        if (len == 0) h.empty_rows++;
+        for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+            h.bandwidth = std::max<int64_t>(h.bandwidth, std::abs(r - col_idx[k]));
+            if (col_idx[k] == r) h.diagonal++;
+        }
+    }
+
+    FILE* f = fopen(filename.c_str(), "wb");
+    if (f == nullptr) {
+        std::cerr << "Could not open file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    // sections with zero padding up to the next offset, hashed as they are written
+    static const char zeros[CSRBIN_ALIGN] = {0};
+    WordHasher hasher;
+    uint64_t pos = 0;
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    pos += sizeof(h);
+    auto emit = [&](const void* data, uint64_t bytes, uint64_t next_offset) {
+        if (bytes > 0) {
+            ok = ok && fwrite(data, 1, bytes, f) == bytes;
+            hasher.add(data, bytes);
+        }
+        pos += bytes;
+        const uint64_t pad = next_offset - pos;
+        ok = ok && fwrite(zeros, 1, pad, f) == pad;
+        hasher.add(zeros, pad);
+        pos = next_offset;
+    };
+    ok = ok && fwrite(zeros, 1, h.row_ptr_offset - pos, f) == h.row_ptr_offset - pos;
+    pos = h.row_ptr_offset;
+    emit(row_ptr, (M + 1) * sizeof(int), h.col_idx_offset);
+    emit(col_idx, nnz * sizeof(int), h.values_offset);
+    emit(values, nnz * sizeof(double), h.file_size);
+
+    // header again, now with the checksum
+    h.checksum = hasher.value();
+    ok = ok && fseek(f, 0, SEEK_SET) == 0 && fwrite(&h, sizeof(h), 1, f) == 1;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        std::cerr << "Error writing " << filename << std::endl;
+        return false;
+    }
+    if (header_out != nullptr) *header_out = h;
+    return true;
+}
+
+// checksum of the sections of a mapping with a validated header
+static uint64_t section_checksum(const void* map_base, const CsrBinHeader& h) {
+    WordHasher hasher;
+    hasher.add(static_cast<const char*>(map_base) + h.row_ptr_offset, h.file_size - h.row_ptr_offset);
+    return hasher.value();
+}
+
+uint64_t csr_bin_checksum(const LoadedCsr& A) {
+    return section_checksum(A.map_base, A.header);
+}
+
+// row_ptr non-decreasing, columns in [0, N) and sorted inside every row:
+// what the kernels index with, checked in one parallel pass over the rows
+static const char* check_structure(int M, int N, int nnz, const int* row_ptr, const int* col_idx) {
+    int bad_rows = 0, bad_cols = 0, unsorted = 0;
+    #pragma omp parallel for schedule(static) reduction(+:bad_rows, bad_cols, unsorted)
+    for (int r = 0; r < M; ++r) {
+        const int begin = row_ptr[r], end = row_ptr[r + 1];
+        if (begin > end || begin < 0 || end > nnz) {
+            bad_rows++;
+            continue;
+        }
+        for (int k = begin; k < end; ++k) {
+            if (col_idx[k] < 0 || col_idx[k] >= N) bad_cols++;
+            else if (k > begin && col_idx[k] < col_idx[k - 1]) unsorted++;
+        }
+    }
+    if (bad_rows > 0) return "row_ptr is not monotone";
+    if (bad_cols > 0) return "column index out of range";
+    if (unsorted > 0) return "column indices not sorted inside a row";
+    return nullptr;
+}
+
+bool csr_bin_map(const std::string& filename, LoadedCsr& A, bool verify) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Could not open file: " << filename << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CsrBinHeader)) {
+        std::cerr << "Not a binary CSR file: " << filename << std::endl;
+        close(fd);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "Could not map file: " << filename << std::endl;
+        return false;
+    }
+
+    CsrBinHeader h;
+    std::memcpy(&h, base, sizeof(h));
+    const char* error = nullptr;
+    if (std::memcmp(h.magic, CSRBIN_MAGIC, sizeof(h.magic)) != 0) {
+        error = "bad magic";
+    } else if (h.version != CSRBIN_VERSION) {
+        error = "unsupported version";
+    } else if (h.index_width != sizeof(int) || h.value_width != sizeof(double)) {
+        error = "unsupported index/value width";
+    } else if (h.M < 0 || h.N < 0 || h.nnz < 0 || h.M > 0x7fffffff || h.N > 0x7fffffff || h.nnz > 0x7fffffff) {
+        error = "dimensions do not fit in int";
+    } else if (h.file_size != size
+               || h.row_ptr_offset % CSRBIN_ALIGN || h.col_idx_offset % CSRBIN_ALIGN || h.values_offset % CSRBIN_ALIGN
+               || h.row_ptr_offset < sizeof(CsrBinHeader)
+               || h.row_ptr_offset + (h.M + 1) * sizeof(int) > h.col_idx_offset
+               || h.col_idx_offset + h.nnz * sizeof(int) > h.values_offset
+               || h.values_offset + h.nnz * sizeof(double) > h.file_size) {
+        error = "truncated file or bad section offsets";
+    }
+    const char* bytes = static_cast<const char*>(base);
+    if (error == nullptr) {
+        const int* row_ptr = reinterpret_cast<const int*>(bytes + h.row_ptr_offset);
+        if (row_ptr[0] != 0 || row_ptr[h.M] != h.nnz) error = "row_ptr does not match nnz";
+    }
+    if (error == nullptr && verify && section_checksum(base, h) != h.checksum) {
+        error = "checksum mismatch";
+    }
+    if (error == nullptr) {
+        error = check_structure(static_cast<int>(h.M), static_cast<int>(h.N), static_cast<int>(h.nnz),
+                                reinterpret_cast<const int*>(bytes + h.row_ptr_offset),
+                                reinterpret_cast<const int*>(bytes + h.col_idx_offset));
+    }
+    if (error != nullptr) {
+        std::cerr << "Invalid binary CSR file " << filename << ": " << error << std::endl;
+        munmap(base, size);
+        return false;
+    }
+
+    if (A.map_base != nullptr) munmap(A.map_base, A.map_size);
+    A.mapped = true;
+    A.header = h;
+    A.map_base = base;
+    A.map_size = size;
+    A.M = static_cast<int>(h.M);
+    A.N = static_cast<int>(h.N);
+    A.nnz = static_cast<int>(h.nnz);
+    A.row_ptr = reinterpret_cast<const int*>(bytes + h.row_ptr_offset);
+    A.col_idx = reinterpret_cast<const int*>(bytes + h.col_idx_offset);
+    A.values = reinterpret_cast<const double*>(bytes + h.values_offset);
+    return true;
+}
+
+bool load_csr(const std::string& filename, LoadedCsr& A, MtxLoadStats* load_stats) {
+    if (csr_bin_is_file(filename)) {
+        auto start = std::chrono::steady_clock::now();
+        if (!csr_bin_map(filename, A)) {
+            return false;
+        }
+        if (load_stats != nullptr) {
+            load_stats->data_bytes = A.map_size;
+            load_stats->threads = 1;
+            load_stats->parse_ms = 0.0;
+            load_stats->total_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+        return true;
+    }
+
+    if (!read_matrix_market(filename, A.M, A.N, A.nnz, A.row_ptr_store, A.col_idx_store,
+                            A.values_store, nullptr, load_stats)) {
+        return false;
+    }
+    A.mapped = false;
+    A.row_ptr = A.row_ptr_store.data();
+    A.col_idx = A.col_idx_store.data();
+    A.values = A.values_store.data();
+    return true;
+}
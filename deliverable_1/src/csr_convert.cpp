@@ -0,0 +1,195 @@
+#include "../include/csr_convert.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <omp.h>
+
+// below this many elements the scan is done by one thread
+#define SCAN_SERIAL_LIMIT (1 << 15)
+
+void exclusive_scan_parallel(int n, const int* in, int* out) {
+    if (n < SCAN_SERIAL_LIMIT || omp_get_max_threads() == 1) {
+        int run = 0;
+        for (int i = 0; i < n; ++i) {
+            out[i] = run;
+            run += in[i];
+        }
+        out[n] = run;
+        return;
+    }
+
+    // every thread sums its block, the block sums are scanned, then every
+    // thread writes its block starting from its offset
+    std::vector<int> block_sum(omp_get_max_threads() + 1, 0);
+    #pragma omp parallel
+    {
+        const int t = omp_get_thread_num();
+        const int nt = omp_get_num_threads();
+        const int begin = static_cast<int>(static_cast<long long>(n) * t / nt);
+        const int end = static_cast<int>(static_cast<long long>(n) * (t + 1) / nt);
+        int sum = 0;
+        for (int i = begin; i < end; ++i) sum += in[i];
+        block_sum[t + 1] = sum;
+        #pragma omp barrier
+        #pragma omp single
+        {
+            for (int b = 0; b < nt; ++b) block_sum[b + 1] += block_sum[b];
+        }
+        int run = block_sum[t];
+        for (int i = begin; i < end; ++i) {
+            out[i] = run;
+            run += in[i];
+        }
+        if (t == nt - 1) out[n] = run;
+    }
+}
+
+int coo_to_csr_parallel(int M, int nz, const int* row_coo, const int* col_coo, const double* val_coo,
+                        std::vector<int>& row_ptr, std::vector<int>& col_idx,
+                        std::vector<double>& values) {
+    row_ptr.resize(M + 1);
+    col_idx.resize(nz);
+    values.resize(nz);
+    if (M == 0) {
+        row_ptr[0] = 0;
+        return 0;
+    }
+
+    // one entry block (and one M-sized histogram) per part
+    const long long hist_cap = static_cast<long long>(CSR_CONVERT_HIST_RATIO) * 2 * nz / M;
+    const int num_parts = static_cast<int>(std::max(1LL, std::min<long long>(omp_get_max_threads(), hist_cap)));
+    std::unique_ptr<int[]> hist(new int[static_cast<size_t>(num_parts) * M]);
+    std::unique_ptr<int[]> counts(new int[M]);
+
+    auto block_begin = [&](int b) {
+        return static_cast<int>(static_cast<long long>(nz) * b / num_parts);
+    };
+
+    // 1. private histograms of the row indices
+    #pragma omp parallel for schedule(static, 1)
+    for (int b = 0; b < num_parts; ++b) {
+        int* h = hist.get() + static_cast<size_t>(b) * M;
+        std::fill(h, h + M, 0);
+        for (int k = block_begin(b); k < block_begin(b + 1); ++k) {
+            h[row_coo[k]]++;
+        }
+    }
+
+    // 2. row lengths and their exclusive scan
+    #pragma omp parallel for schedule(static)
+    for (int r = 0; r < M; ++r) {
+        int c = 0;
+        for (int b = 0; b < num_parts; ++b) c += hist[static_cast<size_t>(b) * M + r];
+        counts[r] = c;
+    }
+    exclusive_scan_parallel(M, counts.get(), row_ptr.data());
+
+    // 3. histograms -> write offsets of every part inside every row
+    #pragma omp parallel for schedule(static)
+    for (int r = 0; r < M; ++r) {
+        int offset = row_ptr[r];
+        for (int b = 0; b < num_parts; ++b) {
+            int& h = hist[static_cast<size_t>(b) * M + r];
+            const int c = h;
+            h = offset;
+            offset += c;
+        }
+    }
+
+    // 4. stable scatter: every part fills its own slots in input order
+    #pragma omp parallel for schedule(static, 1)
+    for (int b = 0; b < num_parts; ++b) {
+        int* h = hist.get() + static_cast<size_t>(b) * M;
+        for (int k = block_begin(b); k < block_begin(b + 1); ++k) {
+            const int dest = h[row_coo[k]]++;
+            col_idx[dest] = col_coo[k];
+            values[dest] = val_coo[k];
+        }
+    }
+
+    return csr_sort_and_merge(M, row_ptr, col_idx, values);
+}
+
+int csr_sort_and_merge(int M, std::vector<int>& row_ptr, std::vector<int>& col_idx,
+                       std::vector<double>& values) {
+    std::unique_ptr<int[]> row_len(new int[M > 0 ? M : 1]);
+    int* cols = col_idx.data();
+    double* vals = values.data();
+
+    #pragma omp parallel
+    {
+        std::vector<std::pair<int, double> > buf;
+        #pragma omp for schedule(dynamic, 256)
+        for (int r = 0; r < M; ++r) {
+            const int begin = row_ptr[r];
+            const int end = row_ptr[r + 1];
+
+            bool sorted = true;
+            for (int k = begin + 1; k < end && sorted; ++k) {
+                sorted = cols[k - 1] <= cols[k];
+            }
+            if (!sorted && end - begin <= CSR_CONVERT_INSERTION_SORT) {
+                for (int k = begin + 1; k < end; ++k) {
+                    const int c = cols[k];
+                    const double v = vals[k];
+                    int j = k - 1;
+                    for (; j >= begin && cols[j] > c; --j) {
+                        cols[j + 1] = cols[j];
+                        vals[j + 1] = vals[j];
+                    }
+                    cols[j + 1] = c;
+                    vals[j + 1] = v;
+                }
+            } else if (!sorted) {
+                buf.clear();
+                for (int k = begin; k < end; ++k) buf.push_back(std::make_pair(cols[k], vals[k]));
+                // stable: duplicates stay in input order, so their sum is deterministic
+                std::stable_sort(buf.begin(), buf.end(),
+                                 [](const std::pair<int, double>& a, const std::pair<int, double>& b) {
+                                     return a.first < b.first;
+                                 });
+                for (int k = begin; k < end; ++k) {
+                    cols[k] = buf[k - begin].first;
+                    vals[k] = buf[k - begin].second;
+                }
+            }
+
+            // sum runs of equal columns into their first entry
+            int w = begin;
+            for (int k = begin; k < end; ++k) {
+                if (w > begin && cols[w - 1] == cols[k]) {
+                    vals[w - 1] += vals[k];
+                } else {
+                    cols[w] = cols[k];
+                    vals[w] = vals[k];
+                    ++w;
+                }
+            }
+            row_len[r] = w - begin;
+        }
+    }
+
+    int merged_nz = 0;
+    #pragma omp parallel for reduction(+:merged_nz)
+    for (int r = 0; r < M; ++r) merged_nz += row_len[r];
+    if (merged_nz == row_ptr[M]) {
+        return merged_nz;
+    }
+
+    // duplicates were merged: close the gaps (into new arrays, rows move left
+    // across the boundaries of other threads)
+    std::vector<int> new_row_ptr(M + 1);
+    exclusive_scan_parallel(M, row_len.get(), new_row_ptr.data());
+    std::vector<int> new_col_idx(merged_nz);
+    std::vector<double> new_values(merged_nz);
+    #pragma omp parallel for schedule(static)
+    for (int r = 0; r < M; ++r) {
+        std::copy(cols + row_ptr[r], cols + row_ptr[r] + row_len[r], new_col_idx.begin() + new_row_ptr[r]);
+        std::copy(vals + row_ptr[r], vals + row_ptr[r] + row_len[r], new_values.begin() + new_row_ptr[r]);
+    }
+    row_ptr.swap(new_row_ptr);
+    col_idx.swap(new_col_idx);
+    values.swap(new_values);
+    return merged_nz;
+}
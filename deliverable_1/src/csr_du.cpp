@@ -0,0 +1,188 @@
+#include "../include/csr_du.hpp"
+
+#include <iostream>
+#include <omp.h>
+
+#define CSRDU_BLOCK_SIZE 10
+
+static inline uint32_t zigzag(int v) {
+    return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+}
+
+static inline int unzigzag(uint32_t u) {
+    return static_cast<int>(u >> 1) ^ -static_cast<int>(u & 1);
+}
+
+// Entries from k that fit an 8-bit unit
+static int run8(const int* col_idx, int k, int end) {
+    const int base = col_idx[k];
+    int e = k;
+    while (e < end && e - k < CSRDU_MAX_UNIT && col_idx[e] - base < 256) ++e;
+    return e - k;
+}
+
+// Encodes the columns of one row; with out == nullptr only counts the bytes.
+// Returns the size of the row, padded to an even number of bytes.
+static long long encode_row(const int* col_idx, int begin, int end, int r, uint8_t* out,
+                            long long& units, long long& units8) {
+    long long pos = 0;
+    int prev = r;
+    for (int k = begin; k < end;) {
+        const int base = col_idx[k];
+        int len = run8(col_idx, k, end);
+        bool wide = false;
+        if (len < CSRDU_MIN_UNIT8 && k + len < end) {
+            // 16-bit unit, up to the first 8-bit run worth a unit of its own
+            int e = k + 1;
+            while (e < end && e - k < CSRDU_MAX_UNIT && col_idx[e] - base < 65536 &&
+                   run8(col_idx, e, end) < CSRDU_MIN_UNIT8) {
+                ++e;
+            }
+            if (e - k > len) {
+                wide = true;
+                len = e - k;
+            }
+        }
+
+        // header: length - 1, bit 7 = 16-bit offsets
+        if (out) out[pos] = static_cast<uint8_t>((len - 1) | (wide ? 0x80 : 0x00));
+        pos++;
+        // base column, zigzag LEB128 delta from the previous column
+        uint32_t v = zigzag(base - prev);
+        do {
+            uint8_t byte = v & 0x7f;
+            v >>= 7;
+            if (out) out[pos] = byte | (v ? 0x80 : 0x00);
+            pos++;
+        } while (v);
+
+        if (wide) {
+            if (pos & 1) {
+                if (out) out[pos] = 0;
+                pos++;
+            }
+            for (int i = 0; i < len; ++i) {
+                if (out) reinterpret_cast<uint16_t*>(out + pos)[i] = static_cast<uint16_t>(col_idx[k + i] - base);
+            }
+            pos += 2LL * len;
+        } else {
+            for (int i = 0; i < len; ++i) {
+                if (out) out[pos + i] = static_cast<uint8_t>(col_idx[k + i] - base);
+            }
+            pos += len;
+            units8++;
+        }
+        units++;
+        prev = col_idx[k + len - 1];
+        k += len;
+    }
+    if (pos & 1) {
+        if (out) out[pos] = 0;
+        pos++;
+    }
+    return pos;
+}
+
+bool csr_to_csrdu(int M, int N, const int* row_ptr, const int* col_idx, const double* values,
+                  CsrduMatrix& A) {
+    // precondition of the encoding: sorted columns inside [0, N) in every row
+    int bad_row = M;
+    #pragma omp parallel for schedule(guided, CSRDU_BLOCK_SIZE) reduction(min:bad_row)
+    for (int r = 0; r < M; ++r) {
+        for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+            if (col_idx[k] < 0 || col_idx[k] >= N || (k > row_ptr[r] && col_idx[k] < col_idx[k - 1])) {
+                bad_row = r < bad_row ? r : bad_row;
+                break;
+            }
+        }
+    }
+    if (bad_row < M) {
+        std::cerr << "CSR-DU needs sorted column indices inside [0, " << N << ") in every row (row "
+                  << bad_row << " is not)" << std::endl;
+        return false;
+    }
+
+    A.M = M;
+    A.N = N;
+    A.nnz = M > 0 ? row_ptr[M] : 0;
+    A.row_ptr.assign(row_ptr, row_ptr + M + 1);
+    A.values.assign(values, values + A.nnz);
+
+    // ===== Pass 1: bytes per row =====
+    std::vector<long long> row_bytes(M + 1, 0);
+    long long units = 0, units8 = 0;
+    #pragma omp parallel for schedule(guided, CSRDU_BLOCK_SIZE) reduction(+:units, units8)
+    for (int r = 0; r < M; ++r) {
+        row_bytes[r + 1] = encode_row(col_idx, row_ptr[r], row_ptr[r + 1], r, nullptr, units, units8);
+    }
+    for (int r = 0; r < M; ++r) row_bytes[r + 1] += row_bytes[r];
+
+    A.num_units = units;
+    A.units8 = units8;
+    A.row_off.resize(M + 1);
+    for (int r = 0; r <= M; ++r) A.row_off[r] = static_cast<int>(row_bytes[r]);
+    A.ctl.assign(row_bytes[M], 0);
+
+    // ===== Pass 2: write the units =====
+    #pragma omp parallel for schedule(guided, CSRDU_BLOCK_SIZE)
+    for (int r = 0; r < M; ++r) {
+        long long u = 0, u8 = 0;
+        encode_row(col_idx, row_ptr[r], row_ptr[r + 1], r, A.ctl.data() + row_bytes[r], u, u8);
+    }
+    return true;
+}
+
+void spmv_csrdu(const CsrduMatrix& A, const double* __restrict__ x, double* __restrict__ y) {
+    const int M = A.M;
+    const int* __restrict__ row_ptr = A.row_ptr.data();
+    const int* __restrict__ row_off = A.row_off.data();
+    const uint8_t* __restrict__ ctl = A.ctl.data();
+    const double* __restrict__ values = A.values.data();
+
+    #pragma omp parallel for schedule(guided, CSRDU_BLOCK_SIZE)
+    for (int r = 0; r < M; ++r) {
+        double sum = 0.0;
+        const uint8_t* p = ctl + row_off[r];
+        const double* __restrict__ v = values + row_ptr[r];
+        const double* const v_end = values + row_ptr[r + 1];
+        int prev = r;
+
+        while (v < v_end) {
+            const uint8_t header = *p++;
+            const int len = (header & 0x7f) + 1;
+
+            uint32_t u = 0;
+            int shift = 0;
+            uint8_t byte;
+            do {
+                byte = *p++;
+                u |= static_cast<uint32_t>(byte & 0x7f) << shift;
+                shift += 7;
+            } while (byte & 0x80);
+            const int base = prev + unzigzag(u);
+            const double* __restrict__ xb = x + base;
+
+            // widen the offsets in registers and gather from x + base
+            if (header & 0x80) {
+                p += reinterpret_cast<uintptr_t>(p) & 1;
+                const uint16_t* __restrict__ d = reinterpret_cast<const uint16_t*>(p);
+                #pragma omp simd reduction(+:sum)
+                for (int i = 0; i < len; ++i) {
+                    sum += v[i] * xb[d[i]];
+                }
+                prev = base + d[len - 1];
+                p += 2 * len;
+            } else {
+                const uint8_t* __restrict__ d = p;
+                #pragma omp simd reduction(+:sum)
+                for (int i = 0; i < len; ++i) {
+                    sum += v[i] * xb[d[i]];
+                }
+                prev = base + d[len - 1];
+                p += len;
+            }
+            v += len;
+        }
+        y[r] = sum;
+    }
+}
@@ -0,0 +1,189 @@
+#include "../include/csr_simd.hpp"
+#include "../include/axpby.hpp"
+
+#include <omp.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+// the unmasked gathers and the reductions start from _mm*_undefined_pd(),
+// which GCC reports as maybe-uninitialized once inlined
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+static const char* const isa_names[] = {"auto", "compiler", "scalar", "avx2", "avx512"};
+
+bool simd_isa_from_name(const std::string& name, SimdIsa& isa) {
+    for (int i = 0; i <= SIMD_AVX512; ++i) {
+        if (name == isa_names[i]) {
+            isa = static_cast<SimdIsa>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* simd_isa_name(SimdIsa isa) {
+    return (isa >= SIMD_AUTO && isa <= SIMD_AVX512) ? isa_names[isa] : "unknown";
+}
+
+bool simd_supported(SimdIsa isa) {
+#if defined(__x86_64__)
+    // __builtin_cpu_supports also checks that the OS saves the wide registers
+    static const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    static const bool avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl");
+    if (isa == SIMD_AVX2) return avx2;
+    if (isa == SIMD_AVX512) return avx512;
+#else
+    if (isa == SIMD_AVX2 || isa == SIMD_AVX512) return false;
+#endif
+    return true;
+}
+
+SimdIsa simd_detect() {
+    if (simd_supported(SIMD_AVX512)) return SIMD_AVX512;
+    if (simd_supported(SIMD_AVX2)) return SIMD_AVX2;
+    return SIMD_COMPILER;
+}
+
+SimdIsa simd_resolve(SimdIsa isa, int M, long long nnz) {
+    if (isa != SIMD_AUTO) {
+        return simd_supported(isa) ? isa : simd_detect();
+    }
+    const double avg_row = M > 0 ? static_cast<double>(nnz) / M : 0.0;
+    if (avg_row >= SIMD_AVX512_MIN_ROW && simd_supported(SIMD_AVX512)) return SIMD_AVX512;
+    if (avg_row >= SIMD_AVX2_MIN_ROW && simd_supported(SIMD_AVX2)) return SIMD_AVX2;
+    // the baseline omp simd loop; the scalar kernel is only a reference
+    return SIMD_COMPILER;
+}
+
+// ================= Scalar =================
+
+template <int MODE>
+__attribute__((optimize("no-tree-vectorize")))
+static void csr_scalar(int M, const int* __restrict__ row_ptr, const int* __restrict__ col_idx,
+                       const double* __restrict__ values, double alpha, const double* __restrict__ x,
+                       double beta, double* __restrict__ y) {
+    #pragma omp parallel
+    {
+        #pragma omp for schedule(guided, AXPBY_BLOCK_SIZE) nowait
+        for (int r = 0; r < M; ++r) {
+            double sum = 0.0;
+            for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+                sum += values[k] * x[col_idx[k]];
+            }
+            axpby_store_row<MODE>(y, r, alpha, sum, beta);
+        }
+        if (MODE == AXPBY_STREAM) axpby_store_fence();
+    }
+}
+
+#if defined(__x86_64__)
+
+// ================= AVX2: 4 doubles per vector =================
+
+__attribute__((target("avx2,fma")))
+static inline double row_avx2(int begin, int end, const int* __restrict__ col_idx,
+                              const double* __restrict__ values, const double* __restrict__ x) {
+    __m256d acc = _mm256_setzero_pd();
+    int k = begin;
+    for (; k + 4 <= end; k += 4) {
+        const __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(col_idx + k));
+        const __m256d v = _mm256_loadu_pd(values + k);
+        acc = _mm256_fmadd_pd(v, _mm256_i32gather_pd(x, idx, 8), acc);
+    }
+    const int rem = end - k;
+    if (rem > 0) {
+        // lane i active if i < rem: 32-bit mask for the indices, 64-bit for the values
+        const __m128i mask32 = _mm_cmpgt_epi32(_mm_set1_epi32(rem), _mm_setr_epi32(0, 1, 2, 3));
+        const __m256i mask64 = _mm256_cvtepi32_epi64(mask32);
+        const __m128i idx = _mm_maskload_epi32(col_idx + k, mask32);
+        const __m256d v = _mm256_maskload_pd(values + k, mask64);
+        const __m256d xg = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, idx,
+                                                    _mm256_castsi256_pd(mask64), 8);
+        acc = _mm256_fmadd_pd(v, xg, acc);
+    }
+    const __m128d s = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+template <int MODE>
+__attribute__((target("avx2,fma")))
+static void csr_avx2(int M, const int* __restrict__ row_ptr, const int* __restrict__ col_idx,
+                     const double* __restrict__ values, double alpha, const double* __restrict__ x,
+                     double beta, double* __restrict__ y) {
+    #pragma omp parallel
+    {
+        #pragma omp for schedule(guided, AXPBY_BLOCK_SIZE) nowait
+        for (int r = 0; r < M; ++r) {
+            axpby_store_row<MODE>(y, r, alpha, row_avx2(row_ptr[r], row_ptr[r + 1], col_idx, values, x), beta);
+        }
+        if (MODE == AXPBY_STREAM) axpby_store_fence();
+    }
+}
+
+// ================= AVX-512: 8 doubles per vector =================
+
+__attribute__((target("avx512f,avx512vl")))
+static inline double row_avx512(int begin, int end, const int* __restrict__ col_idx,
+                                const double* __restrict__ values, const double* __restrict__ x) {
+    __m512d acc = _mm512_setzero_pd();
+    int k = begin;
+    for (; k + 8 <= end; k += 8) {
+        const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col_idx + k));
+        const __m512d v = _mm512_loadu_pd(values + k);
+        acc = _mm512_fmadd_pd(v, _mm512_i32gather_pd(idx, x, 8), acc);
+    }
+    const int rem = end - k;
+    if (rem > 0) {
+        const __mmask8 mask = static_cast<__mmask8>((1u << rem) - 1);
+        const __m256i idx = _mm256_maskz_loadu_epi32(mask, col_idx + k);
+        const __m512d v = _mm512_maskz_loadu_pd(mask, values + k);
+        const __m512d xg = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), mask, idx, x, 8);
+        acc = _mm512_fmadd_pd(v, xg, acc);
+    }
+    return _mm512_reduce_add_pd(acc);
+}
+
+template <int MODE>
+__attribute__((target("avx512f,avx512vl")))
+static void csr_avx512(int M, const int* __restrict__ row_ptr, const int* __restrict__ col_idx,
+                       const double* __restrict__ values, double alpha, const double* __restrict__ x,
+                       double beta, double* __restrict__ y) {
+    #pragma omp parallel
+    {
+        #pragma omp for schedule(guided, AXPBY_BLOCK_SIZE) nowait
+        for (int r = 0; r < M; ++r) {
+            axpby_store_row<MODE>(y, r, alpha, row_avx512(row_ptr[r], row_ptr[r + 1], col_idx, values, x), beta);
+        }
+        if (MODE == AXPBY_STREAM) axpby_store_fence();
+    }
+}
+
+#endif
+
+// picks the store mode of one kernel family
+#define CSR_SIMD_DISPATCH(KERNEL)                                                        \
+    do {                                                                                 \
+        if (beta != 0.0) KERNEL<AXPBY_UPDATE>(M, row_ptr, col_idx, values, alpha, x, beta, y);        \
+        else if (streaming) KERNEL<AXPBY_STREAM>(M, row_ptr, col_idx, values, alpha, x, beta, y);     \
+        else KERNEL<AXPBY_OVERWRITE>(M, row_ptr, col_idx, values, alpha, x, beta, y);                 \
+    } while (0)
+
+void spmv_csr_simd(SimdIsa isa, int M, const int* row_ptr, const int* col_idx, const double* values,
+                   double alpha, const double* x, double beta, double* y, bool streaming) {
+    switch (isa) {
+#if defined(__x86_64__)
+        case SIMD_AVX512:
+            CSR_SIMD_DISPATCH(csr_avx512);
+            break;
+        case SIMD_AVX2:
+            CSR_SIMD_DISPATCH(csr_avx2);
+            break;
+#endif
+        case SIMD_SCALAR:
+            CSR_SIMD_DISPATCH(csr_scalar);
+            break;
+        default:
+            spmv_csr_axpby(M, row_ptr, col_idx, values, alpha, x, beta, y, streaming);
+            break;
+    }
+}
@@ -0,0 +1,359 @@
+#include "../include/matrix_io.hpp"
+#include "../include/csr_convert.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <omp.h>
+
+extern "C" {
+#include "../include/mmio.h"
+}
+
+// ================= Hand-written field parsers =================
+// All of them work on [p, end) of the mapping (no terminating '\0') and
+// return the position after the field, or nullptr if there is none.
+
+static inline bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline const char* parse_int(const char* p, const char* end, int& out) {
+    while (p < end && is_blank(*p)) ++p;
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+    const char* digits = p;
+    long long v = 0;
+    while (p < end && *p >= '0' && *p <= '9' && v <= 0x7fffffffLL) {
+        v = v * 10 + (*p++ - '0');
+    }
+    if (p == digits || v > 0x7fffffffLL || (p < end && *p >= '0' && *p <= '9')) return nullptr;
+    out = static_cast<int>(neg ? -v : v);
+    return p;
+}
+
+static const double exact_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline const char* parse_double(const char* p, const char* end, double& out) {
+    while (p < end && is_blank(*p)) ++p;
+    const char* start = p;
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+
+    // up to 19 significant digits in an integer mantissa, the rest only moves the exponent
+    uint64_t mantissa = 0;
+    int significant = 0, exp10 = 0;
+    bool any_digit = false, truncated = false;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        any_digit = true;
+        if (significant < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0) ++significant;
+        } else {
+            ++exp10;
+            truncated |= (*p != '0');
+        }
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+            any_digit = true;
+            if (significant < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0) ++significant;
+                --exp10;
+            } else {
+                truncated |= (*p != '0');
+            }
+        }
+    }
+    if (any_digit && p < end && (*p == 'e' || *p == 'E' || *p == 'd' || *p == 'D')) {
+        const char* q = p + 1;
+        bool exp_neg = false;
+        if (q < end && (*q == '-' || *q == '+')) exp_neg = (*q++ == '-');
+        if (q < end && *q >= '0' && *q <= '9') {
+            int e = 0;
+            for (; q < end && *q >= '0' && *q <= '9'; ++q) {
+                if (e < 100000) e = e * 10 + (*q - '0');
+            }
+            exp10 += exp_neg ? -e : e;
+            p = q;
+        }
+    }
+
+    // exact when the mantissa and the power of ten are both exact doubles
+    // (Clinger's fast path): one rounding, same result as strtod
+    if (any_digit && !truncated && mantissa <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22) {
+        double v = static_cast<double>(mantissa);
+        v = exp10 < 0 ? v / exact_pow10[-exp10] : v * exact_pow10[exp10];
+        out = neg ? -v : v;
+        return p;
+    }
+
+    // long mantissas, huge exponents, inf/nan: strtod on a copy of the token
+    const char* token_end = any_digit ? p : start;
+    while (token_end < end && !is_blank(*token_end) && *token_end != '\n') ++token_end;
+    char buf[128];
+    const size_t len = static_cast<size_t>(token_end - start);
+    if (len == 0 || len >= sizeof(buf)) return nullptr;
+    std::memcpy(buf, start, len);
+    buf[len] = '\0';
+    char* parsed_end = nullptr;
+    out = std::strtod(buf, &parsed_end);
+    if (parsed_end != buf + len) return nullptr;
+    return token_end;
+}
+
+// first non-blank character of the line at p, or '\n' for an empty line
+static inline char line_start(const char*& p, const char* end) {
+    while (p < end && is_blank(*p)) ++p;
+    return p < end ? *p : '\n';
+}
+
+static inline const char* next_line(const char* p, const char* end) {
+    const void* nl = std::memchr(p, '\n', end - p);
+    return nl ? static_cast<const char*>(nl) + 1 : end;
+}
+
+// entries (non-empty, non-comment lines) in [p, end)
+static long long count_entries(const char* p, const char* end) {
+    long long count = 0;
+    while (p < end) {
+        const char c = line_start(p, end);
+        if (c != '\n' && c != '%') ++count;
+        p = next_line(p, end);
+    }
+    return count;
+}
+
+/*
+ * Parses the entries of [begin, end) into the COO arrays starting at entry
+ * first. Returns the index of the first malformed entry, or -1.
+*/
+static long long parse_entries(const char* begin, const char* end, long long first, bool pattern,
+                               int M, int N, int* row_coo, int* col_coo, double* val_coo) {
+    long long i = first;
+    const char* p = begin;
+    while (p < end) {
+        const char c = line_start(p, end);
+        if (c == '\n' || c == '%') {
+            p = next_line(p, end);
+            continue;
+        }
+        int r, col;
+        double v = 1.0;
+        const char* q = parse_int(p, end, r);
+        if (q) q = parse_int(q, end, col);
+        if (q && !pattern) q = parse_double(q, end, v);
+        if (!q || (q < end && !is_blank(*q) && *q != '\n') || r < 1 || r > M || col < 1 || col > N) {
+            return i;
+        }
+        // Convert to 0-based indexing
+        row_coo[i] = r - 1;
+        col_coo[i] = col - 1;
+        val_coo[i] = v;
+        ++i;
+        // the rest of the line is usually just the newline
+        p = (q < end && *q == '\n') ? q + 1 : next_line(q, end);
+    }
+    return -1;
+}
+
+bool read_matrix_market_coo(const std::string& filename, int& M, int& N, int& nz,
+                            std::vector<int>& row_coo, std::vector<int>& col_coo,
+                            std::vector<double>& val_coo, bool* symmetric,
+                            MtxLoadStats* load_stats) {
+    auto total_start = std::chrono::steady_clock::now();
+    // reads mtx file passed as argument
+    FILE* f = fopen(filename.c_str(), "r");
+    if (f == nullptr) {
+        std::cerr << "Could not open file: " << filename << std::endl;
+        return false;
+    }
+
+    // reads matrix banner
+    MM_typecode matcode;
+    if (mm_read_banner(f, &matcode) != 0) {
+        std::cerr << "Could not process Matrix Market banner." << std::endl;
+        fclose(f);
+        return false;
+    }
+
+    // check matrix type: must be real (or integer / pattern), sparse matrix
+    if (!mm_is_matrix(matcode) || !mm_is_sparse(matcode) || mm_is_complex(matcode)) {
+        std::cerr << "Only real-valued sparse matrices supported." << std::endl;
+        fclose(f);
+        return false;
+    }
+
+    // reads matrix size
+    if (mm_read_mtx_crd_size(f, &M, &N, &nz) != 0) {
+        std::cerr << "Could not read matrix size." << std::endl;
+        fclose(f);
+        return false;
+    }
+
+    // the entries start right after the size line
+    const long offset = ftell(f);
+    fclose(f);
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || offset < 0 || offset > st.st_size) {
+        std::cerr << "Could not open file: " << filename << std::endl;
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    const size_t file_size = static_cast<size_t>(st.st_size);
+    const char* data = nullptr;
+    if (file_size > 0) {
+        void* mapped = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Could not map file: " << filename << std::endl;
+            close(fd);
+            return false;
+        }
+        madvise(mapped, file_size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapped);
+    }
+    close(fd);
+
+    auto parse_start = std::chrono::steady_clock::now();
+    const char* begin = data + offset;
+    const char* end = data + file_size;
+    const size_t bytes = static_cast<size_t>(end - begin);
+
+    // one chunk per thread, every chunk starts at the beginning of a line
+    int num_chunks = std::max(1, std::min(omp_get_max_threads(), static_cast<int>(bytes / MTX_MIN_CHUNK_BYTES)));
+    std::vector<const char*> chunk(num_chunks + 1);
+    chunk[0] = begin;
+    for (int t = 1; t < num_chunks; ++t) {
+        const char* p = std::max(chunk[t - 1], begin + bytes * t / num_chunks);
+        chunk[t] = (p == chunk[t - 1] || p[-1] == '\n') ? p : next_line(p, end);
+    }
+    chunk[num_chunks] = end;
+
+    // pass 1: entries per chunk -> first entry of every chunk (exclusive scan)
+    std::vector<long long> first_entry(num_chunks + 1, 0);
+    #pragma omp parallel for schedule(static, 1) num_threads(num_chunks)
+    for (int t = 0; t < num_chunks; ++t) {
+        first_entry[t + 1] = count_entries(chunk[t], chunk[t + 1]);
+    }
+    for (int t = 0; t < num_chunks; ++t) {
+        first_entry[t + 1] += first_entry[t];
+    }
+    if (first_entry[num_chunks] != nz) {
+        std::cerr << "Error reading matrix entries: expected " << nz << ", found "
+                  << first_entry[num_chunks] << "." << std::endl;
+        if (data) munmap(const_cast<char*>(data), file_size);
+        return false;
+    }
+
+    // pass 2: every chunk is parsed straight into its slice of the COO arrays
+    row_coo.resize(nz);
+    col_coo.resize(nz);
+    val_coo.resize(nz);
+    const bool pattern = mm_is_pattern(matcode);
+    long long bad_entry = -1;
+    #pragma omp parallel for schedule(static, 1) num_threads(num_chunks)
+    for (int t = 0; t < num_chunks; ++t) {
+        long long bad = parse_entries(chunk[t], chunk[t + 1], first_entry[t], pattern, M, N,
+                                      row_coo.data(), col_coo.data(), val_coo.data());
+        if (bad >= 0) {
+            #pragma omp critical
+            if (bad_entry < 0 || bad < bad_entry) bad_entry = bad;
+        }
+    }
+    auto parse_end = std::chrono::steady_clock::now();
+    if (data) munmap(const_cast<char*>(data), file_size);
+    if (bad_entry >= 0) {
+        std::cerr << "Error reading matrix entry " << bad_entry + 1 << "." << std::endl;
+        return false;
+    }
+
+    // only one triangle is stored for (skew-)symmetric matrices
+    const bool is_symmetric = mm_is_symmetric(matcode);
+    if (symmetric != nullptr) {
+        *symmetric = is_symmetric;
+    }
+    if (is_symmetric && symmetric != nullptr) {
+        // keep the lower triangle, whichever one the file used
+        for (int i = 0; i < nz; ++i) {
+            if (row_coo[i] < col_coo[i]) std::swap(row_coo[i], col_coo[i]);
+        }
+    } else if (is_symmetric) {
+        expand_symmetric_coo(nz, row_coo, col_coo, val_coo, 1.0);
+    } else if (mm_is_skew(matcode)) {
+        expand_symmetric_coo(nz, row_coo, col_coo, val_coo, -1.0);
+    }
+
+    if (load_stats != nullptr) {
+        load_stats->data_bytes = bytes;
+        load_stats->threads = num_chunks;
+        load_stats->parse_ms = std::chrono::duration<double, std::milli>(parse_end - parse_start).count();
+        load_stats->total_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - total_start).count();
+    }
+    return true;
+}
+
+void expand_symmetric_coo(int& nz, std::vector<int>& row_coo, std::vector<int>& col_coo,
+                          std::vector<double>& val_coo, double sign) {
+    int off_diagonal = 0;
+    for (int i = 0; i < nz; ++i) {
+        if (row_coo[i] != col_coo[i]) ++off_diagonal;
+    }
+
+    row_coo.resize(nz + off_diagonal);
+    col_coo.resize(nz + off_diagonal);
+    val_coo.resize(nz + off_diagonal);
+    int dest = nz;
+    for (int i = 0; i < nz; ++i) {
+        if (row_coo[i] != col_coo[i]) {
+            row_coo[dest] = col_coo[i];
+            col_coo[dest] = row_coo[i];
+            val_coo[dest] = sign * val_coo[i];
+            ++dest;
+        }
+    }
+    nz += off_diagonal;
+}
+
+int coo_to_csr(int M, int nz,
+               const std::vector<int>& row_coo, const std::vector<int>& col_coo,
+               const std::vector<double>& val_coo,
+               std::vector<int>& row_ptr, std::vector<int>& col_idx,
+               std::vector<double>& values) {
+    return coo_to_csr_parallel(M, nz, row_coo.data(), col_coo.data(), val_coo.data(), row_ptr, col_idx, values);
+}
+
+bool read_matrix_market(const std::string& filename, int& M, int& N, int& nz,
+                        std::vector<int>& row_ptr, std::vector<int>& col_idx,
+                        std::vector<double>& values, bool* symmetric,
+                        MtxLoadStats* load_stats) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> row_coo, col_coo;
+    std::vector<double> val_coo;
+    if (!read_matrix_market_coo(filename, M, N, nz, row_coo, col_coo, val_coo, symmetric, load_stats)) {
+        return false;
+    }
+    auto convert_start = std::chrono::steady_clock::now();
+    nz = coo_to_csr(M, nz, row_coo, col_coo, val_coo, row_ptr, col_idx, values);
+    if (load_stats != nullptr) {
+        load_stats->convert_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - convert_start).count();
+        load_stats->total_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+    return true;
+}
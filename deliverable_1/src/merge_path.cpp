@@ -0,0 +1,98 @@
+#include "../include/merge_path.hpp"
+
+#include <algorithm>
+#include <omp.h>
+
+// Finds the merge-path coordinate (row, nz) where the given diagonal crosses
+// the path. row_end = row_ptr + 1, i.e. the end offset of every row.
+static void merge_path_search(long long diagonal, const int* row_end, int M, int nnz,
+                              int& row, int& nz) {
+    long long x_min = std::max(diagonal - nnz, 0LL);
+    long long x_max = std::min(diagonal, static_cast<long long>(M));
+
+    while (x_min < x_max) {
+        long long pivot = (x_min + x_max) / 2;
+        if (row_end[pivot] <= diagonal - pivot - 1) {
+            x_min = pivot + 1;      // path goes below: consume more rows
+        } else {
+            x_max = pivot;          // path goes right: consume more nonzeros
+        }
+    }
+    row = static_cast<int>(std::min(x_min, static_cast<long long>(M)));
+    nz  = static_cast<int>(diagonal - x_min);
+}
+
+void merge_path_partition(int M, const int* row_ptr, int num_parts, MergePathPlan& plan) {
+    const int nnz = row_ptr[M];
+    if (num_parts < 1 || nnz < MERGE_PATH_MIN_NNZ) num_parts = 1;
+    const long long total = static_cast<long long>(M) + nnz;
+    const long long items_per_part = (total + num_parts - 1) / num_parts;
+
+    plan.num_parts = num_parts;
+    plan.row_start.resize(num_parts + 1);
+    plan.nz_start.resize(num_parts + 1);
+    plan.carry_row.assign(num_parts, M);
+    plan.carry_val.assign(num_parts, 0.0);
+
+    #pragma omp parallel for schedule(static)
+    for (int p = 0; p <= num_parts; ++p) {
+        long long diagonal = std::min(items_per_part * p, total);
+        merge_path_search(diagonal, row_ptr + 1, M, nnz, plan.row_start[p], plan.nz_start[p]);
+    }
+}
+
+void spmv_csr_merge(MergePathPlan& plan, int M,
+                    const int* row_ptr, const int* col_idx, const double* values,
+                    const double* x, double* y) {
+    const int num_parts = plan.num_parts;
+
+    // nothing to balance: the plain CSR loop, without the parts and carries
+    if (num_parts == 1) {
+        #pragma omp parallel for schedule(guided) if (omp_get_max_threads() > 1)
+        for (int r = 0; r < M; ++r) {
+            double sum = 0.0;
+            #pragma omp simd reduction(+:sum)
+            for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+                sum += values[k] * x[col_idx[k]];
+            }
+            y[r] = sum;
+        }
+        return;
+    }
+
+    #pragma omp parallel for schedule(static, 1)
+    for (int p = 0; p < num_parts; ++p) {
+        int row = plan.row_start[p];
+        int nz  = plan.nz_start[p];
+        const int row_end = plan.row_start[p + 1];
+        const int nz_end  = plan.nz_start[p + 1];
+
+        // rows that end inside this part
+        for (; row < row_end; ++row) {
+            double sum = 0.0;
+            const int k_end = row_ptr[row + 1];
+            #pragma omp simd reduction(+:sum)
+            for (int k = nz; k < k_end; ++k) {
+                sum += values[k] * x[col_idx[k]];
+            }
+            nz = k_end;
+            y[row] = sum;
+        }
+
+        // head of the row that continues in the next part → carry-out
+        double sum = 0.0;
+        #pragma omp simd reduction(+:sum)
+        for (int k = nz; k < nz_end; ++k) {
+            sum += values[k] * x[col_idx[k]];
+        }
+        plan.carry_row[p] = row_end;
+        plan.carry_val[p] = sum;
+    }
+
+    // carry-out fix-up: rows split across parts
+    for (int p = 0; p < num_parts; ++p) {
+        if (plan.carry_row[p] < M) {
+            y[plan.carry_row[p]] += plan.carry_val[p];
+        }
+    }
+}
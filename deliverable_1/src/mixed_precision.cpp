@@ -0,0 +1,220 @@
+#include "../include/mixed_precision.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <omp.h>
+
+#if defined(__AVX512BF16__) || defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+#define MIXED_BLOCK_SIZE 10
+
+template <> const char* value_type_name<double>() { return "double"; }
+template <> const char* value_type_name<float>()  { return "float"; }
+template <> const char* value_type_name<bf16_t>() { return "bf16"; }
+template <> const char* value_type_name<fp16_t>() { return "fp16"; }
+
+// ================= Scalar conversions (round to nearest even) =================
+
+static uint16_t float_to_bf16(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    if ((u & 0x7fffffffu) > 0x7f800000u) {
+        return static_cast<uint16_t>((u >> 16) | 0x40u);   // keep NaN quiet
+    }
+    u += 0x7fffu + ((u >> 16) & 1u);
+    return static_cast<uint16_t>(u >> 16);
+}
+
+static uint16_t float_to_fp16(float f) {
+#if defined(__F16C__)
+    return _cvtss_sh(f, _MM_FROUND_TO_NEAREST_INT);
+#else
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    const uint32_t sign = (u >> 16) & 0x8000u;
+    const uint32_t absu = u & 0x7fffffffu;
+    if (absu >= 0x7f800000u) {
+        return static_cast<uint16_t>(sign | 0x7c00u | (absu > 0x7f800000u ? 0x200u : 0u));
+    }
+    if (absu >= 0x477ff000u) {
+        return static_cast<uint16_t>(sign | 0x7c00u);       // rounds above 65504: inf
+    }
+    if (absu < 0x38800000u) {
+        // below the smallest normal half: multiples of 2^-24
+        float a;
+        std::memcpy(&a, &absu, sizeof(a));
+        return static_cast<uint16_t>(sign | static_cast<uint32_t>(std::nearbyint(a * 16777216.0f)));
+    }
+    uint32_t h = (absu - 0x38000000u) >> 13;                 // rebias 127 -> 15
+    const uint32_t rem = absu & 0x1fffu;
+    if (rem > 0x1000u || (rem == 0x1000u && (h & 1u))) h++;
+    return static_cast<uint16_t>(sign | h);
+#endif
+}
+
+// ================= Bulk conversions =================
+
+template <>
+void convert_values<float>(long long n, const double* src, float* dst) {
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < n; ++i) {
+        dst[i] = static_cast<float>(src[i]);
+    }
+}
+
+template <>
+void convert_values<bf16_t>(long long n, const double* src, bf16_t* dst) {
+    long long i = 0;
+#if defined(__AVX512BF16__) && defined(__AVX512VL__)
+    // 8 values per instruction (vcvtneps2bf16)
+    const long long n8 = n - n % 8;
+    #pragma omp parallel for schedule(static)
+    for (long long b = 0; b < n8; b += 8) {
+        __m128 lo = _mm256_cvtpd_ps(_mm256_loadu_pd(src + b));
+        __m128 hi = _mm256_cvtpd_ps(_mm256_loadu_pd(src + b + 4));
+        __m128bh h = _mm256_cvtneps_pbh(_mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + b), reinterpret_cast<__m128i&>(h));
+    }
+    i = n8;
+#endif
+    for (; i < n; ++i) {
+        dst[i].bits = float_to_bf16(static_cast<float>(src[i]));
+    }
+}
+
+template <>
+void convert_values<fp16_t>(long long n, const double* src, fp16_t* dst) {
+    long long i = 0;
+#if defined(__F16C__) && defined(__AVX__)
+    // 8 values per instruction (vcvtps2ph)
+    const long long n8 = n - n % 8;
+    #pragma omp parallel for schedule(static)
+    for (long long b = 0; b < n8; b += 8) {
+        __m128 lo = _mm256_cvtpd_ps(_mm256_loadu_pd(src + b));
+        __m128 hi = _mm256_cvtpd_ps(_mm256_loadu_pd(src + b + 4));
+        __m256 f = _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+        __m128i h = _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + b), h);
+    }
+    i = n8;
+#endif
+    for (; i < n; ++i) {
+        dst[i].bits = float_to_fp16(static_cast<float>(src[i]));
+    }
+}
+
+// ================= Kernel =================
+
+template <typename V>
+void spmv_csr_mixed(int M, const int* __restrict__ row_ptr, const int* __restrict__ col_idx,
+                    const V* __restrict__ values, const double* __restrict__ x, double* __restrict__ y) {
+    #pragma omp parallel for schedule(guided, MIXED_BLOCK_SIZE)
+    for (int r = 0; r < M; ++r) {
+        double sum = 0.0;
+        #pragma omp simd reduction(+:sum)
+        for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+            sum += static_cast<double>(to_float(values[k])) * x[col_idx[k]];
+        }
+        y[r] = sum;
+    }
+}
+
+template void spmv_csr_mixed<float>(int, const int*, const int*, const float*, const double*, double*);
+template void spmv_csr_mixed<bf16_t>(int, const int*, const int*, const bf16_t*, const double*, double*);
+template void spmv_csr_mixed<fp16_t>(int, const int*, const int*, const fp16_t*, const double*, double*);
+
+// ================= Runtime value type =================
+
+bool value_type_from_name(const std::string& name, ValueType& type) {
+    const ValueType types[] = {VALUE_DOUBLE, VALUE_FLOAT, VALUE_BF16, VALUE_FP16};
+    for (ValueType t : types) {
+        if (name == value_type_name(t)) {
+            type = t;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* value_type_name(ValueType type) {
+    switch (type) {
+        case VALUE_DOUBLE: return value_type_name<double>();
+        case VALUE_FLOAT: return value_type_name<float>();
+        case VALUE_BF16: return value_type_name<bf16_t>();
+        case VALUE_FP16: return value_type_name<fp16_t>();
+    }
+    return "unknown";
+}
+
+int value_type_bytes(ValueType type) {
+    switch (type) {
+        case VALUE_DOUBLE: return sizeof(double);
+        case VALUE_FLOAT: return sizeof(float);
+        case VALUE_BF16: return sizeof(bf16_t);
+        case VALUE_FP16: return sizeof(fp16_t);
+    }
+    return sizeof(double);
+}
+
+void mixed_values_convert(ValueType type, long long nnz, const double* values, MixedValues& mixed) {
+    auto start = std::chrono::steady_clock::now();
+    mixed = MixedValues();
+    mixed.type = type;
+    if (type == VALUE_FLOAT) {
+        mixed.f.resize(nnz);
+        convert_values(nnz, values, mixed.f.data());
+    } else if (type == VALUE_BF16) {
+        mixed.bf16.resize(nnz);
+        convert_values(nnz, values, mixed.bf16.data());
+    } else if (type == VALUE_FP16) {
+        mixed.fp16.resize(nnz);
+        convert_values(nnz, values, mixed.fp16.data());
+    }
+    mixed.convert_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void spmv_csr_mixed(const MixedValues& mixed, int M, const int* row_ptr, const int* col_idx,
+                    const double* x, double* y) {
+    if (mixed.type == VALUE_FLOAT) {
+        spmv_csr_mixed(M, row_ptr, col_idx, mixed.f.data(), x, y);
+    } else if (mixed.type == VALUE_BF16) {
+        spmv_csr_mixed(M, row_ptr, col_idx, mixed.bf16.data(), x, y);
+    } else if (mixed.type == VALUE_FP16) {
+        spmv_csr_mixed(M, row_ptr, col_idx, mixed.fp16.data(), x, y);
+    }
+}
+
+void mixed_values_error(const MixedValues& mixed, int M, const int* row_ptr, const int* col_idx,
+                        const double* values, const double* x, const double* y, MixedError& err) {
+    err = MixedError();
+    // largest magnitude that does not round to inf (checked on the input:
+    // isinf() is not reliable under -ffast-math)
+    const double max_finite = mixed.type == VALUE_FP16 ? 65519.0 : 3.4028235e38;
+    const int nnz = row_ptr[M];
+    for (int k = 0; k < nnz; ++k) {
+        const double stored = mixed.type == VALUE_FLOAT ? to_float(mixed.f[k])
+                            : mixed.type == VALUE_BF16 ? to_float(mixed.bf16[k]) : to_float(mixed.fp16[k]);
+        if (std::fabs(values[k]) > max_finite) {
+            err.out_of_range++;
+        } else if (values[k] != 0.0) {
+            err.max_value_err = std::max(err.max_value_err, std::fabs(stored - values[k]) / std::fabs(values[k]));
+        }
+    }
+    double max_err = 0.0, max_ref = 0.0, sum_sq_err = 0.0, sum_sq_ref = 0.0;
+    for (int r = 0; r < M; ++r) {
+        double sum = 0.0;
+        for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+            sum += values[k] * x[col_idx[k]];
+        }
+        const double e = y[r] - sum;
+        max_err = std::max(max_err, std::fabs(e));
+        max_ref = std::max(max_ref, std::fabs(sum));
+        sum_sq_err += e * e;
+        sum_sq_ref += sum * sum;
+    }
+    err.rel_max_err = max_ref > 0.0 ? max_err / max_ref : max_err;
+    err.rel_l2_err = sum_sq_ref > 0.0 ? std::sqrt(sum_sq_err / sum_sq_ref) : std::sqrt(sum_sq_err);
+}
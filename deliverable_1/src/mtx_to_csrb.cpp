@@ -0,0 +1,123 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <iomanip>
+
+#include "../include/matrix_io.hpp"
+#include "../include/csr_bin.hpp"
+
+extern "C" {
+#include "../include/mmio.h"
+}
+
+static const char* symmetry_name(uint32_t symmetry) {
+    switch (symmetry) {
+        case CSRBIN_SYMMETRIC: return "symmetric";
+        case CSRBIN_SKEW_SYMMETRIC: return "skew-symmetric";
+        default: return "general";
+    }
+}
+
+static void print_header(const std::string& filename, const CsrBinHeader& h) {
+    std::cout << "File               : " << filename << "\n";
+    std::cout << "Version            : " << h.version << "\n";
+    std::cout << "Dimensions         : " << h.M << " x " << h.N << "   (nnz = " << h.nnz << ")\n";
+    std::cout << "Source symmetry    : " << symmetry_name(h.symmetry) << " (stored expanded)\n";
+    std::cout << "Index / value width: " << h.index_width << " / " << h.value_width << " bytes\n";
+    std::cout << "Row nnz min/max    : " << h.row_min << " / " << h.row_max
+              << "   (empty rows = " << h.empty_rows << ")\n";
+    std::cout << "Bandwidth          : " << h.bandwidth << "   (diagonal entries = " << h.diagonal << ")\n";
+    std::cout << "Sections (offset)  : row_ptr " << h.row_ptr_offset << ", col_idx " << h.col_idx_offset
+              << ", values " << h.values_offset << "\n";
+    std::cout << "File size          : " << h.file_size << " bytes\n";
+    std::cout << "Checksum           : " << std::hex << std::setw(16) << std::setfill('0') << h.checksum
+              << std::dec << std::setfill(' ') << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    bool verbose = false;
+    bool info = false;
+    std::string input, output;
+    // validate command-line arguments and print usage if incorrect
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " [--verbose] matrix_file.mtx [output.csrb]\n"
+                  << "       " << argv[0] << " --info matrix_file.csrb" << std::endl;
+        return 1;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--verbose" || arg == "-v") {
+            verbose = true;
+        } else if (arg == "--info") {
+            info = true;
+        } else if (input.empty()) {
+            input = arg;
+        } else {
+            output = arg;
+        }
+    }
+    if (input.empty()) {
+        std::cerr << "No matrix file specified." << std::endl;
+        return 1;
+    }
+
+    // ================= Inspect an existing container (checksum verified) =================
+    if (info) {
+        LoadedCsr A;
+        auto start = std::chrono::steady_clock::now();
+        if (!csr_bin_map(input, A, true)) {
+            return 1;
+        }
+        auto end = std::chrono::steady_clock::now();
+        print_header(input, A.header);
+        std::cout << "Checksum verified in " << std::fixed << std::setprecision(3)
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+        return 0;
+    }
+
+    if (output.empty()) {
+        output = input;
+        const std::string ext = ".mtx";
+        if (output.size() > ext.size() && output.compare(output.size() - ext.size(), ext.size(), ext) == 0) {
+            output.erase(output.size() - ext.size());
+        }
+        output += ".csrb";
+    }
+
+    // symmetry declared by the banner (the reader expands it)
+    CsrBinSymmetry symmetry = CSRBIN_GENERAL;
+    FILE* f = fopen(input.c_str(), "r");
+    MM_typecode matcode;
+    if (f != nullptr && mm_read_banner(f, &matcode) == 0) {
+        if (mm_is_symmetric(matcode)) symmetry = CSRBIN_SYMMETRIC;
+        else if (mm_is_skew(matcode)) symmetry = CSRBIN_SKEW_SYMMETRIC;
+    }
+    if (f != nullptr) fclose(f);
+
+    int M, N, nz;
+    std::vector<int> row_ptr, col_idx;
+    std::vector<double> values;
+    MtxLoadStats load;
+    if (!read_matrix_market(input, M, N, nz, row_ptr, col_idx, values, nullptr, &load)) {
+        return 1;
+    }
+    if (verbose) {
+        std::cout << "Loaded " << input << " in " << load.total_ms << " ms (parse "
+                  << load.parse_mb_per_s() << " MB/s on " << load.threads << " threads)" << std::endl;
+    }
+
+    CsrBinHeader header;
+    auto start = std::chrono::steady_clock::now();
+    if (!csr_bin_write(output, M, N, row_ptr.data(), col_idx.data(), values.data(), symmetry, &header)) {
+        return 1;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    print_header(output, header);
+    std::cout << "Written in " << std::fixed << std::setprecision(3)
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+    return 0;
+}
@@ -0,0 +1,227 @@
+#include "../include/numa_alloc.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <sched.h>
+#include <unistd.h>
+#include <omp.h>
+
+static const char* const policy_names[] = {"none", "compact", "scatter", "socket"};
+
+bool affinity_from_name(const std::string& name, AffinityPolicy& policy) {
+    for (int i = 0; i <= AFFINITY_SOCKET; ++i) {
+        if (name == policy_names[i]) {
+            policy = static_cast<AffinityPolicy>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* affinity_name(AffinityPolicy policy) {
+    return (policy >= AFFINITY_NONE && policy <= AFFINITY_SOCKET) ? policy_names[policy] : "unknown";
+}
+
+// Parses a sysfs CPU list such as "0-7,16-23"
+static std::vector<int> parse_cpulist(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        if (range.empty()) continue;
+        size_t dash = range.find('-');
+        int first = std::atoi(range.substr(0, dash).c_str());
+        int last = (dash == std::string::npos) ? first : std::atoi(range.substr(dash + 1).c_str());
+        for (int c = first; c <= last; ++c) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+void numa_read_topology(NumaTopology& topo) {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) CPU_SET(c, &allowed);
+    }
+
+    topo.node_cpus.clear();
+    for (int node = 0;; ++node) {
+        std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!in.is_open()) break;
+        std::string list;
+        std::getline(in, list);
+        std::vector<int> cpus;
+        std::vector<int> all = parse_cpulist(list);
+        for (size_t i = 0; i < all.size(); ++i) {
+            if (all[i] < CPU_SETSIZE && CPU_ISSET(all[i], &allowed)) cpus.push_back(all[i]);
+        }
+        // nodes without usable CPUs (memory-only, or excluded by the cpuset) are skipped
+        if (!cpus.empty()) topo.node_cpus.push_back(cpus);
+    }
+    if (topo.node_cpus.empty()) {
+        std::vector<int> cpus;
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &allowed)) cpus.push_back(c);
+        }
+        topo.node_cpus.push_back(cpus);
+    }
+
+    topo.num_nodes = static_cast<int>(topo.node_cpus.size());
+    topo.cpu_node.assign(CPU_SETSIZE, -1);
+    for (int node = 0; node < topo.num_nodes; ++node) {
+        for (size_t i = 0; i < topo.node_cpus[node].size(); ++i) {
+            topo.cpu_node[topo.node_cpus[node][i]] = node;
+        }
+    }
+}
+
+long long llc_total_bytes(int* instances) {
+    // highest cache level of every CPU; instances shared by several CPUs are
+    // counted once (keyed by their shared_cpu_list)
+    std::vector<std::string> seen;
+    long long total = 0;
+    const long ncpu = sysconf(_SC_NPROCESSORS_CONF);
+    for (long cpu = 0; cpu < ncpu; ++cpu) {
+        const std::string dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cache/index";
+        int best_level = 0;
+        long long best_size = 0;
+        std::string best_shared;
+        for (int idx = 0;; ++idx) {
+            std::ifstream level_in(dir + std::to_string(idx) + "/level");
+            if (!level_in.is_open()) break;
+            int level = 0;
+            level_in >> level;
+            std::ifstream type_in(dir + std::to_string(idx) + "/type");
+            std::string type;
+            type_in >> type;
+            if (type == "Instruction" || level < best_level) continue;
+            std::ifstream size_in(dir + std::to_string(idx) + "/size");
+            std::ifstream shared_in(dir + std::to_string(idx) + "/shared_cpu_list");
+            long long size = 0;
+            std::string unit, shared;
+            size_in >> size >> unit;
+            std::getline(shared_in, shared);
+            if (unit == "K") size <<= 10;
+            else if (unit == "M") size <<= 20;
+            best_level = level;
+            best_size = size;
+            best_shared = shared;
+        }
+        if (best_size > 0 && std::find(seen.begin(), seen.end(), best_shared) == seen.end()) {
+            seen.push_back(best_shared);
+            total += best_size;
+        }
+    }
+    if (total == 0) {
+        const long size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        total = size > 0 ? size : 0;
+        seen.clear();
+    }
+    if (instances) *instances = std::max<int>(1, static_cast<int>(seen.size()));
+    return total;
+}
+
+// CPU of thread t under a policy (threads beyond the CPU count wrap around)
+static int policy_cpu(const NumaTopology& topo, AffinityPolicy policy, int t, int num_threads) {
+    const int nodes = topo.num_nodes;
+    if (policy == AFFINITY_SCATTER) {
+        const std::vector<int>& cpus = topo.node_cpus[t % nodes];
+        return cpus[(t / nodes) % cpus.size()];
+    }
+    if (policy == AFFINITY_SOCKET) {
+        // thread blocks of (almost) equal size, block b on node b
+        const int node = static_cast<int>(static_cast<long long>(t) * nodes / num_threads);
+        const int first = static_cast<int>((static_cast<long long>(node) * num_threads + nodes - 1) / nodes);
+        const std::vector<int>& cpus = topo.node_cpus[node];
+        return cpus[(t - first) % cpus.size()];
+    }
+    // compact: node-major order of all CPUs
+    int total = 0;
+    for (int n = 0; n < nodes; ++n) total += static_cast<int>(topo.node_cpus[n].size());
+    int idx = t % total;
+    for (int n = 0; n < nodes; ++n) {
+        if (idx < static_cast<int>(topo.node_cpus[n].size())) return topo.node_cpus[n][idx];
+        idx -= static_cast<int>(topo.node_cpus[n].size());
+    }
+    return topo.node_cpus[0][0];
+}
+
+bool pin_threads(const NumaTopology& topo, AffinityPolicy policy, int num_threads,
+                 std::vector<int>& thread_node) {
+    thread_node.assign(num_threads, 0);
+    bool ok = true;
+
+    #pragma omp parallel num_threads(num_threads) reduction(&&:ok)
+    {
+        const int t = omp_get_thread_num();
+        if (policy != AFFINITY_NONE) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(policy_cpu(topo, policy, t, num_threads), &set);
+            // pid 0 = calling thread
+            ok = sched_setaffinity(0, sizeof(set), &set) == 0;
+        }
+        const int cpu = sched_getcpu();
+        thread_node[t] = (cpu >= 0 && cpu < CPU_SETSIZE && topo.cpu_node[cpu] >= 0) ? topo.cpu_node[cpu] : 0;
+    }
+    return ok;
+}
+
+void numa_partition_rows(int M, const int* row_ptr, int num_parts, std::vector<int>& row_start) {
+    if (num_parts < 1) num_parts = 1;
+    row_start.resize(num_parts + 1);
+    const long long nnz = M > 0 ? row_ptr[M] : 0;
+    row_start[0] = 0;
+    for (int p = 1; p < num_parts; ++p) {
+        // first row whose start reaches p/num_parts of the nonzeros (rows count as one unit too)
+        const long long target = (nnz + M) * p / num_parts;
+        int lo = row_start[p - 1], hi = M;
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            if (static_cast<long long>(row_ptr[mid]) + mid < target) lo = mid + 1;
+            else hi = mid;
+        }
+        row_start[p] = lo;
+    }
+    row_start[num_parts] = M;
+}
+
+void numa_first_touch_csr(int M, int N, const int* row_ptr, const int* col_idx, const double* values,
+                          int num_threads, NumaCsr& A) {
+    A.M = M;
+    A.N = N;
+    A.num_parts = num_threads;
+    numa_partition_rows(M, row_ptr, num_threads, A.row_start);
+
+    const int nnz = M > 0 ? row_ptr[M] : 0;
+    A.row_ptr = first_touch_vector<int>(M + 1);
+    A.col_idx = first_touch_vector<int>(nnz);
+    A.values = first_touch_vector<double>(nnz);
+
+    // part p is touched by thread p when the full team is granted; a smaller
+    // team still copies every part
+    #pragma omp parallel for num_threads(num_threads) schedule(static, 1)
+    for (int p = 0; p < num_threads; ++p) {
+        const int r_begin = A.row_start[p];
+        const int r_end = A.row_start[p + 1];
+        for (int r = r_begin; r < r_end; ++r) A.row_ptr[r] = row_ptr[r];
+        if (p == num_threads - 1) A.row_ptr[M] = row_ptr[M];
+        for (int k = row_ptr[r_begin]; k < row_ptr[r_end]; ++k) {
+            A.col_idx[k] = col_idx[k];
+            A.values[k] = values[k];
+        }
+    }
+}
+
+void numa_first_touch_vector(const NumaCsr& A, int n, const double* src, first_touch_vector<double>& dst) {
+    dst = first_touch_vector<double>(n);
+    #pragma omp parallel for num_threads(A.num_parts) schedule(static, 1)
+    for (int p = 0; p < A.num_parts; ++p) {
+        // the same fraction of the vector as of the rows
+        const int begin = static_cast<int>(A.M > 0 ? static_cast<long long>(A.row_start[p]) * n / A.M : 0);
+        const int end = static_cast<int>(A.M > 0 ? static_cast<long long>(A.row_start[p + 1]) * n / A.M : n);
+        for (int i = begin; i < end; ++i) dst[i] = src ? src[i] : 0.0;
+    }
+}
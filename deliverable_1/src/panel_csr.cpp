@@ -0,0 +1,143 @@
+#include "../include/panel_csr.hpp"
+#include "../include/axpby.hpp"
+#include "../include/numa_alloc.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <omp.h>
+
+// columns per cache line of x
+#define LINE_DOUBLES 8
+
+long long panel_cache_budget(long long cache_budget) {
+    if (cache_budget > 0) return cache_budget;
+    int instances = 1;
+    const long long llc = llc_total_bytes(&instances);
+    return static_cast<long long>(PANEL_CACHE_FRACTION * llc / instances);
+}
+
+int panel_width_for_cache(int N, long long cache_budget) {
+    cache_budget = panel_cache_budget(cache_budget);
+    long long width = cache_budget / static_cast<long long>(sizeof(double));
+    width -= width % LINE_DOUBLES;
+    // unknown cache: no blocking
+    if (width <= 0) return std::max(N, 1);
+    return static_cast<int>(std::max(1LL, std::min<long long>(width, N)));
+}
+
+void panel_csr_build(int M, int N, const int* row_ptr, const int* col_idx, const double* values,
+                     int width, PanelCsr& P) {
+    auto start = std::chrono::steady_clock::now();
+    panel_csr_release(P);
+    P.M = M;
+    P.N = N;
+    P.width = std::max(1, width);
+    P.num_panels = std::max(1, (N + P.width - 1) / P.width);
+    const int np = P.num_panels;
+
+    const int T = omp_get_max_threads();
+    std::vector<int> row_start;
+    numa_partition_rows(M, row_ptr, T, row_start);
+    // per (thread, panel): panel rows and nonzeros, then their write offsets
+    std::vector<int> cnt_rows(static_cast<size_t>(T) * np, 0), cnt_nz(static_cast<size_t>(T) * np, 0);
+
+    // 1. count the panel rows (runs of one panel inside a row: columns are sorted)
+    #pragma omp parallel for schedule(static, 1)
+    for (int t = 0; t < T; ++t) {
+        int* cr = cnt_rows.data() + static_cast<size_t>(t) * np;
+        int* cn = cnt_nz.data() + static_cast<size_t>(t) * np;
+        for (int r = row_start[t]; r < row_start[t + 1]; ++r) {
+            int last = -1;
+            for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+                const int p = col_idx[k] / P.width;
+                if (p != last) {
+                    cr[p]++;
+                    last = p;
+                }
+                cn[p]++;
+            }
+        }
+    }
+
+    // 2. panel-major scan: panel p, then thread t inside it (keeps the rows sorted)
+    P.row_off.assign(np + 1, 0);
+    int row_acc = 0, nz_acc = 0;
+    for (int p = 0; p < np; ++p) {
+        P.row_off[p] = row_acc;
+        for (int t = 0; t < T; ++t) {
+            const size_t i = static_cast<size_t>(t) * np + p;
+            const int nr = cnt_rows[i], nn = cnt_nz[i];
+            cnt_rows[i] = row_acc;
+            cnt_nz[i] = nz_acc;
+            row_acc += nr;
+            nz_acc += nn;
+        }
+    }
+    P.row_off[np] = row_acc;
+    P.rows.resize(row_acc);
+    P.row_ptr.resize(row_acc + 1);
+    P.row_ptr[row_acc] = nz_acc;
+    P.col_idx.resize(nz_acc);
+    P.values.resize(nz_acc);
+
+    // 3. every thread writes its rows through its offsets
+    #pragma omp parallel for schedule(static, 1)
+    for (int t = 0; t < T; ++t) {
+        int* orow = cnt_rows.data() + static_cast<size_t>(t) * np;
+        int* onz = cnt_nz.data() + static_cast<size_t>(t) * np;
+        for (int r = row_start[t]; r < row_start[t + 1]; ++r) {
+            int last = -1;
+            for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+                const int p = col_idx[k] / P.width;
+                if (p != last) {
+                    const int i = orow[p]++;
+                    P.rows[i] = r;
+                    P.row_ptr[i] = onz[p];
+                    last = p;
+                }
+                const int dest = onz[p]++;
+                P.col_idx[dest] = col_idx[k] - p * P.width;
+                P.values[dest] = values[k];
+            }
+        }
+    }
+    P.build_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void spmv_panel_csr(const PanelCsr& P, double alpha, const double* __restrict__ x, double beta,
+                    double* __restrict__ y) {
+    const int* __restrict__ rows = P.rows.data();
+    const int* __restrict__ row_ptr = P.row_ptr.data();
+    const int* __restrict__ col_idx = P.col_idx.data();
+    const double* __restrict__ values = P.values.data();
+
+    #pragma omp parallel
+    {
+        #pragma omp for schedule(static)
+        for (int r = 0; r < P.M; ++r) {
+            y[r] = beta == 0.0 ? 0.0 : beta * y[r];
+        }
+        // the implicit barrier of every loop keeps two panels from updating a row at once
+        for (int p = 0; p < P.num_panels; ++p) {
+            const double* __restrict__ xp = x + static_cast<size_t>(p) * P.width;
+            #pragma omp for schedule(guided, AXPBY_BLOCK_SIZE)
+            for (int i = P.row_off[p]; i < P.row_off[p + 1]; ++i) {
+                double sum = 0.0;
+                for (int k = row_ptr[i]; k < row_ptr[i + 1]; ++k) {
+                    sum += values[k] * xp[col_idx[k]];
+                }
+                y[rows[i]] += alpha * sum;
+            }
+        }
+    }
+}
+
+void panel_csr_release(PanelCsr& P) {
+    P.row_off.clear();
+    std::vector<int>().swap(P.rows);
+    std::vector<int>().swap(P.row_ptr);
+    std::vector<int>().swap(P.col_idx);
+    std::vector<double>().swap(P.values);
+    P.num_panels = 0;
+    P.build_ms = 0.0;
+}
@@ -0,0 +1,202 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <sstream>
+#include <random>
+#include <omp.h>
+#include <algorithm>
+#include <iomanip>
+
+#include "../include/matrix_io.hpp"
+#include "../include/spmm.hpp"
+#include "../include/bench.hpp"
+#include "../include/roofline.hpp"
+
+#define NUM_THREADS 16
+
+extern "C" {
+#include <valgrind/callgrind.h>
+}
+
+int main(int argc, char* argv[]) {
+    bool verbose = false;
+    std::string matrix_filename;
+    std::vector<int> k_list = {1, 2, 4, 8, 16};
+    // validate command-line arguments and print usage if incorrect
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " [--k 1,2,4,8,16] [--verbose] matrix_file.mtx" << std::endl;
+        return 1;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--verbose" || arg == "-v") {
+            verbose = true;
+        } else if (arg == "--k" || arg == "-k") {
+            k_list.clear();
+            std::stringstream list((i + 1 < argc) ? argv[++i] : "");
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                int k = std::atoi(item.c_str());
+                if (k <= 0) {
+                    std::cerr << "--k needs a comma separated list of positive integers" << std::endl;
+                    return 1;
+                }
+                k_list.push_back(k);
+            }
+            if (k_list.empty()) {
+                std::cerr << "--k needs a comma separated list of positive integers" << std::endl;
+                return 1;
+            }
+        } else {
+            matrix_filename = arg;
+        }
+    }
+    // check if no matrix file is passed
+    if (matrix_filename.empty()) {
+        std::cerr << "No matrix file specified." << std::endl;
+        return 1;
+    }
+
+    int M, N, nz;
+    std::vector<int> row_ptr, col_idx;
+    std::vector<double> values;
+    if (!read_matrix_market(matrix_filename, M, N, nz, row_ptr, col_idx, values)) {
+        return 1;
+    }
+
+    // ================= SET THREAD COUNT =================
+    int num_threads = NUM_THREADS;
+    if (getenv("OMP_NUM_THREADS") != nullptr) {
+        num_threads = atoi(getenv("OMP_NUM_THREADS"));
+    }
+    omp_set_num_threads(num_threads);
+    if (verbose) {
+        std::cout << "Using: " << num_threads << " threads\n";
+    }
+
+    const int k_max = *std::max_element(k_list.begin(), k_list.end());
+
+    // generate random tall-skinny block (row-major, k_max columns)
+    std::vector<double> X_full(static_cast<size_t>(N) * k_max);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<double> dis(0.0, 1.0);
+    for (size_t i = 0; i < X_full.size(); ++i) {
+        X_full[i] = dis(gen);
+    }
+
+    BenchConfig bench_cfg = bench_config_from_env(verbose);
+
+    struct SpmmResult {
+        int k;
+        double best_time_ms;
+        double rel_err;
+    };
+    std::vector<SpmmResult> results;
+
+    for (size_t t = 0; t < k_list.size(); ++t) {
+        const int k = k_list[t];
+
+        // first k columns of X_full, row-major with stride k
+        std::vector<double> X(static_cast<size_t>(N) * k), Y(static_cast<size_t>(M) * k, 0.0);
+        for (int j = 0; j < N; ++j) {
+            for (int c = 0; c < k; ++c) {
+                X[static_cast<size_t>(j) * k + c] = X_full[static_cast<size_t>(j) * k_max + c];
+            }
+        }
+
+        auto run_spmm = [&]() {
+            spmm_csr(M, row_ptr.data(), col_idx.data(), values.data(), k, X.data(), Y.data());
+        };
+
+        // ================= Warm-up (until the times are stable, not timed) =================
+        BenchStats stats;
+        stats.warmup_iters = bench_warmup(bench_cfg, run_spmm);
+        if (verbose) {
+            std::cout << "Ran " << stats.warmup_iters << " warm-up iterations for parallel CSR SpMM (k = " << k << ")" << std::endl;
+        }
+
+        // toggles callgrind (set to false) collection here
+        CALLGRIND_TOGGLE_COLLECT;
+
+        bench_sample(bench_cfg, run_spmm, stats);
+
+        // toggles callgrind collect (set to true) here
+        CALLGRIND_TOGGLE_COLLECT;
+
+        // check every column against a plain CSR product
+        double max_err = 0.0, max_ref = 0.0;
+        for (int r = 0; r < M; ++r) {
+            for (int c = 0; c < k; ++c) {
+                double sum = 0.0;
+                for (int idx = row_ptr[r]; idx < row_ptr[r + 1]; ++idx) {
+                    sum += values[idx] * X[static_cast<size_t>(col_idx[idx]) * k + c];
+                }
+                max_err = std::max(max_err, std::fabs(sum - Y[static_cast<size_t>(r) * k + c]));
+                max_ref = std::max(max_ref, std::fabs(sum));
+            }
+        }
+
+        SpmmResult res;
+        res.k = k;
+        res.best_time_ms = stats.min_ms;
+        bench_record(bench_cfg, "parallel_spmm_csr", matrix_filename, "spmm/k" + std::to_string(k), num_threads, stats);
+        res.rel_err = max_ref > 0.0 ? max_err / max_ref : max_err;
+        results.push_back(res);
+    }
+
+    // ================= Results: GFLOPS as a function of k =================
+    // GFLOPS of the single-vector run, reference for the amortisation column
+    double gflops_k1 = 0.0;
+    for (size_t t = 0; t < results.size(); ++t) {
+        if (results[t].k == 1) gflops_k1 = 2.0 * nz / (results[t].best_time_ms / 1000.0) / 1e9;
+    }
+
+    std::cout << "\n=== Parallel CSR SpMM Benchmark Results ===\n";
+    std::cout << "Matrix             : " << matrix_filename << "\n";
+    std::cout << "Dimensions         : " << M << " x " << N << "   (nnz = " << nz << ")\n";
+    std::cout << "Threads            : " << num_threads << "\n\n";
+    std::cout << std::setw(5) << "k" << std::setw(13) << "Best (ms)" << std::setw(10) << "GFLOPS"
+              << std::setw(10) << "GB/s" << std::setw(14) << "FLOP/byte" << std::setw(16) << "ms per vector"
+              << std::setw(10) << "vs k=1" << std::setw(8) << "% roof"
+              << std::setw(12) << "Rel. error" << "\n";
+    // percentage of the triad roofline: the intensity grows with k
+    RooflineCalib roof;
+    roofline_cache_lookup(ROOFLINE_DEFAULT_CACHE, num_threads, roof);
+    for (size_t t = 0; t < results.size(); ++t) {
+        const int k = results[t].k;
+        double best_time_s = results[t].best_time_ms / 1000.0;
+
+        long long flops      = 2LL * nz * k;                                        // 1 mul + 1 add per nonzero and vector
+        double    bytes      = 12.0 * nz + 4.0 * M                                  // matrix streamed once
+                               + 8.0 * k * N + 8.0 * k * M;                         // X read + Y write
+        double gflops = flops / best_time_s / 1e9;
+        double gbs    = bytes / best_time_s / 1e9;
+
+        std::cout << std::setw(5) << k
+                  << std::setw(13) << std::fixed << std::setprecision(3) << results[t].best_time_ms
+                  << std::setw(10) << std::setprecision(2) << gflops
+                  << std::setw(10) << std::setprecision(2) << gbs
+                  << std::setw(14) << std::setprecision(3) << flops / bytes
+                  << std::setw(16) << std::setprecision(4) << results[t].best_time_ms / k
+                  << std::setw(9) << std::setprecision(2) << (gflops_k1 > 0.0 ? gflops / gflops_k1 : 0.0) << "x";
+        const double roof_pct = roofline_percent(roof, gflops, flops / bytes);
+        if (roof_pct < 0.0) {
+            std::cout << std::setw(8) << "-";
+        } else {
+            std::cout << std::setw(8) << std::setprecision(1) << roof_pct;
+        }
+        std::cout << std::setw(12) << std::scientific << std::setprecision(2) << results[t].rel_err
+                  << "\n";
+    }
+    if (roof.threads == 0) {
+        std::cout << "(% roof: not calibrated for " << num_threads << " threads, run parallel_spmv_csr --calibrate)\n";
+    }
+    std::cout << "==========================================\n";
+
+    return 0;
+}
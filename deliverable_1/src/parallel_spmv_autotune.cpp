@@ -0,0 +1,219 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <omp.h>
+#include <algorithm>
+#include <iomanip>
+
+#include "../include/matrix_io.hpp"
+#include "../include/spmv.hpp"
+#include "../include/bench.hpp"
+#include "../include/roofline.hpp"
+#include "../include/perf_counters.hpp"
+
+#define NUM_THREADS 16
+
+extern "C" {
+#include <valgrind/callgrind.h>
+}
+
+int main(int argc, char* argv[]) {
+    bool verbose = false;
+    bool retune = false;
+    long long expected_iters = 0;
+    int trial_iters = SPMV_TRIAL_ITERS;
+    std::string cache_path = SPMV_DEFAULT_TUNING_CACHE;
+    std::string matrix_filename;
+    // validate command-line arguments and print usage if incorrect
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--cache FILE] [--retune] [--iters N] [--trials T] [--verbose] matrix_file.mtx" << std::endl;
+        return 1;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--verbose" || arg == "-v") {
+            verbose = true;
+        } else if (arg == "--retune") {
+            retune = true;
+        } else if (arg == "--cache") {
+            if (i + 1 >= argc) {
+                std::cerr << "--cache needs a file name" << std::endl;
+                return 1;
+            }
+            cache_path = argv[++i];
+        } else if (arg == "--iters") {
+            if (i + 1 >= argc || (expected_iters = std::atoll(argv[++i])) < 0) {
+                std::cerr << "--iters needs a non-negative integer" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--trials") {
+            if (i + 1 >= argc || (trial_iters = std::atoi(argv[++i])) <= 0) {
+                std::cerr << "--trials needs a positive integer" << std::endl;
+                return 1;
+            }
+        } else {
+            matrix_filename = arg;
+        }
+    }
+    // check if no matrix file is passed
+    if (matrix_filename.empty()) {
+        std::cerr << "No matrix file specified." << std::endl;
+        return 1;
+    }
+
+    int M, N, nz;
+    std::vector<int> row_ptr, col_idx;
+    std::vector<double> values;
+    if (!read_matrix_market(matrix_filename, M, N, nz, row_ptr, col_idx, values)) {
+        return 1;
+    }
+
+    // ================= SET THREAD COUNT =================
+    int num_threads = NUM_THREADS;
+    if (getenv("OMP_NUM_THREADS") != nullptr) {
+        num_threads = atoi(getenv("OMP_NUM_THREADS"));
+    }
+    omp_set_num_threads(num_threads);
+    if (verbose) {
+        std::cout << "Using: " << num_threads << " threads\n";
+    }
+
+    // ================= Plan: features, cache lookup or trial runs, conversion =================
+    SpmvOptions opt;
+    opt.autotune = true;
+    opt.retune = retune;
+    opt.tuning_cache = cache_path;
+    opt.trial_iters = trial_iters;
+    opt.expected_iters = expected_iters;
+    opt.num_threads = num_threads;
+    SpmvPlan plan;
+    if (!spmv_plan_create(csr_matrix_view(M, N, row_ptr.data(), col_idx.data(), values.data()), opt, plan)) {
+        return 1;
+    }
+    const SpmvFormat format = plan.format;
+    const MatrixFeatures& features = plan.features;
+    const std::vector<TrialResult>& trials = plan.trials;
+
+    // generate random monodimensional array
+    std::vector<double> x(N), y(M, 0.0);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<double> dis(0.0, 1.0);
+    for (int i = 0; i < N; ++i) {
+        x[i] = dis(gen);
+    }
+
+    auto run_spmv = [&]() {
+        spmv_execute(plan, x.data(), y.data());
+    };
+
+    // ================= Warm-up (until the times are stable, not timed) =================
+    BenchConfig bench_cfg = bench_config_from_env(verbose);
+    BenchStats stats;
+    stats.warmup_iters = bench_warmup(bench_cfg, run_spmv);
+    if (verbose) {
+        std::cout << "Ran " << stats.warmup_iters << " warm-up iterations for autotuned SpMV (" << spmv_format_name(format) << ")" << std::endl;
+    }
+
+    // hardware counters of the timed products (n/a when no PMU is available)
+    PerfRegion perf;
+    perf_region_open(perf, num_threads);
+
+    // toggles callgrind (set to false) collection here
+    CALLGRIND_TOGGLE_COLLECT;
+
+    perf_region_begin(perf);
+    bench_sample(bench_cfg, run_spmv, stats);
+    perf_region_end(perf);
+
+    // toggles callgrind collect (set to true) here
+    CALLGRIND_TOGGLE_COLLECT;
+
+    bench_record(bench_cfg, "parallel_spmv_autotune", matrix_filename, spmv_format_name(format), num_threads, stats);
+
+    // check against a plain CSR product
+    double max_err = 0.0, max_ref = 0.0;
+    for (int r = 0; r < M; ++r) {
+        double sum = 0.0;
+        for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+            sum += values[k] * x[col_idx[k]];
+        }
+        max_err = std::max(max_err, std::fabs(sum - y[r]));
+        max_ref = std::max(max_ref, std::fabs(sum));
+    }
+    double rel_err = max_ref > 0.0 ? max_err / max_ref : max_err;
+
+    double best_time_ms = stats.min_ms;
+    double best_time_s  = best_time_ms / 1000.0;
+    long long flops_per_spmv = 2LL * nz;
+
+    // ================= Results =================
+    std::cout << "\n=== Autotuned SpMV Benchmark Results ===\n";
+    std::cout << "Matrix             : " << matrix_filename << "\n";
+    std::cout << "Dimensions         : " << M << " x " << N << "   (nnz = " << nz << ")\n";
+    std::cout << "Threads            : " << num_threads << "\n";
+    std::cout << "Matrix hash        : " << std::hex << std::setw(16) << std::setfill('0') << plan.hash
+              << std::dec << std::setfill(' ') << "\n";
+    std::cout << "Row length         : mean " << std::fixed << std::setprecision(2) << features.row_mean
+              << ", stddev " << std::sqrt(features.row_var) << ", max " << features.row_max
+              << ", empty " << features.empty_rows << "\n";
+    std::cout << "Bandwidth          : " << features.bandwidth << "\n";
+    std::cout << "Block density      : " << std::setprecision(2) << 100.0 * features.block_density
+              << " %   (" << features.block_r << "x" << features.block_c << " blocks)\n";
+    if (plan.cache_hit) {
+        std::cout << "Tuning cache       : hit (" << cache_path << "), search skipped ("
+                  << std::setprecision(3) << plan.tune_ms << " ms with the features)\n";
+    } else {
+        std::cout << "Tuning cache       : miss, features and search took " << std::setprecision(3) << plan.tune_ms
+                  << " ms (stored in " << cache_path << ")\n\n";
+        std::cout << std::left << std::setw(11) << "Format" << std::setw(8) << "Params" << std::right
+                  << std::setw(13) << "Convert (ms)" << std::setw(11) << "SpMV (ms)"
+                  << std::setw(12) << "Break-even" << "\n";
+        for (size_t t = 0; t < trials.size(); ++t) {
+            const TrialResult& tr = trials[t];
+            std::string params = "-";
+            if (tr.format == FORMAT_SELL) params = std::to_string(tr.param1) + "-" + std::to_string(tr.param2);
+            if (tr.format == FORMAT_BCSR) params = std::to_string(tr.param1) + "x" + std::to_string(tr.param2);
+            std::cout << std::left << std::setw(11) << spmv_format_name(tr.format) << std::setw(8) << params << std::right;
+            if (tr.skipped) {
+                std::cout << "   skipped: " << tr.note << "\n";
+                continue;
+            }
+            std::cout << std::setw(13) << std::setprecision(3) << tr.convert_ms
+                      << std::setw(11) << std::setprecision(4) << tr.spmv_ms;
+            if (tr.break_even < 0.0) {
+                std::cout << std::setw(12) << "never";
+            } else {
+                std::cout << std::setw(12) << std::setprecision(0) << tr.break_even;
+            }
+            std::cout << "\n";
+        }
+        std::cout << "(break-even: SpMVs needed to recover the conversion time against plain CSR)\n\n";
+    }
+
+    std::cout << "Selected format    : " << spmv_plan_describe(plan) << "\n";
+    std::cout << "Conversion time    : " << std::setprecision(3) << plan.setup_ms << " ms\n";
+    std::cout << "Best time          : " << std::setprecision(3) << best_time_ms << " ms\n";
+    std::cout << "Timing             : " << bench_summary(stats) << ", p99 " << stats.p99_ms
+              << " ms, stddev " << stats.stddev_ms << " ms\n";
+    std::cout << "Performance        : " << std::setprecision(2)
+              << flops_per_spmv / best_time_s / 1e9 << " GFLOPS\n";
+    // roofline position with the traffic of CSR (val + 4B col_idx + row_ptr + y), whatever the format
+    RooflineCalib roof;
+    roofline_cache_lookup(ROOFLINE_DEFAULT_CACHE, num_threads, roof);
+    roofline_print(roof, num_threads, flops_per_spmv / best_time_s / 1e9,
+                   flops_per_spmv / (12.0 * nz + 12.0 * M));
+    perf_region_print(perf, nz, stats.samples);
+    std::cout << "Rel. error vs CSR  : " << std::scientific << std::setprecision(3)
+              << rel_err << "\n";
+    std::cout << "==========================================\n";
+
+    perf_region_close(perf);
+    return 0;
+}
@@ -0,0 +1,210 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <omp.h>
+#include <algorithm>
+#include <iomanip>
+
+#include "../include/matrix_io.hpp"
+#include "../include/coo_parallel.hpp"
+#include "../include/merge_path.hpp"
+#include "../include/bench.hpp"
+#include "../include/roofline.hpp"
+
+#define BLOCK_SIZE 10
+#define NUM_THREADS 16
+
+extern "C" {
+#include <valgrind/callgrind.h>
+}
+
+int main(int argc, char* argv[]) {
+    bool verbose = false;
+    std::string matrix_filename;
+    // validate command-line arguments and print usage if incorrect
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " [--verbose] matrix_file.mtx" << std::endl;
+        return 1;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--verbose" || std::string(argv[i]) == "-v") {
+            verbose = true;
+        } else {
+            matrix_filename = argv[i];
+        }
+    }
+    // check if no matrix file is passed
+    if (matrix_filename.empty()) {
+        std::cerr << "No matrix file specified." << std::endl;
+        return 1;
+    }
+
+    // reads .mtx file passed as argument (symmetric files are expanded)
+    int M, N, nz;
+    std::vector<int> row_coo, col_coo;
+    std::vector<double> val_coo;
+    if (!read_matrix_market_coo(matrix_filename, M, N, nz, row_coo, col_coo, val_coo)) {
+        return 1;
+    }
+
+    // ================= SET THREAD COUNT =================
+    int num_threads = NUM_THREADS;
+    if (getenv("OMP_NUM_THREADS") != nullptr) {
+        num_threads = atoi(getenv("OMP_NUM_THREADS"));
+    }
+    omp_set_num_threads(num_threads);
+    if (verbose) {
+        std::cout << "Using: " << num_threads << " threads\n";
+    }
+
+    // ================= Setup of every engine (timed) =================
+    auto t0 = std::chrono::steady_clock::now();
+    coo_sort_by_row(M, nz, row_coo, col_coo, val_coo);
+    CooPlan coo_plan;
+    coo_partition(M, nz, row_coo.data(), num_threads, coo_plan);
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::vector<int> row_ptr, col_idx;
+    std::vector<double> values;
+    // the CSR engines see the duplicates merged, the COO engine all nz entries
+    const int nz_csr = coo_to_csr(M, nz, row_coo, col_coo, val_coo, row_ptr, col_idx, values);
+    auto t2 = std::chrono::steady_clock::now();
+
+    MergePathPlan merge_plan;
+    merge_path_partition(M, row_ptr.data(), num_threads, merge_plan);
+    auto t3 = std::chrono::steady_clock::now();
+
+    const double coo_setup_ms   = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    const double csr_setup_ms   = std::chrono::duration<double, std::milli>(t2 - t1).count();
+    const double merge_setup_ms = csr_setup_ms + std::chrono::duration<double, std::milli>(t3 - t2).count();
+
+    // generate random monodimensional array
+    std::vector<double> x(N), y(M, 0.0), y_ref(M, 0.0);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<double> dis(0.0, 1.0);
+    for (int i = 0; i < N; ++i) {
+        x[i] = dis(gen);
+    }
+
+    // serial reference
+    for (int r = 0; r < M; ++r) {
+        double sum = 0.0;
+        for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+            sum += values[k] * x[col_idx[k]];
+        }
+        y_ref[r] = sum;
+    }
+
+    // ================= Engines compared on the same input =================
+    struct Engine {
+        const char* name;
+        const char* tag;            // kernel column of the result records
+        double setup_ms;
+        double best_time_ms;
+        double median_ms;
+        double rel_err;
+    };
+    std::vector<Engine> engines = {
+        {"COO segmented", "coo/segmented", coo_setup_ms, 0.0, 0.0, 0.0},
+        {"CSR guided", "csr/guided", csr_setup_ms, 0.0, 0.0, 0.0},
+        {"CSR merge-path", "csr/merge-path", merge_setup_ms, 0.0, 0.0, 0.0},
+    };
+
+    auto run_engine = [&](int e) {
+        if (e == 0) {
+            spmv_coo_parallel(coo_plan, M, row_coo.data(), col_coo.data(), val_coo.data(),
+                              x.data(), y.data());
+        } else if (e == 1) {
+            #pragma omp parallel for schedule(guided, BLOCK_SIZE)
+            for (int r = 0; r < M; ++r) {
+                double sum = 0.0;
+                #pragma omp simd reduction(+:sum)
+                for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+                    sum += values[k] * x[col_idx[k]];
+                }
+                y[r] = sum;
+            }
+        } else {
+            spmv_csr_merge(merge_plan, M, row_ptr.data(), col_idx.data(), values.data(),
+                           x.data(), y.data());
+        }
+    };
+
+    BenchConfig bench_cfg = bench_config_from_env(verbose);
+
+    for (size_t e = 0; e < engines.size(); ++e) {
+        auto run_once = [&]() { run_engine(static_cast<int>(e)); };
+        BenchStats stats;
+        stats.warmup_iters = bench_warmup(bench_cfg, run_once);
+        if (verbose) {
+            std::cout << "Ran " << stats.warmup_iters << " warm-up iterations for " << engines[e].name << " SpMV" << std::endl;
+        }
+
+        // toggles callgrind (set to false) collection here
+        CALLGRIND_TOGGLE_COLLECT;
+
+        bench_sample(bench_cfg, run_once, stats);
+
+        // toggles callgrind collect (set to true) here
+        CALLGRIND_TOGGLE_COLLECT;
+
+        double max_err = 0.0, max_ref = 0.0;
+        for (int r = 0; r < M; ++r) {
+            max_err = std::max(max_err, std::fabs(y[r] - y_ref[r]));
+            max_ref = std::max(max_ref, std::fabs(y_ref[r]));
+        }
+        engines[e].best_time_ms = stats.min_ms;
+        engines[e].median_ms = stats.median_ms;
+        bench_record(bench_cfg, "parallel_spmv_coo", matrix_filename, engines[e].tag, num_threads, stats);
+        engines[e].rel_err = max_ref > 0.0 ? max_err / max_ref : max_err;
+    }
+
+    // ================= Results =================
+    std::cout << "\n=== Parallel COO vs CSR SpMV Benchmark Results ===\n";
+    std::cout << "Matrix             : " << matrix_filename << "\n";
+    std::cout << "Dimensions         : " << M << " x " << N << "   (nnz = " << nz_csr;
+    if (nz_csr != nz) std::cout << ", " << nz << " COO entries";
+    std::cout << ")\n";
+    std::cout << "Threads            : " << num_threads << "\n\n";
+    std::cout << std::left << std::setw(16) << "Kernel" << std::right
+              << std::setw(12) << "Setup (ms)" << std::setw(12) << "Best (ms)" << std::setw(13) << "Median (ms)"
+              << std::setw(10) << "GFLOPS" << std::setw(10) << "GB/s" << std::setw(8) << "% roof"
+              << std::setw(12) << "Rel. error" << "\n";
+    // percentage of the triad roofline at the intensity of every kernel
+    RooflineCalib roof;
+    roofline_cache_lookup(ROOFLINE_DEFAULT_CACHE, num_threads, roof);
+    for (size_t e = 0; e < engines.size(); ++e) {
+        double best_time_s = engines[e].best_time_ms / 1000.0;
+        long long flops_per_spmv = 2LL * (e == 0 ? nz : nz_csr);
+        // COO streams a row index per nonzero instead of one row pointer per row
+        double bytes_per_spmv = (e == 0) ? 16.0 * nz + 8.0 * M : 12.0 * nz_csr + 4.0 * M + 8.0 * M;
+
+        std::cout << std::left << std::setw(16) << engines[e].name << std::right
+                  << std::setw(12) << std::fixed << std::setprecision(3) << engines[e].setup_ms
+                  << std::setw(12) << std::setprecision(3) << engines[e].best_time_ms
+                  << std::setw(13) << std::setprecision(3) << engines[e].median_ms
+                  << std::setw(10) << std::setprecision(2) << flops_per_spmv / best_time_s / 1e9
+                  << std::setw(10) << std::setprecision(2) << bytes_per_spmv / best_time_s / 1e9;
+        const double roof_pct = roofline_percent(roof, flops_per_spmv / best_time_s / 1e9, flops_per_spmv / bytes_per_spmv);
+        if (roof_pct < 0.0) {
+            std::cout << std::setw(8) << "-";
+        } else {
+            std::cout << std::setw(8) << std::setprecision(1) << roof_pct;
+        }
+        std::cout << std::setw(12) << std::scientific << std::setprecision(2) << engines[e].rel_err
+                  << "\n";
+    }
+    std::cout << "(CSR setup includes the COO -> CSR conversion of the row-sorted input)\n";
+    if (roof.threads == 0) {
+        std::cout << "(% roof: not calibrated for " << num_threads << " threads, run parallel_spmv_csr --calibrate)\n";
+    }
+    std::cout << "==========================================\n";
+
+    return 0;
+}
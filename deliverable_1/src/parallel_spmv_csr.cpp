@@ -1,30 +1,209 @@
 #include <iostream>
 #include <vector>
-#include <chrono>
-#include <cstdio>
-#include <fstream>
 #include <random>
 #include <omp.h>
 #include <algorithm>
 #include <iomanip>
-#include <fstream>
+#include <cstdlib>
+#include <sstream>
+
+#include "../include/matrix_io.hpp"
+#include "../include/mixed_precision.hpp"
+#include "../include/reorder.hpp"
+#include "../include/spmv.hpp"
+#include "../include/bench.hpp"
+#include "../include/roofline.hpp"
+#include "../include/perf_counters.hpp"
+#include "../include/scaling.hpp"
 
-#define BLOCK_SIZE 10
 #define NUM_THREADS 16
-#define WARMUP_ITERS 3
-#define BENCHMARK_ITERS 10
 
 extern "C" {
-#include "../include/mmio.h"
 #include <valgrind/callgrind.h>
 }
 
+// ================= Thread-scaling sweep (thread counts x OpenMP schedules, cached) =================
+static void run_sweep(const std::string& matrix_filename, int M, int N, int nz, const int* row_ptr,
+                      const int* col_idx, const double* values, const double* x, double* y,
+                      const std::vector<int>& sweep_threads, const std::vector<ScheduleChoice>& sweep_scheds,
+                      bool verbose) {
+    BenchConfig bench_cfg = bench_config_from_env(verbose);
+    ScalingSweep result;
+    scaling_sweep(M, row_ptr, col_idx, values, x, y, sweep_threads, sweep_scheds, bench_cfg, result);
+    scaling_record(bench_cfg, "parallel_spmv_csr", matrix_filename, result);
+    if (!scaling_cache_store(SPMV_DEFAULT_TUNING_CACHE, matrix_hash(M, N, row_ptr, col_idx), result)) {
+        std::cerr << "Warning: unable to write tuning cache " << SPMV_DEFAULT_TUNING_CACHE << std::endl;
+    }
+    scaling_print(result, matrix_filename, M, N, nz, SPMV_DEFAULT_TUNING_CACHE, verbose);
+}
+
+// ================= Benchmark report (verbose) =================
+static void print_report(const std::string& matrix_filename, const SpmvOptions& opt, SpmvPlan& plan,
+                         const ReorderedCsr& reordered, const std::vector<double>& x, const std::vector<double>& y,
+                         double alpha, double beta, const BenchConfig& bench_cfg, const BenchStats& stats,
+                         const PerfRegion& perf) {
+    const CsrMatrix& A = plan.A;
+    const int M = A.M, N = A.N, nz = A.nnz;
+    const int num_threads = plan.num_threads;
+    const bool use_merge_path = plan.format == FORMAT_CSR_MERGE;
+    if (use_merge_path) {
+        const MergePathPlan& merge_plan = plan.dispatch.merge_plan;
+        if (merge_plan.num_parts == 1) {
+            std::cout << "Merge-path partition: single part (one thread or nnz < " << MERGE_PATH_MIN_NNZ
+                      << "), plain CSR loop" << std::endl;
+        } else {
+            int nnz_min = nz, nnz_max = 0;
+            for (int p = 0; p < merge_plan.num_parts; ++p) {
+                int part_nnz = merge_plan.nz_start[p + 1] - merge_plan.nz_start[p];
+                nnz_min = std::min(nnz_min, part_nnz);
+                nnz_max = std::max(nnz_max, part_nnz);
+            }
+            std::cout << "Merge-path partition: nnz per thread min=" << nnz_min
+                      << " max=" << nnz_max << std::endl;
+        }
+    }
+
+    double best_time_ms = stats.min_ms;
+    double best_time_s  = best_time_ms / 1000.0;
+
+    const size_t value_bytes = value_type_bytes(plan.value_type);
+    long long flops_per_spmv   = 2LL * nz;                                     // 1 mul + 1 add per nonzero
+    double    y_bytes          = beta != 0.0 ? 16.0 : 8.0;                     // y written once (read too if beta != 0)
+    double    bytes_per_spmv   = csr_spmv_bytes(nz, M, value_bytes, y_bytes);  // val + 4B col_idx + y
+    if (plan.panel.num_panels > 1) {
+        bytes_per_spmv += 20.0 * plan.panel.rows.size();                        // y read + write and row id per panel row
+    }
+
+    double gflops = flops_per_spmv / best_time_s / 1e9;
+    double gbs    = bytes_per_spmv / best_time_s / 1e9;
+    double arith_intensity = static_cast<double>(flops_per_spmv) / bytes_per_spmv;
+
+    std::cout << "\n=== Parallel CSR SpMV Benchmark Results ===\n";
+    std::cout << "Matrix             : " << matrix_filename << "\n";
+    std::cout << "Dimensions         : " << M << " x " << N << "   (nnz = " << nz << ")\n";
+    std::cout << "Threads            : " << num_threads << "\n";
+    std::cout << "Schedule           : " << (plan.numa ? "static (nnz-balanced)" : use_merge_path ? "merge-path"
+                                      : plan.runtime_schedule ? schedule_describe(plan.schedule) : "guided")
+              << (plan.schedule_cache_hit ? " (tuned)" : "") << "\n";
+    if (reordered.method != REORDER_NONE) {
+        std::cout << "Reordering         : " << reorder_name(reordered.method) << " (ordering " << std::fixed
+                  << std::setprecision(3) << reordered.order_ms << " ms, permutation "
+                  << reordered.permute_ms << " ms)\n";
+        std::cout << "Bandwidth          : " << reordered.bandwidth_before << " -> " << reordered.bandwidth_after << "\n";
+        std::cout << "Profile            : " << reordered.profile_before << " -> " << reordered.profile_after << "\n";
+    }
+    std::cout << "NUMA nodes         : " << plan.topo.num_nodes << "   (affinity " << affinity_name(opt.affinity) << ")\n";
+    if (plan.numa) {
+        std::cout << "Placement          : first touch, static nnz-balanced partition ("
+                  << std::fixed << std::setprecision(3) << plan.setup_ms << " ms)\n";
+    }
+    if (plan.value_type == VALUE_DOUBLE) {
+        const bool streamed = plan.streaming && beta == 0.0 && !use_merge_path;
+        std::cout << "Update             : y = " << alpha << " * A * x + " << beta << " * y   ("
+                  << (streamed ? "streaming" : "regular") << " stores, " << store_policy_name(opt.stores)
+                  << ", LLC " << llc_total_bytes() / (1 << 20) << " MiB)\n";
+    }
+    if (opt.panels) {
+        const int width = panel_width_for_cache(N, opt.panel_budget);
+        std::cout << "Column panels      : ";
+        if (plan.panel.num_panels > 1) {
+            std::cout << plan.panel.num_panels << " panels of " << width << " columns (x panel "
+                      << std::setprecision(2) << width * 8.0 / (1 << 20) << " MiB, "
+                      << plan.panel.rows.size() << " panel rows for " << M << " rows, build "
+                      << std::setprecision(3) << plan.panel.build_ms << " ms)\n";
+        } else {
+            std::cout << "none, x (" << std::setprecision(2) << N * 8.0 / (1 << 20)
+                      << " MiB) fits the budget of " << panel_cache_budget(opt.panel_budget) / double(1 << 20) << " MiB\n";
+        }
+    }
+    if (plan.panel.num_panels > 1) {
+        std::cout << "Kernel             : scalar, column panels\n";
+    } else if (plan.prefetch_distance > 0) {
+        std::cout << "Kernel             : scalar with prefetching (distance " << plan.prefetch_distance << ")\n";
+    } else if (plan.runtime_schedule) {
+        std::cout << "Kernel             : compiler-vectorised, schedule(runtime)\n";
+    } else if (plan.value_type == VALUE_DOUBLE && !plan.numa && !use_merge_path) {
+        std::cout << "Kernel ISA         : " << simd_isa_name(plan.isa) << " (" << simd_isa_name(opt.simd)
+                  << ", CPU supports up to " << simd_isa_name(simd_detect()) << ")\n";
+    }
+    std::cout << "Value type         : " << value_type_name(plan.value_type) << " (" << value_bytes
+              << " bytes, double accumulation)\n";
+    std::cout << "Best time          : " << std::fixed << std::setprecision(3)
+              << best_time_ms << " ms\n";
+    std::cout << "Timing             : " << bench_summary(stats) << ", p99 " << stats.p99_ms
+              << " ms, stddev " << stats.stddev_ms << " ms\n";
+    std::cout << "Performance        : " << std::setprecision(2)
+              << gflops << " GFLOPS\n";
+    std::cout << "Effective Bandwidth: " << std::setprecision(2)
+              << gbs << " GB/s\n";
+    std::cout << "Arithmetic Intensity: " << std::setprecision(3)
+              << arith_intensity << " FLOP/byte\n";
+    RooflineCalib roof;
+    roofline_cache_lookup(ROOFLINE_DEFAULT_CACHE, num_threads, roof);
+    roofline_print(roof, num_threads, gflops, arith_intensity);
+    perf_region_print(perf, nz, stats.samples);
+
+    if (plan.numa) {
+        // one more timed SpMV with per-thread timers
+        spmv_print_numa_nodes(plan, alpha, beta, y_bytes);
+    }
+
+    if (plan.prefetch_distance > 0 || opt.prefetch == SPMV_PREFETCH_AUTO) {
+        if (opt.prefetch == SPMV_PREFETCH_AUTO) {
+            std::cout << "\nPrefetch distance  : " << plan.prefetch_distance << " nonzeros ("
+                      << (plan.prefetch_cache_hit ? "tuning cache" : "searched") << ", "
+                      << std::setprecision(3) << plan.tune_ms << " ms)\n";
+            for (const PrefetchTrial& t : plan.prefetch_trials) {
+                std::cout << "  d = " << std::setw(4) << t.distance << "   " << std::setprecision(3)
+                          << t.spmv_ms << " ms\n";
+            }
+        }
+        // the plan's kernel without prefetching against the prefetching one
+        BenchConfig pf_cfg = bench_cfg;
+        pf_cfg.verbose = false;
+        PrefetchComparison cmp;
+        prefetch_compare(M, A.row_ptr, A.col_idx, A.values, alpha, x.data(), beta, plan.isa,
+                         plan.prefetch_distance, plan.streaming, num_threads, pf_cfg, cmp);
+        prefetch_compare_print(cmp);
+    }
+
+    if (plan.value_type != VALUE_DOUBLE) {
+        // error of the stored values and of y against the double kernel
+        MixedError err;
+        mixed_values_error(plan.mixed, M, A.row_ptr, A.col_idx, A.values, x.data(), y.data(), err);
+        std::cout << "Conversion time    : " << std::setprecision(3) << plan.mixed.convert_ms << " ms\n";
+        std::cout << "Max value rounding : " << std::scientific << std::setprecision(3)
+                  << err.max_value_err << " (relative)\n";
+        if (err.out_of_range > 0) {
+            std::cout << "Warning            : " << err.out_of_range << " values overflow the "
+                      << value_type_name(plan.value_type) << " range (stored as inf)\n";
+        }
+        std::cout << "Rel. error vs double (max): " << err.rel_max_err << "\n";
+        std::cout << "Rel. error vs double (L2) : " << err.rel_l2_err << "\n";
+    }
+    std::cout << "==========================================\n";
+}
+
 int main(int argc, char* argv[]) {
     bool verbose = false;
+    SpmvOptions opt;                        // kernel variant, placement and schedule of the plan
+    ReorderMethod reorder = REORDER_NONE;
+    double alpha = 1.0, beta = 0.0;
+    bool calibrate = false;
+    bool sweep = false;
+    std::vector<int> sweep_threads;
+    std::vector<ScheduleChoice> sweep_scheds;
+    schedule_list_from_string(SCALING_SCHEDULES, sweep_scheds);
     std::string matrix_filename;
     // validate command-line arguments and print usage if incorrect
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " matrix_file.mtx" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " [--schedule guided|merge|tuned|static|dynamic|guided:CHUNK] [--precision double|float|bf16|fp16]"
+                  << " [--reorder none|rcm|degree|gorder] [--numa] [--affinity none|compact|scatter|socket]"
+                  << " [--alpha A] [--beta B] [--stores auto|regular|streaming]"
+                  << " [--simd auto|compiler|scalar|avx2|avx512] [--prefetch off|auto|D]"
+                  << " [--panels auto|BYTES[K|M|G]] [--calibrate]"
+                  << " [--sweep] [--sweep-threads 1,2,4] [--sweep-schedules static,dynamic:64,...]"
+                  << " [--verbose] matrix_file.mtx|matrix_file.csrb" << std::endl;
         return 1;
     }
     
@@ -32,85 +211,167 @@ int main(int argc, char* argv[]) {
     for(int i = 1; i < argc; ++i) {
         if (std::string(argv[i]) == "--verbose" || std::string(argv[i]) == "-v") {
             verbose = true;
+        } else if (std::string(argv[i]) == "--schedule" || std::string(argv[i]) == "-s") {
+            std::string schedule = (i + 1 < argc) ? argv[++i] : "";
+            if (schedule == "merge") {
+                opt.format = FORMAT_CSR_MERGE;
+            } else if (schedule == "tuned") {
+                opt.tuned_schedule = true;
+            } else if (schedule != "guided") {
+                // an explicit OpenMP schedule: static, dynamic:64, guided:1, ...
+                if (!schedule_from_string(schedule, opt.schedule)) {
+                    std::cerr << "--schedule must be 'guided', 'merge', 'tuned' or an OpenMP schedule "
+                              << "(static|dynamic|guided, optionally :CHUNK)" << std::endl;
+                    return 1;
+                }
+                opt.runtime_schedule = true;
+            }
+        } else if (std::string(argv[i]) == "--precision" || std::string(argv[i]) == "-p") {
+            if (i + 1 >= argc || !value_type_from_name(argv[++i], opt.value_type)) {
+                std::cerr << "--precision must be 'double', 'float', 'bf16' or 'fp16'" << std::endl;
+                return 1;
+            }
+        } else if (std::string(argv[i]) == "--reorder" || std::string(argv[i]) == "-r") {
+            if (i + 1 >= argc || !reorder_from_name(argv[++i], reorder)) {
+                std::cerr << "--reorder must be 'none', 'rcm', 'degree' or 'gorder'" << std::endl;
+                return 1;
+            }
+        } else if (std::string(argv[i]) == "--numa") {
+            opt.numa = true;
+        } else if (std::string(argv[i]) == "--affinity" || std::string(argv[i]) == "-a") {
+            if (i + 1 >= argc || !affinity_from_name(argv[++i], opt.affinity)) {
+                std::cerr << "--affinity must be 'none', 'compact', 'scatter' or 'socket'" << std::endl;
+                return 1;
+            }
+        } else if (std::string(argv[i]) == "--alpha" || std::string(argv[i]) == "--beta") {
+            if (i + 1 >= argc) {
+                std::cerr << argv[i] << " needs a value" << std::endl;
+                return 1;
+            }
+            (std::string(argv[i]) == "--alpha" ? alpha : beta) = std::atof(argv[i + 1]);
+            ++i;
+        } else if (std::string(argv[i]) == "--stores") {
+            if (i + 1 >= argc || !store_policy_from_name(argv[++i], opt.stores)) {
+                std::cerr << "--stores must be 'auto', 'regular' or 'streaming'" << std::endl;
+                return 1;
+            }
+        } else if (std::string(argv[i]) == "--simd") {
+            if (i + 1 >= argc || !simd_isa_from_name(argv[++i], opt.simd)) {
+                std::cerr << "--simd must be 'auto', 'compiler', 'scalar', 'avx2' or 'avx512'" << std::endl;
+                return 1;
+            }
+        } else if (std::string(argv[i]) == "--panels") {
+            // cache budget of the x panel: "auto" (from the LLC) or a size like 512K, 16M
+            std::string value = (i + 1 < argc) ? argv[++i] : "";
+            opt.panels = true;
+            if (value != "auto") {
+                char* end = nullptr;
+                long long& panel_budget = opt.panel_budget;
+                panel_budget = std::strtoll(value.c_str(), &end, 10);
+                const std::string unit = end ? end : "";
+                if (unit == "K" || unit == "k") panel_budget <<= 10;
+                else if (unit == "M" || unit == "m") panel_budget <<= 20;
+                else if (unit == "G" || unit == "g") panel_budget <<= 30;
+                else if (!unit.empty()) panel_budget = 0;
+                if (panel_budget <= 0) {
+                    std::cerr << "--panels must be 'auto' or a positive size (e.g. 512K, 16M)" << std::endl;
+                    return 1;
+                }
+            }
+        } else if (std::string(argv[i]) == "--calibrate") {
+            calibrate = true;
+        } else if (std::string(argv[i]) == "--sweep") {
+            sweep = true;
+        } else if (std::string(argv[i]) == "--sweep-threads") {
+            sweep = true;
+            sweep_threads.clear();
+            std::stringstream list((i + 1 < argc) ? argv[++i] : "");
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                int threads = std::atoi(item.c_str());
+                if (threads <= 0) {
+                    sweep_threads.clear();
+                    break;
+                }
+                sweep_threads.push_back(threads);
+            }
+            if (sweep_threads.empty()) {
+                std::cerr << "--sweep-threads needs a comma separated list of positive integers" << std::endl;
+                return 1;
+            }
+        } else if (std::string(argv[i]) == "--sweep-schedules") {
+            sweep = true;
+            if (i + 1 >= argc || !schedule_list_from_string(argv[++i], sweep_scheds)) {
+                std::cerr << "--sweep-schedules needs a comma separated list of static|dynamic|guided[:CHUNK]" << std::endl;
+                return 1;
+            }
+        } else if (std::string(argv[i]) == "--prefetch") {
+            std::string value = (i + 1 < argc) ? argv[++i] : "";
+            if (value == "off") {
+                opt.prefetch = 0;
+            } else if (value == "auto") {
+                opt.prefetch = SPMV_PREFETCH_AUTO;
+            } else if ((opt.prefetch = std::atoi(value.c_str())) <= 0) {
+                std::cerr << "--prefetch must be 'off', 'auto' or a positive distance" << std::endl;
+                return 1;
+            }
         } else {
             matrix_filename = argv[i];
         }
     }
+    // ================= Roofline calibration (1, 2, 4, ... threads, cached) =================
+    if (calibrate) {
+        int max_threads = NUM_THREADS;
+        if (getenv("OMP_NUM_THREADS") != nullptr) {
+            max_threads = atoi(getenv("OMP_NUM_THREADS"));
+        }
+        std::vector<RooflineCalib> calibs;
+        if (!roofline_calibrate_sweep(ROOFLINE_DEFAULT_CACHE, max_threads, calibs)) {
+            std::cerr << "Warning: unable to write " << ROOFLINE_DEFAULT_CACHE << std::endl;
+        }
+        roofline_print_calibration(calibs);
+        if (matrix_filename.empty()) {
+            return 0;
+        }
+    }
+
     // check if no matrix file is passed
     if (matrix_filename.empty()) {
         std::cerr << "No matrix file specified." << std::endl;
         return 1;
     }
-    
-    // reads mtx file passed as argument
-    FILE* f = fopen(matrix_filename.c_str(), "r");
-    if (f == nullptr) {
-        std::cerr << "Could not open file: " << matrix_filename << std::endl;
-        return 1;
-    }
-    
-    // reads matrix banner
-    MM_typecode matcode;
-    if (mm_read_banner(f, &matcode) != 0) {
-        std::cerr << "Could not process Matrix Market banner." << std::endl;
-        fclose(f);
+    if ((alpha != 1.0 || beta != 0.0) && opt.value_type != VALUE_DOUBLE) {
+        std::cerr << "--alpha / --beta only support double values" << std::endl;
         return 1;
     }
-
-    // check matrix type: must be real, sparse matrix
-    if (!mm_is_matrix(matcode) || !mm_is_sparse(matcode) || mm_is_complex(matcode)) {
-        std::cerr << "Only real-valued sparse matrices supported." << std::endl;
-        fclose(f);
+    if (sweep && (opt.numa || opt.prefetch != 0 || opt.panels || opt.value_type != VALUE_DOUBLE ||
+                  opt.format != FORMAT_CSR || alpha != 1.0 || beta != 0.0)) {
+        std::cerr << "--sweep only applies to the plain double CSR kernel (y = A * x)" << std::endl;
         return 1;
     }
-
-    // reads matrix size
-    int M, N, nz;
-    if (mm_read_mtx_crd_size(f, &M, &N, &nz) != 0) {
-        std::cerr << "Could not read matrix size." << std::endl;
-        fclose(f);
+    
+    // reads mtx file passed as argument and converts it to CSR
+    // (symmetric files are expanded to the full matrix); .csrb files are
+    // mapped and used in place
+    LoadedCsr A;
+    MtxLoadStats load;
+    if (!load_csr(matrix_filename, A, &load)) {
         return 1;
     }
-
-    // creates coo row_index, col_index, and values vector
-    std::vector<int> row_coo(nz), col_coo(nz);
-    std::vector<double> val_coo(nz);
-    for (int i = 0; i < nz; ++i) {
-        int r, c;
-        double v;
-        if (fscanf(f, "%d %d %lf", &r, &c, &v) != 3) {
-            std::cerr << "Error reading matrix entry." << std::endl;
-            fclose(f);
-            return 1;
-        }
-        // Convert to 0-based indexing
-        row_coo[i] = r - 1;
-        col_coo[i] = c - 1;
-        val_coo[i] = v;
+    const int M = A.M, N = A.N, nz = A.nnz;
+    const int* row_ptr = A.row_ptr;
+    const int* col_idx = A.col_idx;
+    const double* values = A.values;
+    if (verbose && A.mapped) {
+        std::cout << "Mapped " << matrix_filename << " in " << load.total_ms << " ms (zero copy)" << std::endl;
+    } else if (verbose) {
+        std::cout << "Loaded " << matrix_filename << " in " << load.total_ms << " ms (parse "
+                  << load.parse_mb_per_s() << " MB/s on " << load.threads << " threads, CSR conversion "
+                  << load.convert_ms << " ms)" << std::endl;
     }
-    fclose(f);
-
-    // ================= COO -> CSR conversion =================
-    std::vector<int> row_ptr(M + 1, 0);
-    std::vector<int> col_idx(nz);
-    std::vector<double> values(nz);
-
-    // count nonzeros per row
-    for (int i = 0; i < nz; ++i)
-        row_ptr[row_coo[i] + 1]++;
-
-    // prefix sum for row_ptr
-    for (int i = 0; i < M; ++i)
-        row_ptr[i + 1] += row_ptr[i];
-
-    // insert values and columns in correct position
-    std::vector<int> fill(M, 0);
-    for (int i = 0; i < M; ++i) fill[i] = row_ptr[i];
-    for (int i = 0; i < nz; ++i) {
-        int r = row_coo[i];
-        int dest = fill[r]++;
-        col_idx[dest] = col_coo[i];
-        values[dest] = val_coo[i];
+    if (reorder != REORDER_NONE && M != N) {
+        std::cerr << "--reorder needs a square matrix" << std::endl;
+        return 1;
     }
 
     // generate random monodimensional array
@@ -122,39 +383,6 @@ int main(int argc, char* argv[]) {
         x[i] = dis(gen);
     }
     
-    // ================= Warm-up (3 iterations, not timed) =================
-    if (verbose) {
-        std::cout << "Running 3 warm-up iterations for parallel CSR SpMV..." << std::endl;
-    }
-    for (int i = 0; i < WARMUP_ITERS; ++i) {
-        #pragma omp parallel
-        {
-            #pragma omp for schedule(static) nowait
-            for (int i = 0; i < M; ++i) y[i] = 0.0;
-            
-            #pragma omp for schedule(guided, BLOCK_SIZE) nowait
-            for (int r = 0; r < M; ++r) {
-                double sum = 0.0;
-                #pragma omp simd reduction(+:sum)
-                for (int k = row_ptr[r]; k < row_ptr[r+1]; ++k) {
-                    sum += values[k] * x[col_idx[k]];
-                }
-                y[r] = sum;
-            }
-        }
-    }
-
-    // this will clear the file content
-    std::ofstream ofs("../benchmarks/Parallel_CSR_exec_times.txt", std::ofstream::out | std::ofstream::trunc);
-    ofs.close();
-    
-    
-    // writes execution times to file
-    std::ofstream outfile("../benchmarks/Parallel_CSR_exec_times.txt", std::ios_base::app);
-    if (!outfile.is_open()) {
-        std::cerr << "Warning: unable to open exec_time file for writing \n";
-    }
-    
     // ================= SET THREAD COUNT =================
     int num_threads = NUM_THREADS;
     if (getenv("OMP_NUM_THREADS") != nullptr) {
@@ -164,81 +392,96 @@ int main(int argc, char* argv[]) {
     if (verbose) {
         std::cout << "Using: " << num_threads << " threads\n";
     }
-    
-    // toggles callgrind (set to false) collection here
-    CALLGRIND_TOGGLE_COLLECT;
-    
-    for (int i = 0; i < BENCHMARK_ITERS; ++i) {
-        // ================= Parallel SpMV =================
-        // starts timing
-        auto start = std::chrono::steady_clock::now();
-        
-        #pragma omp parallel
-        {
-            #pragma omp for schedule(static) nowait
-            for (int i = 0; i < M; i++) {
-                y[i] = 0.0;
-            }
-            
-            #pragma omp for schedule(guided, BLOCK_SIZE) nowait
-            for (int r = 0; r < M; ++r) {
-                double sum = 0.0;
-                
-                #pragma omp simd reduction(+:sum)
-                for (int k = row_ptr[r]; k < row_ptr[r+1]; ++k) {
-                    sum += values[k] * x[col_idx[k]];
-                }
-                y[r] = sum;
+
+    // ================= Reordering stage (B = P A P^T) =================
+    // x is random, so it is generated directly in the new numbering
+    ReorderedCsr reordered;
+    if (reorder != REORDER_NONE) {
+        reorder_csr(reorder, M, row_ptr, col_idx, values, reordered);
+        row_ptr = reordered.row_ptr.data();
+        col_idx = reordered.col_idx.data();
+        values = reordered.values.data();
+    }
+
+    if (sweep) {
+        if (sweep_threads.empty()) {
+            for (int t = 1;; t = std::min(2 * t, num_threads)) {
+                sweep_threads.push_back(t);
+                if (t == num_threads) break;
             }
         }
-        // =====================================
-        // stops timing
-        auto end = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration<double, std::milli>(end - start);
-        
-        if (verbose) {
-            std::cout << "Multiplication took " << elapsed.count() << " ms" << std::endl;
-        }
-        // writes to benchmark file
-        outfile << elapsed.count() << "\n";
+        run_sweep(matrix_filename, M, N, nz, row_ptr, col_idx, values, x.data(), y.data(),
+                  sweep_threads, sweep_scheds, verbose);
+        return 0;
+    }
+
+    // ================= SpMV plan (pinning, partition, placement, value copy, schedule) =================
+    // --schedule tuned: with OMP_NUM_THREADS set, the best schedule of that
+    // thread count; otherwise the thread count and schedule of the overall choice
+    opt.num_threads = opt.tuned_schedule && getenv("OMP_NUM_THREADS") == nullptr ? 0 : num_threads;
+    SpmvPlan plan;
+    if (!spmv_plan_create(csr_matrix_view(M, N, row_ptr, col_idx, values), opt, plan)) {
+        return 1;
+    }
+    num_threads = plan.num_threads;
+    if (verbose && plan.schedule_cache_hit) {
+        std::cout << "Tuned configuration: " << num_threads << " threads, schedule "
+                  << schedule_describe(plan.schedule) << std::endl;
+    }
+    if (opt.simd != SIMD_AUTO && plan.isa != opt.simd) {
+        std::cerr << "Warning: this CPU has no " << simd_isa_name(opt.simd) << " support, using "
+                  << simd_isa_name(plan.isa) << std::endl;
+    }
+    // NUMA plans multiply on the copies placed by first touch: x is written
+    // into its copy once, not on every product
+    const double* plan_x = x.data();
+    double* plan_y = y.data();
+    if (plan.numa) {
+        std::copy(x.begin(), x.end(), plan.numa_x.begin());
+        std::copy(y.begin(), y.end(), plan.numa_y.begin());
+        plan_x = plan.numa_x.data();
+        plan_y = plan.numa_y.data();
     }
+
+    // runs one SpMV with the kernel of the plan
+    auto run_spmv = [&]() {
+        spmv_execute_axpby(plan, alpha, plan_x, beta, plan_y);
+    };
+
+    // ================= Warm-up (until the times are stable, not timed) =================
+    BenchConfig bench_cfg = bench_config_from_env(verbose);
+    BenchStats stats;
+    stats.warmup_iters = bench_warmup(bench_cfg, run_spmv);
+    if (verbose) {
+        std::cout << "Ran " << stats.warmup_iters << " warm-up iterations for parallel CSR SpMV" << std::endl;
+    }
+
+    // hardware counters of the timed products (n/a when no PMU is available)
+    PerfRegion perf;
+    perf_region_open(perf, num_threads);
+
+    // toggles callgrind (set to false) collection here
+    CALLGRIND_TOGGLE_COLLECT;
+
+    // ================= Parallel SpMV (until the median is known to BENCH_CI_TARGET) =================
+    perf_region_begin(perf);
+    bench_sample(bench_cfg, run_spmv, stats);
+    perf_region_end(perf);
+
     // toggles callgrind collect (set to true) here
     CALLGRIND_TOGGLE_COLLECT;
 
-    outfile.close();
+    bench_record(bench_cfg, "parallel_spmv_csr", matrix_filename,
+                 spmv_plan_tag(plan) + (beta != 0.0 ? "/axpby" : ""), num_threads, stats);
+
+    if (plan.numa) {
+        std::copy(plan.numa_y.begin(), plan.numa_y.end(), y.begin());
+    }
     
     if (verbose) {
-        std::vector<double> times_ms(BENCHMARK_ITERS);
-        std::ifstream times_file("../benchmarks/Parallel_CSR_exec_times.txt");
-        for (int i = 0; i < BENCHMARK_ITERS; ++i) {
-            times_file >> times_ms[i];
-        }
-        times_file.close();
-        
-        double best_time_ms = *std::min_element(times_ms.begin(), times_ms.end());
-        double best_time_s  = best_time_ms / 1000.0;
-        
-        long long flops_per_spmv   = 2LL * nz;                                     // 1 mul + 1 add per nonzero
-        double    bytes_per_spmv   = 12.0 * nz + 16.0 * M;                         // 8B val + 4B col_idx + ~16B for y (zero+write)
-        
-        double gflops = flops_per_spmv / best_time_s / 1e9;
-        double gbs    = bytes_per_spmv / best_time_s / 1e9;
-        double arith_intensity = static_cast<double>(flops_per_spmv) / bytes_per_spmv;
-        
-        std::cout << "\n=== Parallel CSR SpMV Benchmark Results ===\n";
-        std::cout << "Matrix             : " << matrix_filename << "\n";
-        std::cout << "Dimensions         : " << M << " x " << N << "   (nnz = " << nz << ")\n";
-        std::cout << "Threads            : " << num_threads << "\n";
-        std::cout << "Best time          : " << std::fixed << std::setprecision(3) 
-                  << best_time_ms << " ms\n";
-        std::cout << "Performance        : " << std::setprecision(2) 
-                  << gflops << " GFLOPS\n";
-        std::cout << "Effective Bandwidth: " << std::setprecision(2) 
-                  << gbs << " GB/s\n";
-        std::cout << "Arithmetic Intensity: " << std::setprecision(3) 
-                  << arith_intensity << " FLOP/byte\n";
-        std::cout << "==========================================\n";
+        print_report(matrix_filename, opt, plan, reordered, x, y, alpha, beta, bench_cfg, stats, perf);
     }
 
+    perf_region_close(perf);
     return 0;
 }
@@ -0,0 +1,201 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <omp.h>
+#include <algorithm>
+#include <iomanip>
+
+#include "../include/matrix_io.hpp"
+#include "../include/csr_du.hpp"
+#include "../include/bench.hpp"
+#include "../include/roofline.hpp"
+
+#define BLOCK_SIZE 10
+#define NUM_THREADS 16
+
+extern "C" {
+#include <valgrind/callgrind.h>
+}
+
+int main(int argc, char* argv[]) {
+    bool verbose = false;
+    std::string matrix_filename;
+    // validate command-line arguments and print usage if incorrect
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " [--verbose] matrix_file.mtx" << std::endl;
+        return 1;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--verbose" || std::string(argv[i]) == "-v") {
+            verbose = true;
+        } else {
+            matrix_filename = argv[i];
+        }
+    }
+    // check if no matrix file is passed
+    if (matrix_filename.empty()) {
+        std::cerr << "No matrix file specified." << std::endl;
+        return 1;
+    }
+
+    // reads .mtx file passed as argument and converts it to CSR
+    int M, N, nz;
+    std::vector<int> row_ptr, col_idx;
+    std::vector<double> values;
+    if (!read_matrix_market(matrix_filename, M, N, nz, row_ptr, col_idx, values)) {
+        return 1;
+    }
+
+    // ================= SET THREAD COUNT =================
+    int num_threads = NUM_THREADS;
+    if (getenv("OMP_NUM_THREADS") != nullptr) {
+        num_threads = atoi(getenv("OMP_NUM_THREADS"));
+    }
+    omp_set_num_threads(num_threads);
+    if (verbose) {
+        std::cout << "Using: " << num_threads << " threads\n";
+    }
+
+    // ================= CSR -> CSR-DU conversion =================
+    CsrduMatrix du;
+    auto conv_start = std::chrono::steady_clock::now();
+    if (!csr_to_csrdu(M, N, row_ptr.data(), col_idx.data(), values.data(), du)) {
+        return 1;
+    }
+    auto conv_end = std::chrono::steady_clock::now();
+    double conv_ms = std::chrono::duration<double, std::milli>(conv_end - conv_start).count();
+
+    // index bytes read per SpMV: col_idx + row_ptr for CSR
+    const long long csr_index_bytes = 4LL * nz + 4LL * (M + 1);
+    const long long du_index_bytes = csrdu_index_bytes(du);
+
+    // generate random monodimensional array
+    std::vector<double> x(N), y(M, 0.0), y_ref(M, 0.0);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<double> dis(0.0, 1.0);
+    for (int i = 0; i < N; ++i) {
+        x[i] = dis(gen);
+    }
+
+    // serial reference
+    for (int r = 0; r < M; ++r) {
+        double sum = 0.0;
+        for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+            sum += values[k] * x[col_idx[k]];
+        }
+        y_ref[r] = sum;
+    }
+
+    // ================= Engines compared on the same input =================
+    struct Engine {
+        const char* name;
+        const char* tag;            // kernel column of the result records
+        double setup_ms;
+        double best_time_ms;
+        double median_ms;
+        double rel_err;
+    };
+    std::vector<Engine> engines = {
+        {"CSR", "csr", 0.0, 0.0, 0.0, 0.0},
+        {"CSR-DU", "csr-du", conv_ms, 0.0, 0.0, 0.0},
+    };
+
+    auto run_engine = [&](int e) {
+        if (e == 0) {
+            #pragma omp parallel for schedule(guided, BLOCK_SIZE)
+            for (int r = 0; r < M; ++r) {
+                double sum = 0.0;
+                #pragma omp simd reduction(+:sum)
+                for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+                    sum += values[k] * x[col_idx[k]];
+                }
+                y[r] = sum;
+            }
+        } else {
+            spmv_csrdu(du, x.data(), y.data());
+        }
+    };
+
+    BenchConfig bench_cfg = bench_config_from_env(verbose);
+
+    for (size_t e = 0; e < engines.size(); ++e) {
+        auto run_once = [&]() { run_engine(static_cast<int>(e)); };
+        BenchStats stats;
+        stats.warmup_iters = bench_warmup(bench_cfg, run_once);
+        if (verbose) {
+            std::cout << "Ran " << stats.warmup_iters << " warm-up iterations for " << engines[e].name << " SpMV" << std::endl;
+        }
+
+        // toggles callgrind (set to false) collection here
+        CALLGRIND_TOGGLE_COLLECT;
+
+        bench_sample(bench_cfg, run_once, stats);
+
+        // toggles callgrind collect (set to true) here
+        CALLGRIND_TOGGLE_COLLECT;
+
+        double max_err = 0.0, max_ref = 0.0;
+        for (int r = 0; r < M; ++r) {
+            max_err = std::max(max_err, std::fabs(y[r] - y_ref[r]));
+            max_ref = std::max(max_ref, std::fabs(y_ref[r]));
+        }
+        engines[e].best_time_ms = stats.min_ms;
+        engines[e].median_ms = stats.median_ms;
+        bench_record(bench_cfg, "parallel_spmv_csrdu", matrix_filename, engines[e].tag, num_threads, stats);
+        engines[e].rel_err = max_ref > 0.0 ? max_err / max_ref : max_err;
+    }
+
+    // ================= Results =================
+    std::cout << "\n=== Parallel CSR-DU SpMV Benchmark Results ===\n";
+    std::cout << "Matrix             : " << matrix_filename << "\n";
+    std::cout << "Dimensions         : " << M << " x " << N << "   (nnz = " << nz << ")\n";
+    std::cout << "Threads            : " << num_threads << "\n";
+    std::cout << "Units              : " << du.num_units << "   (" << du.units8 << " with 8-bit offsets, "
+              << std::fixed << std::setprecision(2)
+              << (du.num_units > 0 ? static_cast<double>(nz) / du.num_units : 0.0) << " nnz per unit)\n";
+    std::cout << "Index bytes        : " << csr_index_bytes << " (CSR) -> " << du_index_bytes << " (CSR-DU)\n";
+    std::cout << "Compression ratio  : " << std::setprecision(2)
+              << (du_index_bytes > 0 ? static_cast<double>(csr_index_bytes) / du_index_bytes : 0.0)
+              << "x on indices, "
+              << (12.0 * nz + 4.0 * (M + 1)) / (8.0 * nz + du_index_bytes) << "x on the whole matrix\n\n";
+    std::cout << std::left << std::setw(10) << "Kernel" << std::right
+              << std::setw(12) << "Setup (ms)" << std::setw(12) << "Best (ms)" << std::setw(13) << "Median (ms)"
+              << std::setw(10) << "GFLOPS" << std::setw(10) << "GB/s" << std::setw(8) << "% roof"
+              << std::setw(12) << "Rel. error" << "\n";
+    // percentage of the triad roofline at the intensity of every kernel
+    RooflineCalib roof;
+    roofline_cache_lookup(ROOFLINE_DEFAULT_CACHE, num_threads, roof);
+    for (size_t e = 0; e < engines.size(); ++e) {
+        double best_time_s = engines[e].best_time_ms / 1000.0;
+        long long flops_per_spmv = 2LL * nz;
+        // 8B value per nonzero + index stream + 8B x (once) and y per row
+        double bytes_per_spmv = 8.0 * nz + (e == 0 ? csr_index_bytes : du_index_bytes) + 8.0 * M;
+
+        std::cout << std::left << std::setw(10) << engines[e].name << std::right
+                  << std::setw(12) << std::fixed << std::setprecision(3) << engines[e].setup_ms
+                  << std::setw(12) << std::setprecision(3) << engines[e].best_time_ms
+                  << std::setw(13) << std::setprecision(3) << engines[e].median_ms
+                  << std::setw(10) << std::setprecision(2) << flops_per_spmv / best_time_s / 1e9
+                  << std::setw(10) << std::setprecision(2) << bytes_per_spmv / best_time_s / 1e9;
+        const double roof_pct = roofline_percent(roof, flops_per_spmv / best_time_s / 1e9, flops_per_spmv / bytes_per_spmv);
+        if (roof_pct < 0.0) {
+            std::cout << std::setw(8) << "-";
+        } else {
+            std::cout << std::setw(8) << std::setprecision(1) << roof_pct;
+        }
+        std::cout << std::setw(12) << std::scientific << std::setprecision(2) << engines[e].rel_err
+                  << "\n";
+    }
+    if (roof.threads == 0) {
+        std::cout << "(% roof: not calibrated for " << num_threads << " threads, run parallel_spmv_csr --calibrate)\n";
+    }
+    std::cout << "==========================================\n";
+
+    return 0;
+}
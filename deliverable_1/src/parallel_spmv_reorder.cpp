@@ -0,0 +1,250 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <sstream>
+#include <random>
+#include <omp.h>
+#include <algorithm>
+#include <iomanip>
+
+#include "../include/matrix_io.hpp"
+#include "../include/reorder.hpp"
+#include "../include/bench.hpp"
+#include "../include/roofline.hpp"
+
+#define BLOCK_SIZE 10
+#define NUM_THREADS 16
+
+extern "C" {
+#include <valgrind/callgrind.h>
+}
+
+int main(int argc, char* argv[]) {
+    bool verbose = false;
+    std::string matrix_filename;
+    std::vector<ReorderMethod> methods = {REORDER_NONE, REORDER_RCM, REORDER_DEGREE, REORDER_GORDER};
+    // validate command-line arguments and print usage if incorrect
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " [--method none,rcm,degree,gorder] [--verbose] matrix_file.mtx" << std::endl;
+        return 1;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--verbose" || arg == "-v") {
+            verbose = true;
+        } else if (arg == "--method" || arg == "-m") {
+            methods.clear();
+            std::stringstream list((i + 1 < argc) ? argv[++i] : "");
+            std::string item;
+            ReorderMethod method;
+            while (std::getline(list, item, ',')) {
+                if (!reorder_from_name(item, method)) {
+                    std::cerr << "--method needs a comma separated list of none, rcm, degree, gorder" << std::endl;
+                    return 1;
+                }
+                methods.push_back(method);
+            }
+            if (methods.empty()) {
+                std::cerr << "--method needs a comma separated list of none, rcm, degree, gorder" << std::endl;
+                return 1;
+            }
+        } else {
+            matrix_filename = arg;
+        }
+    }
+    // check if no matrix file is passed
+    if (matrix_filename.empty()) {
+        std::cerr << "No matrix file specified." << std::endl;
+        return 1;
+    }
+    // "none" is the baseline of the break-even column
+    if (std::find(methods.begin(), methods.end(), REORDER_NONE) == methods.end()) {
+        methods.insert(methods.begin(), REORDER_NONE);
+    }
+
+    int M, N, nz;
+    std::vector<int> row_ptr, col_idx;
+    std::vector<double> values;
+    if (!read_matrix_market(matrix_filename, M, N, nz, row_ptr, col_idx, values)) {
+        return 1;
+    }
+    if (M != N) {
+        std::cerr << "Reordering needs a square matrix (" << M << " x " << N << ")" << std::endl;
+        return 1;
+    }
+
+    // ================= SET THREAD COUNT =================
+    int num_threads = NUM_THREADS;
+    if (getenv("OMP_NUM_THREADS") != nullptr) {
+        num_threads = atoi(getenv("OMP_NUM_THREADS"));
+    }
+    omp_set_num_threads(num_threads);
+    if (verbose) {
+        std::cout << "Using: " << num_threads << " threads\n";
+    }
+
+    // generate random monodimensional array
+    std::vector<double> x(N), y_ref(M, 0.0);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<double> dis(0.0, 1.0);
+    for (int i = 0; i < N; ++i) {
+        x[i] = dis(gen);
+    }
+    for (int r = 0; r < M; ++r) {
+        double sum = 0.0;
+        for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+            sum += values[k] * x[col_idx[k]];
+        }
+        y_ref[r] = sum;
+    }
+
+    BenchConfig bench_cfg = bench_config_from_env(verbose);
+
+    struct ReorderResult {
+        ReorderMethod method;
+        double order_ms;
+        double permute_ms;
+        long long bandwidth;
+        long long profile;
+        double best_time_ms;
+        double rel_err;
+    };
+    std::vector<ReorderResult> results;
+
+    for (size_t m = 0; m < methods.size(); ++m) {
+        ReorderResult res;
+        res.method = methods[m];
+
+        // ================= Ordering and permutation (timed separately) =================
+        std::vector<int> perm;
+        auto t0 = std::chrono::steady_clock::now();
+        compute_permutation(res.method, M, row_ptr.data(), col_idx.data(), perm);
+        auto t1 = std::chrono::steady_clock::now();
+
+        std::vector<int> p_row_ptr, p_col_idx;
+        std::vector<double> p_values, p_x(N), p_y(M, 0.0), y(M, 0.0);
+        auto t2 = std::chrono::steady_clock::now();
+        if (res.method == REORDER_NONE) {
+            p_row_ptr = row_ptr;
+            p_col_idx = col_idx;
+            p_values = values;
+            p_x = x;
+        } else {
+            permute_csr(M, row_ptr.data(), col_idx.data(), values.data(), perm, p_row_ptr, p_col_idx, p_values);
+            permute_vector(N, perm, x.data(), p_x.data());
+        }
+        auto t3 = std::chrono::steady_clock::now();
+
+        res.order_ms = res.method == REORDER_NONE ? 0.0 : std::chrono::duration<double, std::milli>(t1 - t0).count();
+        res.permute_ms = res.method == REORDER_NONE ? 0.0 : std::chrono::duration<double, std::milli>(t3 - t2).count();
+        bandwidth_profile(M, p_row_ptr.data(), p_col_idx.data(), res.bandwidth, res.profile);
+
+        auto run_spmv = [&]() {
+            #pragma omp parallel for schedule(guided, BLOCK_SIZE)
+            for (int r = 0; r < M; ++r) {
+                double sum = 0.0;
+                #pragma omp simd reduction(+:sum)
+                for (int k = p_row_ptr[r]; k < p_row_ptr[r + 1]; ++k) {
+                    sum += p_values[k] * p_x[p_col_idx[k]];
+                }
+                p_y[r] = sum;
+            }
+        };
+
+        // ================= Warm-up (until the times are stable, not timed) =================
+        BenchStats stats;
+        stats.warmup_iters = bench_warmup(bench_cfg, run_spmv);
+        if (verbose) {
+            std::cout << "Ran " << stats.warmup_iters << " warm-up iterations for parallel CSR SpMV (" << reorder_name(res.method) << " ordering)" << std::endl;
+        }
+
+        // toggles callgrind (set to false) collection here
+        CALLGRIND_TOGGLE_COLLECT;
+
+        bench_sample(bench_cfg, run_spmv, stats);
+
+        // toggles callgrind collect (set to true) here
+        CALLGRIND_TOGGLE_COLLECT;
+
+        // y back to the original numbering (counted in the permutation cost)
+        auto t4 = std::chrono::steady_clock::now();
+        if (res.method == REORDER_NONE) {
+            y = p_y;
+        } else {
+            unpermute_vector(M, perm, p_y.data(), y.data());
+        }
+        auto t5 = std::chrono::steady_clock::now();
+        if (res.method != REORDER_NONE) {
+            res.permute_ms += std::chrono::duration<double, std::milli>(t5 - t4).count();
+        }
+
+        double max_err = 0.0, max_ref = 0.0;
+        for (int r = 0; r < M; ++r) {
+            max_err = std::max(max_err, std::fabs(y[r] - y_ref[r]));
+            max_ref = std::max(max_ref, std::fabs(y_ref[r]));
+        }
+        res.best_time_ms = stats.min_ms;
+        bench_record(bench_cfg, "parallel_spmv_reorder", matrix_filename,
+                     std::string("csr/") + reorder_name(res.method), num_threads, stats);
+        res.rel_err = max_ref > 0.0 ? max_err / max_ref : max_err;
+        results.push_back(res);
+    }
+
+    // ================= Results =================
+    double base_ms = results[0].best_time_ms;
+    for (size_t m = 0; m < results.size(); ++m) {
+        if (results[m].method == REORDER_NONE) base_ms = results[m].best_time_ms;
+    }
+
+    std::cout << "\n=== Reordered Parallel CSR SpMV Benchmark Results ===\n";
+    std::cout << "Matrix             : " << matrix_filename << "\n";
+    std::cout << "Dimensions         : " << M << " x " << N << "   (nnz = " << nz << ")\n";
+    std::cout << "Threads            : " << num_threads << "\n\n";
+    std::cout << std::left << std::setw(8) << "Method" << std::right
+              << std::setw(12) << "Order (ms)" << std::setw(14) << "Permute (ms)"
+              << std::setw(11) << "Bandwidth" << std::setw(14) << "Profile"
+              << std::setw(11) << "Best (ms)" << std::setw(9) << "GFLOPS" << std::setw(8) << "% roof"
+              << std::setw(12) << "Break-even" << std::setw(12) << "Rel. error" << "\n";
+    // percentage of the triad roofline: reordering changes the x reuse, not the traffic model
+    RooflineCalib roof;
+    roofline_cache_lookup(ROOFLINE_DEFAULT_CACHE, num_threads, roof);
+    for (size_t m = 0; m < results.size(); ++m) {
+        const ReorderResult& res = results[m];
+        double best_time_s = res.best_time_ms / 1000.0;
+
+        std::cout << std::left << std::setw(8) << reorder_name(res.method) << std::right
+                  << std::setw(12) << std::fixed << std::setprecision(3) << res.order_ms
+                  << std::setw(14) << std::setprecision(3) << res.permute_ms
+                  << std::setw(11) << res.bandwidth << std::setw(14) << res.profile
+                  << std::setw(11) << std::setprecision(3) << res.best_time_ms
+                  << std::setw(9) << std::setprecision(2) << 2.0 * nz / best_time_s / 1e9;
+        const double roof_pct = roofline_percent(roof, 2.0 * nz / best_time_s / 1e9, 2.0 * nz / csr_spmv_bytes(nz, M));
+        if (roof_pct < 0.0) {
+            std::cout << std::setw(8) << "-";
+        } else {
+            std::cout << std::setw(8) << std::setprecision(1) << roof_pct;
+        }
+        // SpMVs needed before ordering + permutation are paid back
+        if (res.method == REORDER_NONE) {
+            std::cout << std::setw(12) << "-";
+        } else if (res.best_time_ms < base_ms) {
+            std::cout << std::setw(12) << std::setprecision(0)
+                      << std::ceil((res.order_ms + res.permute_ms) / (base_ms - res.best_time_ms));
+        } else {
+            std::cout << std::setw(12) << "never";
+        }
+        std::cout << std::setw(12) << std::scientific << std::setprecision(2) << res.rel_err << "\n";
+    }
+    std::cout << "(break-even: SpMVs needed to recover ordering + permutation time against the original order)\n";
+    if (roof.threads == 0) {
+        std::cout << "(% roof: not calibrated for " << num_threads << " threads, run parallel_spmv_csr --calibrate)\n";
+    }
+    std::cout << "==========================================\n";
+
+    return 0;
+}
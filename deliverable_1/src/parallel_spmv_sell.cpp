@@ -0,0 +1,182 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <omp.h>
+#include <algorithm>
+#include <iomanip>
+
+#include "../include/matrix_io.hpp"
+#include "../include/sell.hpp"
+#include "../include/bench.hpp"
+#include "../include/roofline.hpp"
+#include "../include/perf_counters.hpp"
+
+#define NUM_THREADS 16
+
+extern "C" {
+#include <valgrind/callgrind.h>
+}
+
+int main(int argc, char* argv[]) {
+    bool verbose = false;
+    std::string matrix_filename;
+    int C = SELL_DEFAULT_C;
+    int sigma = SELL_DEFAULT_SIGMA;
+    // validate command-line arguments and print usage if incorrect
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " [--chunk C] [--sigma S] [--verbose] matrix_file.mtx" << std::endl;
+        return 1;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--verbose" || arg == "-v") {
+            verbose = true;
+        } else if (arg == "--chunk" || arg == "-C") {
+            if (i + 1 >= argc || (C = std::atoi(argv[++i])) <= 0) {
+                std::cerr << "--chunk needs a positive integer" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--sigma" || arg == "-s") {
+            if (i + 1 >= argc || (sigma = std::atoi(argv[++i])) <= 0) {
+                std::cerr << "--sigma needs a positive integer" << std::endl;
+                return 1;
+            }
+        } else {
+            matrix_filename = arg;
+        }
+    }
+    // check if no matrix file is passed
+    if (matrix_filename.empty()) {
+        std::cerr << "No matrix file specified." << std::endl;
+        return 1;
+    }
+
+    int M, N, nz;
+    std::vector<int> row_ptr, col_idx;
+    std::vector<double> values;
+    if (!read_matrix_market(matrix_filename, M, N, nz, row_ptr, col_idx, values)) {
+        return 1;
+    }
+
+    // ================= SET THREAD COUNT =================
+    int num_threads = NUM_THREADS;
+    if (getenv("OMP_NUM_THREADS") != nullptr) {
+        num_threads = atoi(getenv("OMP_NUM_THREADS"));
+    }
+    omp_set_num_threads(num_threads);
+    if (verbose) {
+        std::cout << "Using: " << num_threads << " threads\n";
+    }
+
+    // ================= CSR -> SELL-C-sigma conversion =================
+    SellMatrix sell;
+    auto conv_start = std::chrono::steady_clock::now();
+    csr_to_sell(M, N, row_ptr.data(), col_idx.data(), values.data(), C, sigma, sell);
+    auto conv_end = std::chrono::steady_clock::now();
+    double conv_ms = std::chrono::duration<double, std::milli>(conv_end - conv_start).count();
+
+    const long long stored = sell_stored_entries(sell);
+    if (verbose) {
+        std::cout << "SELL-" << sell.C << "-" << sell.sigma << ": " << sell.num_chunks
+                  << " chunks, " << stored << " stored entries, conversion took "
+                  << conv_ms << " ms" << std::endl;
+    }
+
+    // generate random monodimensional array
+    std::vector<double> x(N), y(M, 0.0);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<double> dis(0.0, 1.0);
+    for (int i = 0; i < N; ++i) {
+        x[i] = dis(gen);
+    }
+
+    auto run_spmv = [&]() {
+        spmv_sell(sell, x.data(), y.data());
+    };
+
+    // ================= Warm-up (until the times are stable, not timed) =================
+    BenchConfig bench_cfg = bench_config_from_env(verbose);
+    BenchStats stats;
+    stats.warmup_iters = bench_warmup(bench_cfg, run_spmv);
+    if (verbose) {
+        std::cout << "Ran " << stats.warmup_iters << " warm-up iterations for parallel SELL SpMV" << std::endl;
+    }
+
+    // hardware counters of the timed products (n/a when no PMU is available)
+    PerfRegion perf;
+    perf_region_open(perf, num_threads);
+
+    // toggles callgrind (set to false) collection here
+    CALLGRIND_TOGGLE_COLLECT;
+
+    perf_region_begin(perf);
+    bench_sample(bench_cfg, run_spmv, stats);
+    perf_region_end(perf);
+
+    // toggles callgrind collect (set to true) here
+    CALLGRIND_TOGGLE_COLLECT;
+
+    bench_record(bench_cfg, "parallel_spmv_sell", matrix_filename, "sell", num_threads, stats);
+
+    if (verbose) {
+        // check against a plain CSR product
+        double max_err = 0.0, max_ref = 0.0;
+        for (int r = 0; r < M; ++r) {
+            double sum = 0.0;
+            for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+                sum += values[k] * x[col_idx[k]];
+            }
+            max_err = std::max(max_err, std::fabs(sum - y[r]));
+            max_ref = std::max(max_ref, std::fabs(sum));
+        }
+        double rel_err = max_ref > 0.0 ? max_err / max_ref : max_err;
+
+        double best_time_ms = stats.min_ms;
+        double best_time_s  = best_time_ms / 1000.0;
+
+        long long flops_per_spmv   = 2LL * nz;                                     // useful flops only (padding excluded)
+        double    bytes_per_spmv   = 12.0 * stored + 12.0 * M                      // 8B val + 4B col_idx per stored entry, 4B perm + 8B y per row
+                                     + 8.0 * sell.num_chunks;                      // chunk_ptr + chunk_len
+
+        double gflops = flops_per_spmv / best_time_s / 1e9;
+        double gbs    = bytes_per_spmv / best_time_s / 1e9;
+        double arith_intensity = static_cast<double>(flops_per_spmv) / bytes_per_spmv;
+        double fill_efficiency = stored > 0 ? static_cast<double>(nz) / stored : 1.0;
+
+        std::cout << "\n=== Parallel SELL-C-sigma SpMV Benchmark Results ===\n";
+        std::cout << "Matrix             : " << matrix_filename << "\n";
+        std::cout << "Dimensions         : " << M << " x " << N << "   (nnz = " << nz << ")\n";
+        std::cout << "Threads            : " << num_threads << "\n";
+        std::cout << "Chunk height (C)   : " << sell.C << "\n";
+        std::cout << "Sorting window     : " << sell.sigma << "\n";
+        std::cout << "Fill efficiency    : " << std::fixed << std::setprecision(2)
+                  << 100.0 * fill_efficiency << " %   (" << stored << " stored entries)\n";
+        std::cout << "Conversion time    : " << std::setprecision(3) << conv_ms << " ms\n";
+        std::cout << "Best time          : " << std::setprecision(3)
+                  << best_time_ms << " ms\n";
+        std::cout << "Timing             : " << bench_summary(stats) << ", p99 " << stats.p99_ms
+                  << " ms, stddev " << stats.stddev_ms << " ms\n";
+        std::cout << "Performance        : " << std::setprecision(2)
+                  << gflops << " GFLOPS\n";
+        std::cout << "Effective Bandwidth: " << std::setprecision(2)
+                  << gbs << " GB/s\n";
+        std::cout << "Arithmetic Intensity: " << std::setprecision(3)
+                  << arith_intensity << " FLOP/byte\n";
+        RooflineCalib roof;
+        roofline_cache_lookup(ROOFLINE_DEFAULT_CACHE, num_threads, roof);
+        roofline_print(roof, num_threads, gflops, arith_intensity);
+        perf_region_print(perf, nz, stats.samples);
+        std::cout << "Rel. error vs CSR  : " << std::scientific << std::setprecision(3)
+                  << rel_err << "\n";
+        std::cout << "==========================================\n";
+    }
+
+    perf_region_close(perf);
+    return 0;
+}
@@ -0,0 +1,187 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <omp.h>
+#include <algorithm>
+#include <iomanip>
+
+#include "../include/matrix_io.hpp"
+#include "../include/symmetric.hpp"
+#include "../include/bench.hpp"
+#include "../include/roofline.hpp"
+#include "../include/perf_counters.hpp"
+
+#define NUM_THREADS 16
+
+extern "C" {
+#include <valgrind/callgrind.h>
+}
+
+int main(int argc, char* argv[]) {
+    bool verbose = false;
+    std::string matrix_filename;
+    // validate command-line arguments and print usage if incorrect
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " [--verbose] symmetric_matrix_file.mtx" << std::endl;
+        return 1;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--verbose" || arg == "-v") {
+            verbose = true;
+        } else {
+            matrix_filename = arg;
+        }
+    }
+    // check if no matrix file is passed
+    if (matrix_filename.empty()) {
+        std::cerr << "No matrix file specified." << std::endl;
+        return 1;
+    }
+
+    // reads the stored (lower) triangle only
+    int M, N, nz;
+    bool symmetric = false;
+    std::vector<int> row_coo, col_coo;
+    std::vector<double> val_coo;
+    if (!read_matrix_market_coo(matrix_filename, M, N, nz, row_coo, col_coo, val_coo, &symmetric)) {
+        return 1;
+    }
+    if (!symmetric || M != N) {
+        std::cerr << "Matrix is not stored as symmetric, use parallel_spmv_csr instead." << std::endl;
+        return 1;
+    }
+
+    std::vector<int> row_ptr, col_idx;
+    std::vector<double> values;
+    // nz and nz_full count CSR entries, after duplicates are merged
+    const int nz_coo = nz;
+    nz = coo_to_csr(M, nz_coo, row_coo, col_coo, val_coo, row_ptr, col_idx, values);
+
+    // full matrix, only used as reference (correctness and traffic comparison)
+    int nz_full = nz_coo;
+    expand_symmetric_coo(nz_full, row_coo, col_coo, val_coo);
+    std::vector<int> full_row_ptr, full_col_idx;
+    std::vector<double> full_values;
+    nz_full = coo_to_csr(M, nz_full, row_coo, col_coo, val_coo, full_row_ptr, full_col_idx, full_values);
+    row_coo.clear();
+    col_coo.clear();
+    val_coo.clear();
+
+    // ================= SET THREAD COUNT =================
+    int num_threads = NUM_THREADS;
+    if (getenv("OMP_NUM_THREADS") != nullptr) {
+        num_threads = atoi(getenv("OMP_NUM_THREADS"));
+    }
+    omp_set_num_threads(num_threads);
+    if (verbose) {
+        std::cout << "Using: " << num_threads << " threads\n";
+    }
+
+    // ================= Partition + private partial y =================
+    SymSpmvPlan plan;
+    sym_spmv_setup(M, row_ptr.data(), col_idx.data(), num_threads, plan);
+    size_t partial_entries = 0;
+    for (int p = 0; p < plan.num_parts; ++p) partial_entries += plan.partial[p].size();
+    if (verbose) {
+        std::cout << "Lower triangle: " << nz << " of " << nz_full << " nonzeros, "
+                  << partial_entries << " private partial-y entries" << std::endl;
+    }
+
+    // generate random monodimensional array
+    std::vector<double> x(N), y(M, 0.0);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<double> dis(0.0, 1.0);
+    for (int i = 0; i < N; ++i) {
+        x[i] = dis(gen);
+    }
+
+    auto run_spmv = [&]() {
+        spmv_sym_lower(plan, row_ptr.data(), col_idx.data(), values.data(), x.data(), y.data());
+    };
+
+    // ================= Warm-up (until the times are stable, not timed) =================
+    BenchConfig bench_cfg = bench_config_from_env(verbose);
+    BenchStats stats;
+    stats.warmup_iters = bench_warmup(bench_cfg, run_spmv);
+    if (verbose) {
+        std::cout << "Ran " << stats.warmup_iters << " warm-up iterations for parallel symmetric SpMV" << std::endl;
+    }
+
+    // hardware counters of the timed products (n/a when no PMU is available)
+    PerfRegion perf;
+    perf_region_open(perf, num_threads);
+
+    // toggles callgrind (set to false) collection here
+    CALLGRIND_TOGGLE_COLLECT;
+
+    perf_region_begin(perf);
+    bench_sample(bench_cfg, run_spmv, stats);
+    perf_region_end(perf);
+
+    // toggles callgrind collect (set to true) here
+    CALLGRIND_TOGGLE_COLLECT;
+
+    bench_record(bench_cfg, "parallel_spmv_sym", matrix_filename, "sym", num_threads, stats);
+
+    if (verbose) {
+        // check against a plain CSR product on the expanded matrix
+        double max_err = 0.0, max_ref = 0.0;
+        for (int r = 0; r < M; ++r) {
+            double sum = 0.0;
+            for (int k = full_row_ptr[r]; k < full_row_ptr[r + 1]; ++k) {
+                sum += full_values[k] * x[full_col_idx[k]];
+            }
+            max_err = std::max(max_err, std::fabs(sum - y[r]));
+            max_ref = std::max(max_ref, std::fabs(sum));
+        }
+        double rel_err = max_ref > 0.0 ? max_err / max_ref : max_err;
+
+        double best_time_ms = stats.min_ms;
+        double best_time_s  = best_time_ms / 1000.0;
+
+        long long flops_per_spmv   = 2LL * nz_full;                                // flops of the full product
+        double    bytes_per_spmv   = 12.0 * nz + 4.0 * M                           // 8B val + 4B col_idx of the triangle + row_ptr
+                                     + 16.0 * M                                    // y zero + write
+                                     + 16.0 * partial_entries;                     // private buffers (write + reduce)
+        double    bytes_full       = 12.0 * nz_full + 20.0 * M;                    // same formula for the expanded CSR
+
+        double gflops = flops_per_spmv / best_time_s / 1e9;
+        double gbs    = bytes_per_spmv / best_time_s / 1e9;
+        double arith_intensity = static_cast<double>(flops_per_spmv) / bytes_per_spmv;
+
+        std::cout << "\n=== Parallel Symmetric CSR SpMV Benchmark Results ===\n";
+        std::cout << "Matrix             : " << matrix_filename << "\n";
+        std::cout << "Dimensions         : " << M << " x " << N << "   (nnz = " << nz_full
+                  << ", stored = " << nz << ")\n";
+        std::cout << "Threads            : " << num_threads << "\n";
+        std::cout << "Matrix traffic     : " << std::fixed << std::setprecision(2)
+                  << 100.0 * bytes_per_spmv / bytes_full << " % of the expanded CSR\n";
+        std::cout << "Best time          : " << std::setprecision(3)
+                  << best_time_ms << " ms\n";
+        std::cout << "Timing             : " << bench_summary(stats) << ", p99 " << stats.p99_ms
+                  << " ms, stddev " << stats.stddev_ms << " ms\n";
+        std::cout << "Performance        : " << std::setprecision(2)
+                  << gflops << " GFLOPS\n";
+        std::cout << "Effective Bandwidth: " << std::setprecision(2)
+                  << gbs << " GB/s\n";
+        std::cout << "Arithmetic Intensity: " << std::setprecision(3)
+                  << arith_intensity << " FLOP/byte\n";
+        RooflineCalib roof;
+        roofline_cache_lookup(ROOFLINE_DEFAULT_CACHE, num_threads, roof);
+        roofline_print(roof, num_threads, gflops, arith_intensity);
+        perf_region_print(perf, nz, stats.samples);
+        std::cout << "Rel. error vs CSR  : " << std::scientific << std::setprecision(3)
+                  << rel_err << "\n";
+        std::cout << "==========================================\n";
+    }
+
+    perf_region_close(perf);
+    return 0;
+}
@@ -0,0 +1,220 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <omp.h>
+#include <algorithm>
+#include <iomanip>
+
+#include "../include/matrix_io.hpp"
+#include "../include/csr_bin.hpp"
+#include "../include/axpby.hpp"
+#include "../include/transpose.hpp"
+#include "../include/bench.hpp"
+#include "../include/roofline.hpp"
+
+#define NUM_THREADS 16
+
+extern "C" {
+#include <valgrind/callgrind.h>
+}
+
+int main(int argc, char* argv[]) {
+    bool verbose = false;
+    TransposeMethod method = TRANSPOSE_AUTO;
+    long long expected_iters = 0;
+    std::string matrix_filename;
+    // validate command-line arguments and print usage if incorrect
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " [--method auto|csc|private] [--iters N] [--verbose]"
+                  << " matrix_file.mtx|matrix_file.csrb" << std::endl;
+        return 1;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--verbose" || arg == "-v") {
+            verbose = true;
+        } else if (arg == "--method") {
+            if (i + 1 >= argc || !transpose_method_from_name(argv[++i], method)) {
+                std::cerr << "--method must be 'auto', 'csc' or 'private'" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--iters") {
+            if (i + 1 >= argc || (expected_iters = std::atoll(argv[++i])) < 0) {
+                std::cerr << "--iters needs a non-negative integer" << std::endl;
+                return 1;
+            }
+        } else {
+            matrix_filename = arg;
+        }
+    }
+    // check if no matrix file is passed
+    if (matrix_filename.empty()) {
+        std::cerr << "No matrix file specified." << std::endl;
+        return 1;
+    }
+
+    LoadedCsr A;
+    if (!load_csr(matrix_filename, A)) {
+        return 1;
+    }
+    const int M = A.M, N = A.N, nz = A.nnz;
+
+    // ================= SET THREAD COUNT =================
+    int num_threads = NUM_THREADS;
+    if (getenv("OMP_NUM_THREADS") != nullptr) {
+        num_threads = atoi(getenv("OMP_NUM_THREADS"));
+    }
+    omp_set_num_threads(num_threads);
+    if (verbose) {
+        std::cout << "Using: " << num_threads << " threads\n";
+    }
+
+    // ================= Setup: automatic choice, then both engines =================
+    TransposePlan chosen;
+    transpose_prepare(chosen, method, num_threads, expected_iters, M, N, A.row_ptr, A.col_idx, A.values);
+    const TransposeMethod selected = chosen.method;
+    const double private_bytes = chosen.private_bytes;
+    transpose_release(chosen);
+
+    TransposePlan csc, priv;
+    transpose_prepare(csc, TRANSPOSE_CSC, num_threads, expected_iters, M, N, A.row_ptr, A.col_idx, A.values);
+    transpose_prepare(priv, TRANSPOSE_PRIVATE, num_threads, expected_iters, M, N, A.row_ptr, A.col_idx, A.values);
+
+    // generate random monodimensional arrays (x of size N for A x, of size M for A^T x)
+    std::vector<double> x(N), xt(M), y(M, 0.0), yt(N, 0.0), yt_ref(N, 0.0);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<double> dis(0.0, 1.0);
+    for (int i = 0; i < N; ++i) {
+        x[i] = dis(gen);
+    }
+    for (int i = 0; i < M; ++i) {
+        xt[i] = dis(gen);
+    }
+
+    // serial reference of A^T x
+    for (int r = 0; r < M; ++r) {
+        for (int k = A.row_ptr[r]; k < A.row_ptr[r + 1]; ++k) {
+            yt_ref[A.col_idx[k]] += A.values[k] * xt[r];
+        }
+    }
+
+    // ================= Engines compared on the same input =================
+    struct Engine {
+        const char* name;
+        const char* tag;            // kernel column of the result records
+        double setup_ms;
+        double best_time_ms;
+        double median_ms;
+        double rel_err;
+    };
+    std::vector<Engine> engines = {
+        {"A x (CSR)", "csr", 0.0, 0.0, 0.0, 0.0},
+        {"A^T x (CSC)", "transpose/csc", csc.setup_ms, 0.0, 0.0, 0.0},
+        {"A^T x (private)", "transpose/private", priv.setup_ms, 0.0, 0.0, 0.0},
+    };
+
+    auto run_engine = [&](int e) {
+        if (e == 0) {
+            spmv_csr_axpby(M, A.row_ptr, A.col_idx, A.values, 1.0, x.data(), 0.0, y.data(), false);
+        } else if (e == 1) {
+            spmv_transpose(csc, 1.0, xt.data(), 0.0, yt.data());
+        } else {
+            spmv_transpose(priv, 1.0, xt.data(), 0.0, yt.data());
+        }
+    };
+
+    BenchConfig bench_cfg = bench_config_from_env(verbose);
+
+    for (size_t e = 0; e < engines.size(); ++e) {
+        auto run_once = [&]() { run_engine(static_cast<int>(e)); };
+        BenchStats stats;
+        stats.warmup_iters = bench_warmup(bench_cfg, run_once);
+        if (verbose) {
+            std::cout << "Ran " << stats.warmup_iters << " warm-up iterations for " << engines[e].name << std::endl;
+        }
+
+        // toggles callgrind (set to false) collection here
+        CALLGRIND_TOGGLE_COLLECT;
+
+        bench_sample(bench_cfg, run_once, stats);
+
+        // toggles callgrind collect (set to true) here
+        CALLGRIND_TOGGLE_COLLECT;
+
+        if (e > 0) {
+            double max_err = 0.0, max_ref = 0.0;
+            for (int c = 0; c < N; ++c) {
+                max_err = std::max(max_err, std::fabs(yt[c] - yt_ref[c]));
+                max_ref = std::max(max_ref, std::fabs(yt_ref[c]));
+            }
+            engines[e].rel_err = max_ref > 0.0 ? max_err / max_ref : max_err;
+        }
+        engines[e].best_time_ms = stats.min_ms;
+        engines[e].median_ms = stats.median_ms;
+        bench_record(bench_cfg, "parallel_spmv_transpose", matrix_filename, engines[e].tag, num_threads, stats);
+    }
+
+    // ================= Results =================
+    const double matrix_bytes = 12.0 * nz + 4.0 * M;
+    std::cout << "\n=== Transposed SpMV Benchmark Results ===\n";
+    std::cout << "Matrix             : " << matrix_filename << "\n";
+    std::cout << "Dimensions         : " << M << " x " << N << "   (nnz = " << nz << ")\n";
+    std::cout << "Threads            : " << num_threads << "\n";
+    std::cout << "Private buffers    : " << std::fixed << std::setprecision(1)
+              << private_bytes / (1 << 20) << " MiB traffic per product ("
+              << std::setprecision(2) << private_bytes / matrix_bytes << "x the matrix)\n";
+    std::cout << "Selected engine    : " << transpose_method_name(selected)
+              << (method == TRANSPOSE_AUTO ? " (auto" : " (forced")
+              << (expected_iters > 0 ? ", " + std::to_string(expected_iters) + " products)" : ")") << "\n\n";
+    std::cout << std::left << std::setw(17) << "Kernel" << std::right
+              << std::setw(12) << "Setup (ms)" << std::setw(12) << "Best (ms)" << std::setw(13) << "Median (ms)"
+              << std::setw(10) << "GFLOPS" << std::setw(8) << "% roof" << std::setw(9) << "vs Ax" << std::setw(12) << "Break-even"
+              << std::setw(12) << "Rel. error" << "\n";
+    // percentage of the triad roofline under the compulsory traffic (matrix once, y of
+    // size M forward and N transposed): the private buffers count against the engine
+    RooflineCalib roof;
+    roofline_cache_lookup(ROOFLINE_DEFAULT_CACHE, num_threads, roof);
+    for (size_t e = 0; e < engines.size(); ++e) {
+        const double best_time_s = engines[e].best_time_ms / 1000.0;
+        const double gflops = 2.0 * nz / best_time_s / 1e9;
+        std::cout << std::left << std::setw(17) << engines[e].name << std::right
+                  << std::setw(12) << std::fixed << std::setprecision(3) << engines[e].setup_ms
+                  << std::setw(12) << std::setprecision(3) << engines[e].best_time_ms
+                  << std::setw(13) << std::setprecision(3) << engines[e].median_ms
+                  << std::setw(10) << std::setprecision(2) << gflops;
+        const double roof_pct = roofline_percent(roof, gflops, 2.0 * nz / csr_spmv_bytes(nz, e == 0 ? M : N));
+        if (roof_pct < 0.0) {
+            std::cout << std::setw(8) << "-";
+        } else {
+            std::cout << std::setw(8) << std::setprecision(1) << roof_pct;
+        }
+        std::cout << std::setw(8) << std::setprecision(2) << engines[e].best_time_ms / engines[0].best_time_ms << "x";
+        // products after which the CSC conversion is paid back against the private engine
+        const double gain = engines[2].best_time_ms - engines[1].best_time_ms;
+        if (e == 1 && gain > 0.0) {
+            std::cout << std::setw(12) << std::setprecision(0) << std::ceil((engines[1].setup_ms - engines[2].setup_ms) / gain);
+        } else if (e == 1) {
+            std::cout << std::setw(12) << "never";
+        } else {
+            std::cout << std::setw(12) << "-";
+        }
+        if (e == 0) {
+            std::cout << std::setw(12) << "-" << "\n";
+        } else {
+            std::cout << std::setw(12) << std::scientific << std::setprecision(2) << engines[e].rel_err << "\n";
+        }
+    }
+    std::cout << "(break-even: A^T x products needed to recover the CSC conversion against the private engine)\n";
+    if (roof.threads == 0) {
+        std::cout << "(% roof: not calibrated for " << num_threads << " threads, run parallel_spmv_csr --calibrate)\n";
+    }
+    std::cout << "==========================================\n";
+
+    return 0;
+}
@@ -0,0 +1,249 @@
+#include "../include/perf_counters.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <omp.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char* const event_names[] = {"llc_misses", "l1d_misses", "cycles", "instructions",
+                                          "dtlb_misses", "mem_stalls"};
+
+const char* perf_event_name(PerfEvent event) {
+    return (event >= PERF_LLC_MISSES && event < PERF_EVENT_COUNT) ? event_names[event] : "unknown";
+}
+
+#if defined(__linux__)
+
+// counter of the calling thread, on whatever CPU it runs
+static int open_thread_counter(PerfEvent event, int& err) {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // enabled / running times to scale multiplexed counts
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    switch (event) {
+        case PERF_LLC_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case PERF_L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PERF_CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PERF_INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PERF_DTLB_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        default:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_STALLED_CYCLES_BACKEND;
+            break;
+    }
+    const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    err = fd < 0 ? errno : 0;
+    return fd;
+}
+
+bool perf_counters_open(PerfCounters& pc, PerfEvent event, int num_threads) {
+    perf_counters_close(pc);
+    pc.event = event;
+    pc.fds.assign(num_threads, -1);
+    std::vector<int> errs(num_threads, 0);
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        const int t = omp_get_thread_num();
+        pc.fds[t] = open_thread_counter(event, errs[t]);
+    }
+
+    pc.available = true;
+    for (int t = 0; t < num_threads; ++t) {
+        if (pc.fds[t] < 0) {
+            pc.available = false;
+            pc.error = std::string("perf_event_open: ") + std::strerror(errs[t]);
+            if (errs[t] == EACCES || errs[t] == EPERM) pc.error += " (see /proc/sys/kernel/perf_event_paranoid)";
+            if (errs[t] == ENOENT || errs[t] == EOPNOTSUPP) pc.error += " (event not supported, or no PMU exposed)";
+            break;
+        }
+    }
+    if (!pc.available) perf_counters_close(pc);
+    return pc.available;
+}
+
+void perf_counters_start(PerfCounters& pc) {
+    if (!pc.available) return;
+    for (int fd : pc.fds) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+long long perf_counters_stop(PerfCounters& pc, std::vector<long long>* per_thread) {
+    if (!pc.available) return -1;
+    for (int fd : pc.fds) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (per_thread) per_thread->assign(pc.fds.size(), 0);
+    long long total = 0;
+    for (size_t t = 0; t < pc.fds.size(); ++t) {
+        // value, time enabled, time running
+        unsigned long long buf[3] = {0, 0, 0};
+        if (read(pc.fds[t], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) return -1;
+        long long count = static_cast<long long>(buf[0]);
+        if (buf[2] > 0 && buf[2] < buf[1]) {
+            count = static_cast<long long>(static_cast<double>(buf[0]) * buf[1] / buf[2]);
+        }
+        if (per_thread) (*per_thread)[t] = count;
+        total += count;
+    }
+    return total;
+}
+
+void perf_counters_close(PerfCounters& pc) {
+    for (int fd : pc.fds) {
+        if (fd >= 0) close(fd);
+    }
+    pc.fds.clear();
+    pc.available = false;
+}
+
+#else
+
+bool perf_counters_open(PerfCounters& pc, PerfEvent event, int num_threads) {
+    pc.event = event;
+    pc.fds.clear();
+    pc.available = false;
+    pc.error = "hardware counters need Linux perf_event_open";
+    return false;
+}
+
+void perf_counters_start(PerfCounters&) {}
+
+long long perf_counters_stop(PerfCounters&, std::vector<long long>*) { return -1; }
+
+void perf_counters_close(PerfCounters& pc) {
+    pc.fds.clear();
+    pc.available = false;
+}
+
+#endif
+
+// ================= Regions =================
+
+bool perf_region_open(PerfRegion& region, int num_threads) {
+    region.num_threads = num_threads;
+    region.passes = 0;
+    bool any = false;
+    for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+        region.counts[e].clear();
+        if (perf_counters_open(region.counters[e], static_cast<PerfEvent>(e), num_threads)) {
+            region.counts[e].assign(num_threads, 0);
+            any = true;
+        }
+    }
+    return any;
+}
+
+void perf_region_begin(PerfRegion& region) {
+    for (int e = 0; e < PERF_EVENT_COUNT; ++e) perf_counters_start(region.counters[e]);
+}
+
+void perf_region_end(PerfRegion& region) {
+    std::vector<long long> pass;
+    for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+        if (region.counts[e].empty()) continue;
+        if (perf_counters_stop(region.counters[e], &pass) < 0) {
+            region.counts[e].clear();
+            continue;
+        }
+        for (size_t t = 0; t < pass.size(); ++t) region.counts[e][t] += pass[t];
+    }
+    region.passes++;
+}
+
+long long perf_region_total(const PerfRegion& region, PerfEvent event) {
+    const std::vector<long long>& c = region.counts[event];
+    if (c.empty() || region.passes == 0) return -1;
+    long long total = 0;
+    for (long long v : c) total += v;
+    return total;
+}
+
+void perf_region_print(const PerfRegion& region, long long nnz, long long products) {
+    int available = 0;
+    std::string error;
+    for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+        if (perf_region_total(region, static_cast<PerfEvent>(e)) >= 0) {
+            available++;
+        } else if (error.empty()) {
+            error = region.counters[e].error;
+        }
+    }
+    if (available == 0) {
+        std::cout << "Counters           : n/a (" << (error.empty() ? "not measured" : error) << ")\n";
+        return;
+    }
+    products = std::max(1LL, products);
+    nnz = std::max(1LL, nnz);
+    std::cout << "Counters           : " << available << " of " << PERF_EVENT_COUNT << " events, "
+              << region.num_threads << " threads, per product (" << products << " timed products)\n";
+
+    const long long cycles = perf_region_total(region, PERF_CYCLES);
+    for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+        const long long total = perf_region_total(region, static_cast<PerfEvent>(e));
+        std::cout << "  " << std::left << std::setw(17) << perf_event_name(static_cast<PerfEvent>(e)) << std::right;
+        if (total < 0) {
+            std::cout << std::setw(14) << "n/a" << "\n";
+            continue;
+        }
+        const double per_product = static_cast<double>(total) / products;
+        std::cout << std::setw(14) << std::fixed << std::setprecision(0) << per_product
+                  << "   per nnz " << std::setw(8) << std::setprecision(3) << per_product / nnz;
+        if (e == PERF_INSTRUCTIONS && cycles > 0) {
+            std::cout << "   IPC " << std::setprecision(2) << static_cast<double>(total) / cycles;
+        }
+        if (e == PERF_MEM_STALLS && cycles > 0) {
+            std::cout << "   " << std::setprecision(1) << 100.0 * total / cycles << " % of cycles";
+        }
+        std::cout << "\n";
+    }
+    // slowest thread against the mean: load imbalance the timer alone does not show
+    if (cycles > 0 && region.num_threads > 1) {
+        const std::vector<long long>& c = region.counts[PERF_CYCLES];
+        const double mean = static_cast<double>(cycles) / c.size();
+        std::cout << "  cycles per thread  max/mean " << std::setprecision(2)
+                  << *std::max_element(c.begin(), c.end()) / mean << ", min/mean "
+                  << *std::min_element(c.begin(), c.end()) / mean << "\n";
+    }
+    if (available < PERF_EVENT_COUNT) {
+        std::cout << "  (n/a: " << error << ")\n";
+    }
+}
+
+void perf_region_close(PerfRegion& region) {
+    for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+        perf_counters_close(region.counters[e]);
+        region.counts[e].clear();
+    }
+    region.passes = 0;
+}
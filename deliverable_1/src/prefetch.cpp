@@ -0,0 +1,181 @@
+#include "../include/prefetch.hpp"
+#include "../include/axpby.hpp"
+#include "../include/csr_simd.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <omp.h>
+
+// cache line of doubles / ints
+#define LINE_DOUBLES 8
+#define LINE_INTS 16
+
+// PREFETCH = false: the same loop without a single prefetch (distance 0)
+template <int MODE, bool PREFETCH>
+static void csr_prefetch(int M, const int* __restrict__ row_ptr, const int* __restrict__ col_idx,
+                         const double* __restrict__ values, double alpha, const double* __restrict__ x,
+                         double beta, double* __restrict__ y, int d) {
+    const int nnz = row_ptr[M];
+    // last nonzero whose x can be prefetched d ahead
+    const int pf_last = nnz - d;
+
+    #pragma omp parallel
+    {
+        #pragma omp for schedule(guided, AXPBY_BLOCK_SIZE) nowait
+        for (int r = 0; r < M; ++r) {
+            const int begin = row_ptr[r];
+            const int end = row_ptr[r + 1];
+
+            double sum = 0.0;
+            int k = begin;
+            if (PREFETCH) {
+                // matrix streams: values d ahead, col_idx 2d ahead (read by the x prefetches)
+                for (int p = begin + d; p < std::min(end + d, nnz); p += LINE_DOUBLES) {
+                    __builtin_prefetch(values + p, 0, 0);
+                }
+                for (int p = begin + 2 * d; p < std::min(end + 2 * d, nnz); p += LINE_INTS) {
+                    __builtin_prefetch(col_idx + p, 0, 0);
+                }
+                const int split = std::min(end, pf_last);
+                for (; k < split; ++k) {
+                    __builtin_prefetch(x + col_idx[k + d], 0, 3);
+                    sum += values[k] * x[col_idx[k]];
+                }
+            }
+            for (; k < end; ++k) {
+                sum += values[k] * x[col_idx[k]];
+            }
+            axpby_store_row<MODE>(y, r, alpha, sum, beta);
+        }
+        if (MODE == AXPBY_STREAM) axpby_store_fence();
+    }
+}
+
+void spmv_csr_prefetch(int M, const int* row_ptr, const int* col_idx, const double* values,
+                       double alpha, const double* x, double beta, double* y, int distance, bool streaming) {
+    if (distance <= 0) {
+        if (beta != 0.0) {
+            csr_prefetch<AXPBY_UPDATE, false>(M, row_ptr, col_idx, values, alpha, x, beta, y, 0);
+        } else if (streaming) {
+            csr_prefetch<AXPBY_STREAM, false>(M, row_ptr, col_idx, values, alpha, x, beta, y, 0);
+        } else {
+            csr_prefetch<AXPBY_OVERWRITE, false>(M, row_ptr, col_idx, values, alpha, x, beta, y, 0);
+        }
+    } else if (beta != 0.0) {
+        csr_prefetch<AXPBY_UPDATE, true>(M, row_ptr, col_idx, values, alpha, x, beta, y, distance);
+    } else if (streaming) {
+        csr_prefetch<AXPBY_STREAM, true>(M, row_ptr, col_idx, values, alpha, x, beta, y, distance);
+    } else {
+        csr_prefetch<AXPBY_OVERWRITE, true>(M, row_ptr, col_idx, values, alpha, x, beta, y, distance);
+    }
+}
+
+int prefetch_autotune(int M, int N, const int* row_ptr, const int* col_idx, const double* values,
+                      SimdIsa baseline_isa, int trial_iters, std::vector<PrefetchTrial>& trials) {
+    if (trial_iters < 1) trial_iters = 1;
+    const int distances[] = PREFETCH_DISTANCES;
+    trials.clear();
+
+    std::vector<double> x(N), y(M, 0.0);
+    for (int j = 0; j < N; ++j) x[j] = 1.0 + (j % 7) * 0.125;
+
+    int best = 0;
+    for (int d : distances) {
+        PrefetchTrial t;
+        t.distance = d;
+        // d = 0 is the kernel the plan runs when prefetching does not pay off
+        auto run_trial = [&]() {
+            if (d == 0) {
+                spmv_csr_simd(baseline_isa, M, row_ptr, col_idx, values, 1.0, x.data(), 0.0, y.data(), false);
+            } else {
+                spmv_csr_prefetch(M, row_ptr, col_idx, values, 1.0, x.data(), 0.0, y.data(), d, false);
+            }
+        };
+        // one untimed run to bring the matrix to the same state for every distance
+        run_trial();
+        for (int i = 0; i < trial_iters; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            run_trial();
+            auto end = std::chrono::steady_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            if (i == 0 || ms < t.spmv_ms) t.spmv_ms = ms;
+        }
+        trials.push_back(t);
+        if (t.spmv_ms < trials[best].spmv_ms) best = static_cast<int>(trials.size()) - 1;
+    }
+    return trials[best].distance;
+}
+
+void prefetch_compare(int M, const int* row_ptr, const int* col_idx, const double* values,
+                      double alpha, const double* x, double beta, SimdIsa baseline_isa, int distance,
+                      bool streaming, int num_threads, const BenchConfig& cfg, PrefetchComparison& cmp) {
+    cmp = PrefetchComparison();
+    cmp.baseline_isa = baseline_isa;
+    cmp.distance = distance;
+
+    PerfCounters counters[PERF_CACHE_EVENTS];
+    for (int e = 0; e < PERF_CACHE_EVENTS; ++e) {
+        perf_counters_open(counters[e], static_cast<PerfEvent>(e), num_threads);
+    }
+    cmp.counters_available = counters[0].available;
+    cmp.counters_error = counters[0].error;
+
+    std::vector<double> y(M, 0.0);
+    BenchConfig variant_cfg = cfg;
+    variant_cfg.verbose = false;
+    for (int v = 0; v < 2; ++v) {
+        auto run_variant = [&]() {
+            if (v == 0) {
+                spmv_csr_simd(baseline_isa, M, row_ptr, col_idx, values, alpha, x, beta, y.data(), streaming);
+            } else {
+                spmv_csr_prefetch(M, row_ptr, col_idx, values, alpha, x, beta, y.data(), distance, streaming);
+            }
+        };
+        BenchStats stats;
+        bench_warmup(variant_cfg, run_variant);
+        bench_sample(variant_cfg, run_variant, stats);
+        cmp.ms[v] = stats.min_ms;
+        for (int e = 0; e < PERF_CACHE_EVENTS; ++e) {
+            perf_counters_start(counters[e]);
+            run_variant();
+            cmp.misses[v][e] = perf_counters_stop(counters[e]);
+        }
+    }
+    for (int e = 0; e < PERF_CACHE_EVENTS; ++e) {
+        perf_counters_close(counters[e]);
+    }
+}
+
+void prefetch_compare_print(const PrefetchComparison& cmp) {
+    std::cout << "\n" << std::left << std::setw(16) << "Prefetch" << std::right << std::setw(12) << "Time (ms)";
+    for (int e = 0; e < PERF_CACHE_EVENTS; ++e) {
+        std::cout << std::setw(16) << perf_event_name(static_cast<PerfEvent>(e));
+    }
+    std::cout << "\n";
+    for (int v = 0; v < 2; ++v) {
+        std::cout << std::left << std::setw(16)
+                  << (v == 0 ? std::string("off (") + simd_isa_name(cmp.baseline_isa) + ")"
+                             : "d = " + std::to_string(cmp.distance))
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(3) << cmp.ms[v];
+        for (int e = 0; e < PERF_CACHE_EVENTS; ++e) {
+            std::cout << std::setw(16) << (cmp.misses[v][e] < 0 ? std::string("n/a") : std::to_string(cmp.misses[v][e]));
+        }
+        std::cout << "\n";
+    }
+    std::cout << std::left << std::setw(16) << "reduction" << std::right << std::setw(11)
+              << std::setprecision(1) << 100.0 * (1.0 - cmp.ms[1] / cmp.ms[0]) << "%";
+    for (int e = 0; e < PERF_CACHE_EVENTS; ++e) {
+        if (cmp.misses[0][e] > 0 && cmp.misses[1][e] >= 0) {
+            std::cout << std::setw(15) << std::setprecision(1)
+                      << 100.0 * (1.0 - static_cast<double>(cmp.misses[1][e]) / cmp.misses[0][e]) << "%";
+        } else {
+            std::cout << std::setw(16) << "n/a";
+        }
+    }
+    std::cout << "\n";
+    if (!cmp.counters_available) {
+        std::cout << "(cache misses unavailable: " << cmp.counters_error << ")\n";
+    }
+}
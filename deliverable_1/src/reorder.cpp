@@ -0,0 +1,361 @@
+#include "../include/reorder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <utility>
+#include <omp.h>
+
+#define REORDER_BLOCK_SIZE 64
+
+static const char* const method_names[] = {"none", "rcm", "degree", "gorder"};
+
+bool reorder_from_name(const std::string& name, ReorderMethod& method) {
+    for (int i = 0; i <= REORDER_GORDER; ++i) {
+        if (name == method_names[i]) {
+            method = static_cast<ReorderMethod>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* reorder_name(ReorderMethod method) {
+    return (method >= REORDER_NONE && method <= REORDER_GORDER) ? method_names[method] : "unknown";
+}
+
+// Pattern of A + A^T without the diagonal, sorted and without duplicates
+static void symmetric_graph(int M, const int* row_ptr, const int* col_idx,
+                            std::vector<int>& adj_ptr, std::vector<int>& adj) {
+    std::vector<int> count(M + 1, 0);
+    for (int i = 0; i < M; ++i) {
+        for (int k = row_ptr[i]; k < row_ptr[i + 1]; ++k) {
+            const int j = col_idx[k];
+            if (j == i) continue;
+            count[i + 1]++;
+            count[j + 1]++;
+        }
+    }
+    for (int i = 0; i < M; ++i) count[i + 1] += count[i];
+
+    std::vector<int> fill(count.begin(), count.end() - 1);
+    std::vector<int> raw(count[M]);
+    for (int i = 0; i < M; ++i) {
+        for (int k = row_ptr[i]; k < row_ptr[i + 1]; ++k) {
+            const int j = col_idx[k];
+            if (j == i) continue;
+            raw[fill[i]++] = j;
+            raw[fill[j]++] = i;
+        }
+    }
+
+    // sort and deduplicate every list, then compact
+    std::vector<int> unique_len(M + 1, 0);
+    #pragma omp parallel for schedule(dynamic, REORDER_BLOCK_SIZE)
+    for (int i = 0; i < M; ++i) {
+        int* begin = raw.data() + count[i];
+        int* end = raw.data() + count[i + 1];
+        std::sort(begin, end);
+        unique_len[i + 1] = static_cast<int>(std::unique(begin, end) - begin);
+    }
+    adj_ptr.assign(M + 1, 0);
+    for (int i = 0; i < M; ++i) adj_ptr[i + 1] = adj_ptr[i] + unique_len[i + 1];
+    adj.resize(adj_ptr[M]);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < M; ++i) {
+        std::copy(raw.begin() + count[i], raw.begin() + count[i] + unique_len[i + 1],
+                  adj.begin() + adj_ptr[i]);
+    }
+}
+
+// ================= Reverse Cuthill-McKee =================
+
+// BFS levels from root; returns the last level, fills the nodes of the last level
+static int bfs_levels(int root, const std::vector<int>& adj_ptr, const std::vector<int>& adj,
+                      std::vector<int>& level, std::vector<int>& last_level) {
+    std::vector<int> frontier(1, root), next;
+    level[root] = 0;
+    int depth = 0;
+    std::vector<int> touched(1, root);
+    last_level = frontier;
+    while (!frontier.empty()) {
+        next.clear();
+        for (size_t f = 0; f < frontier.size(); ++f) {
+            const int v = frontier[f];
+            for (int k = adj_ptr[v]; k < adj_ptr[v + 1]; ++k) {
+                const int u = adj[k];
+                if (level[u] < 0) {
+                    level[u] = depth + 1;
+                    next.push_back(u);
+                    touched.push_back(u);
+                }
+            }
+        }
+        if (!next.empty()) {
+            depth++;
+            last_level = next;
+        }
+        frontier.swap(next);
+    }
+    for (size_t t = 0; t < touched.size(); ++t) level[touched[t]] = -1;
+    return depth;
+}
+
+static void rcm_order(int M, const std::vector<int>& adj_ptr, const std::vector<int>& adj,
+                      std::vector<int>& perm) {
+    std::vector<int> degree(M);
+    for (int i = 0; i < M; ++i) degree[i] = adj_ptr[i + 1] - adj_ptr[i];
+
+    // candidate roots in increasing degree: every component starts from its lowest degree node
+    std::vector<int> by_degree(M);
+    for (int i = 0; i < M; ++i) by_degree[i] = i;
+    std::stable_sort(by_degree.begin(), by_degree.end(),
+                     [&degree](int a, int b) { return degree[a] < degree[b]; });
+
+    std::vector<int> level(M, -1), last_level, neighbours;
+    std::vector<char> visited(M, 0);
+    perm.clear();
+    perm.reserve(M);
+
+    for (int s = 0; s < M; ++s) {
+        int root = by_degree[s];
+        if (visited[root]) continue;
+
+        // pseudo-peripheral node: move to the lowest degree node of the last
+        // BFS level while the eccentricity grows (George-Liu)
+        int depth = bfs_levels(root, adj_ptr, adj, level, last_level);
+        for (int iter = 0; iter < 8; ++iter) {
+            int candidate = last_level[0];
+            for (size_t i = 1; i < last_level.size(); ++i) {
+                if (degree[last_level[i]] < degree[candidate]) candidate = last_level[i];
+            }
+            int cand_depth = bfs_levels(candidate, adj_ptr, adj, level, last_level);
+            if (cand_depth <= depth) break;
+            root = candidate;
+            depth = cand_depth;
+        }
+
+        // Cuthill-McKee BFS, neighbours visited in increasing degree
+        size_t head = perm.size();
+        perm.push_back(root);
+        visited[root] = 1;
+        while (head < perm.size()) {
+            const int v = perm[head++];
+            neighbours.clear();
+            for (int k = adj_ptr[v]; k < adj_ptr[v + 1]; ++k) {
+                const int u = adj[k];
+                if (!visited[u]) {
+                    visited[u] = 1;
+                    neighbours.push_back(u);
+                }
+            }
+            std::sort(neighbours.begin(), neighbours.end(),
+                      [&degree](int a, int b) { return degree[a] < degree[b] || (degree[a] == degree[b] && a < b); });
+            perm.insert(perm.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+    std::reverse(perm.begin(), perm.end());
+}
+
+// ================= Degree sort =================
+
+static void degree_order(int M, const int* row_ptr, const int* col_idx, std::vector<int>& perm) {
+    // degree of A + A^T (duplicates of symmetric entries counted twice, as in A)
+    std::vector<int> degree(M, 0);
+    for (int i = 0; i < M; ++i) {
+        degree[i] += row_ptr[i + 1] - row_ptr[i];
+        for (int k = row_ptr[i]; k < row_ptr[i + 1]; ++k) degree[col_idx[k]]++;
+    }
+    perm.resize(M);
+    for (int i = 0; i < M; ++i) perm[i] = i;
+    std::stable_sort(perm.begin(), perm.end(),
+                     [&degree](int a, int b) { return degree[a] > degree[b]; });
+}
+
+// ================= Gorder =================
+
+// Bucket priority queue with O(1) increment/decrement of a key
+// (the "unit heap" of the Gorder paper)
+struct UnitHeap {
+    std::vector<int> key, prev, next, head;
+    std::vector<char> removed;
+    int top = 0;
+
+    explicit UnitHeap(int n) : key(n, 0), prev(n), next(n), head(1, -1), removed(n, 0) {
+        for (int v = n - 1; v >= 0; --v) push_front(v);
+    }
+
+    void push_front(int v) {
+        const int k = key[v];
+        if (k >= static_cast<int>(head.size())) head.resize(k + 1, -1);
+        prev[v] = -1;
+        next[v] = head[k];
+        if (head[k] >= 0) prev[head[k]] = v;
+        head[k] = v;
+        if (k > top) top = k;
+    }
+
+    void unlink(int v) {
+        if (prev[v] >= 0) next[prev[v]] = next[v];
+        else head[key[v]] = next[v];
+        if (next[v] >= 0) prev[next[v]] = prev[v];
+    }
+
+    void add(int v, int delta) {
+        if (removed[v]) return;
+        unlink(v);
+        key[v] += delta;
+        push_front(v);
+    }
+
+    void remove(int v) {
+        unlink(v);
+        removed[v] = 1;
+    }
+
+    // node with the largest key, -1 if empty
+    int pop_max() {
+        while (top >= 0 && head[top] < 0) top--;
+        if (top < 0) return -1;
+        int v = head[top];
+        remove(v);
+        return v;
+    }
+};
+
+static void gorder_update(int v, int delta, const std::vector<int>& adj_ptr, const std::vector<int>& adj,
+                          UnitHeap& heap) {
+    for (int k = adj_ptr[v]; k < adj_ptr[v + 1]; ++k) {
+        const int u = adj[k];
+        heap.add(u, delta);                 // u is a neighbour of v
+        if (adj_ptr[u + 1] - adj_ptr[u] > GORDER_HUB_DEGREE) continue;
+        for (int kk = adj_ptr[u]; kk < adj_ptr[u + 1]; ++kk) {
+            const int w = adj[kk];
+            if (w != v) heap.add(w, delta); // w shares the neighbour u with v
+        }
+    }
+}
+
+static void gorder_order(int M, const std::vector<int>& adj_ptr, const std::vector<int>& adj,
+                         std::vector<int>& perm) {
+    perm.clear();
+    if (M == 0) return;
+    perm.reserve(M);
+    UnitHeap heap(M);
+
+    int start = 0;
+    for (int i = 1; i < M; ++i) {
+        if (adj_ptr[i + 1] - adj_ptr[i] > adj_ptr[start + 1] - adj_ptr[start]) start = i;
+    }
+    heap.remove(start);
+    perm.push_back(start);
+    gorder_update(start, 1, adj_ptr, adj, heap);
+
+    for (int i = 1; i < M; ++i) {
+        // the node leaving the window no longer contributes to the scores
+        if (i > GORDER_WINDOW) gorder_update(perm[i - GORDER_WINDOW - 1], -1, adj_ptr, adj, heap);
+        const int v = heap.pop_max();
+        perm.push_back(v);
+        gorder_update(v, 1, adj_ptr, adj, heap);
+    }
+}
+
+void compute_permutation(ReorderMethod method, int M, const int* row_ptr, const int* col_idx,
+                         std::vector<int>& perm) {
+    if (method == REORDER_DEGREE) {
+        degree_order(M, row_ptr, col_idx, perm);
+        return;
+    }
+    if (method == REORDER_RCM || method == REORDER_GORDER) {
+        std::vector<int> adj_ptr, adj;
+        symmetric_graph(M, row_ptr, col_idx, adj_ptr, adj);
+        if (method == REORDER_RCM) rcm_order(M, adj_ptr, adj, perm);
+        else gorder_order(M, adj_ptr, adj, perm);
+        return;
+    }
+    perm.resize(M);
+    for (int i = 0; i < M; ++i) perm[i] = i;
+}
+
+// ================= Parallel permutation =================
+
+void permute_csr(int M, const int* row_ptr, const int* col_idx, const double* values,
+                 const std::vector<int>& perm,
+                 std::vector<int>& new_row_ptr, std::vector<int>& new_col_idx,
+                 std::vector<double>& new_values) {
+    std::vector<int> inv(M);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < M; ++i) inv[perm[i]] = i;
+
+    new_row_ptr.assign(M + 1, 0);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < M; ++i) new_row_ptr[i + 1] = row_ptr[perm[i] + 1] - row_ptr[perm[i]];
+    for (int i = 0; i < M; ++i) new_row_ptr[i + 1] += new_row_ptr[i];
+
+    const int nnz = row_ptr[M];
+    new_col_idx.resize(nnz);
+    new_values.resize(nnz);
+
+    #pragma omp parallel
+    {
+        std::vector<std::pair<int, double> > row;
+        #pragma omp for schedule(dynamic, REORDER_BLOCK_SIZE)
+        for (int i = 0; i < M; ++i) {
+            const int old = perm[i];
+            row.clear();
+            for (int k = row_ptr[old]; k < row_ptr[old + 1]; ++k) {
+                row.push_back(std::make_pair(inv[col_idx[k]], values[k]));
+            }
+            std::sort(row.begin(), row.end(),
+                      [](const std::pair<int, double>& a, const std::pair<int, double>& b) { return a.first < b.first; });
+            int dest = new_row_ptr[i];
+            for (size_t e = 0; e < row.size(); ++e, ++dest) {
+                new_col_idx[dest] = row[e].first;
+                new_values[dest] = row[e].second;
+            }
+        }
+    }
+}
+
+void permute_vector(int n, const std::vector<int>& perm, const double* src, double* dst) {
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; ++i) dst[i] = src[perm[i]];
+}
+
+void unpermute_vector(int n, const std::vector<int>& perm, const double* src, double* dst) {
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; ++i) dst[perm[i]] = src[i];
+}
+
+void bandwidth_profile(int M, const int* row_ptr, const int* col_idx,
+                       long long& bandwidth, long long& profile) {
+    long long bw = 0, prof = 0;
+    #pragma omp parallel for schedule(static) reduction(max:bw) reduction(+:prof)
+    for (int i = 0; i < M; ++i) {
+        if (row_ptr[i] == row_ptr[i + 1]) continue;
+        const int first = col_idx[row_ptr[i]];
+        const int last = col_idx[row_ptr[i + 1] - 1];
+        bw = std::max(bw, static_cast<long long>(std::abs(i - first)));
+        bw = std::max(bw, static_cast<long long>(std::abs(last - i)));
+        if (first < i) prof += i - first;
+    }
+    bandwidth = bw;
+    profile = prof;
+}
+
+void reorder_csr(ReorderMethod method, int M, const int* row_ptr, const int* col_idx, const double* values,
+                 ReorderedCsr& B) {
+    B = ReorderedCsr();
+    B.method = method;
+    bandwidth_profile(M, row_ptr, col_idx, B.bandwidth_before, B.profile_before);
+
+    auto t0 = std::chrono::steady_clock::now();
+    compute_permutation(method, M, row_ptr, col_idx, B.perm);
+    auto t1 = std::chrono::steady_clock::now();
+    permute_csr(M, row_ptr, col_idx, values, B.perm, B.row_ptr, B.col_idx, B.values);
+    auto t2 = std::chrono::steady_clock::now();
+    B.order_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    B.permute_ms = std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+    bandwidth_profile(M, B.row_ptr.data(), B.col_idx.data(), B.bandwidth_after, B.profile_after);
+}
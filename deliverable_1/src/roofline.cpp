@@ -0,0 +1,239 @@
+#include "../include/roofline.hpp"
+#include "../include/bench.hpp"
+#include "../include/numa_alloc.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <omp.h>
+
+// keeps the results of the read-only probes alive
+static volatile double roofline_sink;
+
+static long long array_elements() {
+    const long long bytes = std::max(ROOFLINE_MIN_ARRAY_BYTES,
+                                     std::min(ROOFLINE_MAX_ARRAY_BYTES, 4 * llc_total_bytes()));
+    return bytes / static_cast<long long>(sizeof(double));
+}
+
+// splitmix64 finaliser: a fixed pseudo-random column for every element
+static inline int scatter_index(long long i, long long n) {
+    uint64_t z = static_cast<uint64_t>(i) + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return static_cast<int>(z % static_cast<uint64_t>(n));
+}
+
+// best of ROOFLINE_TRIALS timed runs after an untimed one
+template <typename F>
+static double best_ms(F fn) {
+    fn();
+    double best = 0.0;
+    for (int i = 0; i < ROOFLINE_TRIALS; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (i == 0 || ms < best) best = ms;
+    }
+    return best;
+}
+
+// independent chains hide the multiply-add latency on every vector lane
+static double fp_chains() {
+    double acc[ROOFLINE_FP_CHAINS];
+    for (int j = 0; j < ROOFLINE_FP_CHAINS; ++j) acc[j] = 1.0 + 1e-3 * j;
+    const double m = 0.999999, a = 1e-7;
+    for (int it = 0; it < ROOFLINE_FP_ITERS; ++it) {
+        #pragma omp simd
+        for (int j = 0; j < ROOFLINE_FP_CHAINS; ++j) {
+            acc[j] = acc[j] * m + a;
+        }
+    }
+    double sum = 0.0;
+    for (int j = 0; j < ROOFLINE_FP_CHAINS; ++j) sum += acc[j];
+    return sum;
+}
+
+static double to_gbs(double bytes, double ms) {
+    return ms > 0.0 ? bytes / (ms / 1000.0) / 1e9 : 0.0;
+}
+
+void roofline_calibrate(int threads, RooflineCalib& calib) {
+    auto start = std::chrono::steady_clock::now();
+    calib = RooflineCalib();
+    calib.host = bench_host_name();
+    calib.threads = threads = std::max(1, threads);
+
+    const long long n = array_elements();
+    first_touch_vector<double> a(n), b(n), c(n);
+    first_touch_vector<int> idx(n);
+    double* __restrict__ pa = a.data();
+    const double* __restrict__ pb = b.data();
+    const double* __restrict__ pc = c.data();
+    const int* __restrict__ pidx = idx.data();
+
+    // first touch with the partition of the probes
+    #pragma omp parallel for schedule(static) num_threads(threads)
+    for (long long i = 0; i < n; ++i) {
+        a[i] = 0.0;
+        b[i] = 1.0 + 1e-9 * (i & 1023);
+        c[i] = 2.0;
+        idx[i] = scatter_index(i, n);
+    }
+
+    const double copy_ms = best_ms([&]() {
+        #pragma omp parallel for schedule(static) num_threads(threads)
+        for (long long i = 0; i < n; ++i) pa[i] = pb[i];
+    });
+    const double triad_ms = best_ms([&]() {
+        const double s = 3.0;
+        #pragma omp parallel for schedule(static) num_threads(threads)
+        for (long long i = 0; i < n; ++i) pa[i] = pb[i] + s * pc[i];
+    });
+    const long long ng = n / ROOFLINE_GATHER_FRACTION;
+    const double gather_ms = best_ms([&]() {
+        double sum = 0.0;
+        #pragma omp parallel for schedule(static) reduction(+:sum) num_threads(threads)
+        for (long long k = 0; k < ng; ++k) sum += pb[k] * pc[pidx[k]];
+        roofline_sink = sum;
+    });
+    const double fp_ms = best_ms([&]() {
+        double sum = 0.0;
+        #pragma omp parallel reduction(+:sum) num_threads(threads)
+        sum += fp_chains();
+        roofline_sink = sum;
+    });
+
+    calib.copy_gbs = to_gbs(16.0 * n, copy_ms);
+    calib.triad_gbs = to_gbs(24.0 * n, triad_ms);
+    calib.gather_gbs = to_gbs((12.0 + ROOFLINE_LINE_BYTES) * ng, gather_ms);
+    const double flops = 2.0 * ROOFLINE_FP_CHAINS * static_cast<double>(ROOFLINE_FP_ITERS) * threads;
+    calib.peak_gflops = fp_ms > 0.0 ? flops / (fp_ms / 1000.0) / 1e9 : 0.0;
+    calib.calib_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool roofline_calibrate_sweep(const std::string& path, int max_threads, std::vector<RooflineCalib>& calibs) {
+    calibs.clear();
+    max_threads = std::max(1, max_threads);
+    bool ok = true;
+    for (int t = 1;; t = std::min(2 * t, max_threads)) {
+        RooflineCalib calib;
+        roofline_calibrate(t, calib);
+        calibs.push_back(calib);
+        if (!roofline_cache_store(path, calib)) ok = false;
+        if (t == max_threads) break;
+    }
+    return ok;
+}
+
+// ================= Cache =================
+// one line per host and thread count:
+// host threads copy_gbs triad_gbs gather_gbs peak_gflops
+
+static bool parse_entry(const std::string& line, RooflineCalib& c) {
+    if (line.empty() || line[0] == '#') return false;
+    std::istringstream in(line);
+    return static_cast<bool>(in >> c.host >> c.threads >> c.copy_gbs >> c.triad_gbs >> c.gather_gbs >> c.peak_gflops);
+}
+
+static std::string format_entry(const RooflineCalib& c) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%s %d %.3f %.3f %.3f %.3f", c.host.c_str(), c.threads,
+                  c.copy_gbs, c.triad_gbs, c.gather_gbs, c.peak_gflops);
+    return line;
+}
+
+bool roofline_cache_lookup(const std::string& path, int threads, RooflineCalib& calib) {
+    std::ifstream in(path);
+    if (!in.is_open()) return false;
+
+    const std::string host = bench_host_name();
+    std::string line;
+    RooflineCalib c;
+    while (std::getline(in, line)) {
+        if (parse_entry(line, c) && c.host == host && c.threads == threads) {
+            calib = c;
+            calib.calib_ms = 0.0;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool roofline_cache_store(const std::string& path, const RooflineCalib& calib) {
+    std::vector<std::string> lines;
+    {
+        std::ifstream in(path);
+        std::string line;
+        RooflineCalib c;
+        while (std::getline(in, line)) {
+            if (parse_entry(line, c) && c.host == calib.host && c.threads == calib.threads) {
+                continue;
+            }
+            if (!line.empty()) lines.push_back(line);
+        }
+    }
+    if (lines.empty()) {
+        lines.push_back("# host threads copy_gbs triad_gbs gather_gbs peak_gflops");
+    }
+    lines.push_back(format_entry(calib));
+
+    std::ofstream out(path, std::ofstream::out | std::ofstream::trunc);
+    if (!out.is_open()) return false;
+    for (size_t i = 0; i < lines.size(); ++i) out << lines[i] << "\n";
+    return static_cast<bool>(out);
+}
+
+// ================= Reports =================
+
+double csr_spmv_bytes(long long nnz, long long M, double value_bytes, double y_bytes) {
+    return (value_bytes + 4.0) * nnz + y_bytes * M;
+}
+
+double roofline_attainable(const RooflineCalib& calib, double intensity, double bandwidth_gbs) {
+    return std::min(calib.peak_gflops, intensity * bandwidth_gbs);
+}
+
+double roofline_percent(const RooflineCalib& calib, double gflops, double intensity) {
+    if (calib.threads == 0) return -1.0;
+    const double roof = roofline_attainable(calib, intensity, calib.triad_gbs);
+    return roof > 0.0 ? 100.0 * gflops / roof : -1.0;
+}
+
+void roofline_print(const RooflineCalib& calib, int threads, double gflops, double intensity) {
+    if (calib.threads == 0) {
+        std::cout << "Roofline           : not calibrated for " << threads
+                  << " threads on this host (run parallel_spmv_csr --calibrate)\n";
+        return;
+    }
+    const double roof = roofline_attainable(calib, intensity, calib.triad_gbs);
+    std::cout << "Roofline           : triad " << std::fixed << std::setprecision(2) << calib.triad_gbs
+              << " GB/s, copy " << calib.copy_gbs << " GB/s, gather " << calib.gather_gbs
+              << " GB/s, peak " << calib.peak_gflops << " GFLOPS (" << calib.threads << " threads)\n";
+    std::cout << "Attainable         : " << roof << " GFLOPS at " << std::setprecision(3) << intensity
+              << " FLOP/byte (" << (roof < calib.peak_gflops ? "memory" : "compute") << " bound)\n";
+    const double pct = roof > 0.0 ? 100.0 * gflops / roof : 0.0;
+    std::cout << "% of attainable    : " << std::setprecision(1) << pct << " %"
+              << (pct > 100.0 ? "   (above the DRAM roof: the working set stays in cache)" : "") << "\n";
+}
+
+void roofline_print_calibration(const std::vector<RooflineCalib>& calibs) {
+    if (calibs.empty()) return;
+    std::cout << "\n=== Roofline Calibration (" << calibs[0].host << ") ===\n";
+    std::cout << std::setw(8) << "Threads" << std::setw(12) << "Copy GB/s" << std::setw(12) << "Triad GB/s"
+              << std::setw(13) << "Gather GB/s" << std::setw(14) << "Peak GFLOPS" << std::setw(11) << "Time (s)" << "\n";
+    for (const RooflineCalib& c : calibs) {
+        std::cout << std::setw(8) << c.threads << std::fixed << std::setprecision(2)
+                  << std::setw(12) << c.copy_gbs << std::setw(12) << c.triad_gbs
+                  << std::setw(13) << c.gather_gbs << std::setw(14) << c.peak_gflops
+                  << std::setw(11) << c.calib_ms / 1000.0 << "\n";
+    }
+    std::cout << "==========================================\n";
+}
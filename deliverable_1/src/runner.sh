@@ -8,8 +8,10 @@ MATRIX_FILE="../data/cage14/cage14.mtx"     # default matrix file
 RUN_COO=""      #--coo
 RUN_SEQ_CSR=""  #--seq-csr
 RUN_PAR_CSR=""  #--par-sqr
+RUN_PAR_SELL="" #--par-sell
 PY_ARGS=""
 NUM_THREADS=8
+SCHEDULE="guided" # --schedule guided|merge (parallel csr only)
 USE_PYTHON=""
 
 while [[ $# -gt 0 ]]; do
@@ -24,6 +26,7 @@ while [[ $# -gt 0 ]]; do
         --coo)          RUN_COO="1"; shift ;;
         --seq-csr)      RUN_SEQ_CSR="1"; shift ;;
         --par-csr)      RUN_PAR_CSR="1"; shift ;;
+        --par-sell)     RUN_PAR_SELL="1"; shift ;;
         --python)       USE_PYTHON="1"; shift ;;
         --threads)
             [[ -z "${2:-}" ]] && { echo "Error: --threads needs a number" >&2; exit 1; }
@@ -33,9 +36,16 @@ while [[ $# -gt 0 ]]; do
             fi
             NUM_THREADS="$2"; shift 2
             ;;
+        --schedule)
+            if [[ "${2:-}" != "guided" && "${2:-}" != "merge" ]]; then
+                echo "Error: --schedule must be guided or merge" >&2
+                exit 1
+            fi
+            SCHEDULE="$2"; shift 2
+            ;;
         -*)
             echo "Warning: unknown option $1" >&2
-            echo "Valid options: --verbose, --show-plot, --cachegrind, --matrix, --benchmark, --coo, --seq-csr, --par-csr, --threads" >&2
+            echo "Valid options: --verbose, --show-plot, --cachegrind, --matrix, --benchmark, --coo, --seq-csr, --par-csr, --par-sell, --threads, --schedule" >&2
             exit 1
             shift
             ;;
@@ -43,9 +53,9 @@ while [[ $# -gt 0 ]]; do
     esac
 done
 
-if [[ -z "$RUN_COO$RUN_SEQ_CSR$RUN_PAR_CSR" ]]; then
+if [[ -z "$RUN_COO$RUN_SEQ_CSR$RUN_PAR_CSR$RUN_PAR_SELL" ]]; then
     # none specified → run everything
-    RUN_COO="1"; RUN_SEQ_CSR="1"; RUN_PAR_CSR="1"
+    RUN_COO="1"; RUN_SEQ_CSR="1"; RUN_PAR_CSR="1"; RUN_PAR_SELL="1"
 fi
 
 if [[ ! -f "$MATRIX_FILE" ]]
@@ -104,7 +114,14 @@ export OMP_NUM_THREADS=$NUM_THREADS
 if [[ -n "$RUN_PAR_CSR" ]]; then
     run_cachegrind \
         ../outputs/par_csr_cachegrind_output \
-        ./../outputs/parallel_spmv_csr $VERBOSE_FLAG $MATRIX_FILE
+        ./../outputs/parallel_spmv_csr $VERBOSE_FLAG --schedule $SCHEDULE $MATRIX_FILE
+        echo ""
+fi
+
+if [[ -n "$RUN_PAR_SELL" ]]; then
+    run_cachegrind \
+        ../outputs/par_sell_cachegrind_output \
+        ./../outputs/parallel_spmv_sell $VERBOSE_FLAG $MATRIX_FILE
         echo ""
 fi
 
@@ -113,6 +130,7 @@ cd ../benchmarks
 if [[ -n "$RUN_COO" ]]; then PY_ARGS+=" --coo";fi
 if [[ -n "$RUN_SEQ_CSR" ]]; then PY_ARGS+=" --csr";fi
 if [[ -n "$RUN_PAR_CSR" ]]; then PY_ARGS+=" --par-cs";fi
+if [[ -n "$RUN_PAR_SELL" ]]; then PY_ARGS+=" --par-sell";fi
 
 
 if [[ -n "$USE_PYTHON" ]]; then
@@ -0,0 +1,255 @@
+#include "../include/scaling.hpp"
+#include "../include/autotune.hpp"
+#include "../include/roofline.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <omp.h>
+
+const char* schedule_kind_name(ScheduleKind kind) {
+    switch (kind) {
+        case SCHED_STATIC: return "static";
+        case SCHED_DYNAMIC: return "dynamic";
+        case SCHED_GUIDED: return "guided";
+    }
+    return "unknown";
+}
+
+bool schedule_from_string(const std::string& text, ScheduleChoice& sched) {
+    const size_t sep = text.find_first_of(":,");
+    const std::string kind = text.substr(0, sep);
+    ScheduleChoice s;
+    if (kind == "static") s.kind = SCHED_STATIC;
+    else if (kind == "dynamic") s.kind = SCHED_DYNAMIC;
+    else if (kind == "guided") s.kind = SCHED_GUIDED;
+    else return false;
+    if (sep != std::string::npos) {
+        char* end = nullptr;
+        const long chunk = std::strtol(text.c_str() + sep + 1, &end, 10);
+        if (chunk <= 0 || *end != '\0') return false;
+        s.chunk = static_cast<int>(chunk);
+    }
+    sched = s;
+    return true;
+}
+
+std::string schedule_describe(const ScheduleChoice& sched) {
+    std::string name = schedule_kind_name(sched.kind);
+    return sched.chunk > 0 ? name + ":" + std::to_string(sched.chunk) : name;
+}
+
+bool schedule_list_from_string(const std::string& text, std::vector<ScheduleChoice>& scheds) {
+    scheds.clear();
+    std::stringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        ScheduleChoice s;
+        if (!schedule_from_string(item, s)) return false;
+        scheds.push_back(s);
+    }
+    return !scheds.empty();
+}
+
+static omp_sched_t omp_kind(ScheduleKind kind) {
+    switch (kind) {
+        case SCHED_STATIC: return omp_sched_static;
+        case SCHED_DYNAMIC: return omp_sched_dynamic;
+        case SCHED_GUIDED: return omp_sched_guided;
+    }
+    return omp_sched_guided;
+}
+
+void spmv_csr_schedule(const ScheduleChoice& sched, int M, const int* __restrict__ row_ptr,
+                       const int* __restrict__ col_idx, const double* __restrict__ values,
+                       const double* __restrict__ x, double* __restrict__ y) {
+    // the runtime schedule is an ICV of the calling thread, inherited by the team
+    omp_set_schedule(omp_kind(sched.kind), sched.chunk);
+    #pragma omp parallel for schedule(runtime)
+    for (int r = 0; r < M; ++r) {
+        double sum = 0.0;
+        #pragma omp simd reduction(+:sum)
+        for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+            sum += values[k] * x[col_idx[k]];
+        }
+        y[r] = sum;
+    }
+}
+
+void scaling_sweep(int M, const int* row_ptr, const int* col_idx, const double* values,
+                   const double* x, double* y, const std::vector<int>& threads,
+                   const std::vector<ScheduleChoice>& scheds, const BenchConfig& cfg, ScalingSweep& sweep) {
+    sweep = ScalingSweep();
+    BenchConfig point_cfg = cfg;
+    point_cfg.max_seconds = std::min(cfg.max_seconds, SCALING_MAX_SECONDS);
+    point_cfg.verbose = false;
+
+    for (size_t t = 0; t < threads.size(); ++t) {
+        omp_set_num_threads(threads[t]);
+        ScalingRow row;
+        row.threads = threads[t];
+        for (size_t s = 0; s < scheds.size(); ++s) {
+            ScalingPoint p;
+            p.threads = threads[t];
+            p.sched = scheds[s];
+            auto run_spmv = [&]() { spmv_csr_schedule(p.sched, M, row_ptr, col_idx, values, x, y); };
+            p.stats.warmup_iters = bench_warmup(point_cfg, run_spmv);
+            bench_sample(point_cfg, run_spmv, p.stats);
+            sweep.points.push_back(p);
+
+            const int idx = static_cast<int>(sweep.points.size()) - 1;
+            if (row.best < 0 || p.stats.median_ms < sweep.points[row.best].stats.median_ms) row.best = idx;
+        }
+        row.median_ms = sweep.points[row.best].stats.median_ms;
+        sweep.rows.push_back(row);
+    }
+    if (sweep.rows.empty()) return;
+
+    // speedup and efficiency against the smallest thread count swept
+    const double bytes = csr_spmv_bytes(row_ptr[M], M);
+    int base = 0;
+    for (size_t r = 1; r < sweep.rows.size(); ++r) {
+        if (sweep.rows[r].threads < sweep.rows[base].threads) base = static_cast<int>(r);
+    }
+    double best_gbs = 0.0, best_ms = 0.0;
+    for (size_t r = 0; r < sweep.rows.size(); ++r) {
+        ScalingRow& row = sweep.rows[r];
+        row.speedup = row.median_ms > 0.0 ? sweep.rows[base].median_ms / row.median_ms : 0.0;
+        row.efficiency = row.speedup * sweep.rows[base].threads / row.threads;
+        row.gbs = row.median_ms > 0.0 ? bytes / (row.median_ms / 1000.0) / 1e9 : 0.0;
+        best_gbs = std::max(best_gbs, row.gbs);
+        if (r == 0 || row.median_ms < best_ms) best_ms = row.median_ms;
+    }
+
+    // knee: fewest threads reaching the saturated bandwidth; production
+    // choice: fewest threads within SCALING_TIE of the fastest time
+    for (size_t r = 0; r < sweep.rows.size(); ++r) {
+        const ScalingRow& row = sweep.rows[r];
+        if (row.gbs >= SCALING_KNEE_FRACTION * best_gbs &&
+            (sweep.knee_threads == 0 || row.threads < sweep.knee_threads)) {
+            sweep.knee_threads = row.threads;
+        }
+        if (row.median_ms <= (1.0 + SCALING_TIE) * best_ms &&
+            (sweep.best_row < 0 || row.threads < sweep.rows[sweep.best_row].threads)) {
+            sweep.best_row = static_cast<int>(r);
+        }
+    }
+}
+
+void scaling_record(const BenchConfig& cfg, const std::string& bench, const std::string& matrix,
+                    const ScalingSweep& sweep) {
+    for (const ScalingPoint& p : sweep.points) {
+        bench_record(cfg, bench, matrix, "csr/" + schedule_describe(p.sched), p.threads, p.stats);
+    }
+}
+
+void scaling_print(const ScalingSweep& sweep, const std::string& matrix, int M, int N, int nnz,
+                   const std::string& cache_path, bool verbose) {
+    // points are stored thread count major, every schedule in the same order
+    const size_t num_scheds = sweep.rows.empty() ? 0 : sweep.points.size() / sweep.rows.size();
+
+    std::cout << "\n=== Parallel CSR Thread-Scaling Sweep ===\n";
+    std::cout << "Matrix             : " << matrix << "\n";
+    std::cout << "Dimensions         : " << M << " x " << N << "   (nnz = " << nnz << ")\n";
+    std::cout << "Schedules          : " << num_scheds << " per thread count\n";
+    if (sweep.rows.empty()) {
+        std::cout << "==========================================\n";
+        return;
+    }
+    if (verbose) {
+        // median of every point, one column per thread count
+        std::cout << "\n" << std::left << std::setw(14) << "Median (ms)" << std::right;
+        for (const ScalingRow& row : sweep.rows) std::cout << std::setw(10) << row.threads;
+        std::cout << "\n";
+        for (size_t s = 0; s < num_scheds; ++s) {
+            std::cout << std::left << std::setw(14) << schedule_describe(sweep.points[s].sched) << std::right;
+            for (size_t r = 0; r < sweep.rows.size(); ++r) {
+                const ScalingPoint& p = sweep.points[r * num_scheds + s];
+                std::cout << std::setw(10) << std::fixed << std::setprecision(3) << p.stats.median_ms;
+            }
+            std::cout << "\n";
+        }
+    }
+    std::cout << "\n" << std::setw(8) << "Threads" << "  " << std::left << std::setw(13) << "Schedule" << std::right
+              << std::setw(13) << "Median (ms)" << std::setw(10) << "Speedup" << std::setw(12) << "Efficiency"
+              << std::setw(10) << "GFLOPS" << std::setw(10) << "GB/s" << std::setw(8) << "% roof" << "\n";
+    bool calibrated = true;
+    for (size_t r = 0; r < sweep.rows.size(); ++r) {
+        const ScalingRow& row = sweep.rows[r];
+        const double gflops = 2.0 * nnz / (row.median_ms / 1000.0) / 1e9;
+        RooflineCalib roof;
+        calibrated &= roofline_cache_lookup(ROOFLINE_DEFAULT_CACHE, row.threads, roof);
+        const double roof_pct = roofline_percent(roof, gflops, 2.0 * nnz / csr_spmv_bytes(nnz, M));
+        std::cout << std::setw(8) << row.threads << "  " << std::left << std::setw(13)
+                  << schedule_describe(sweep.points[row.best].sched) << std::right
+                  << std::setw(13) << std::fixed << std::setprecision(3) << row.median_ms
+                  << std::setw(9) << std::setprecision(2) << row.speedup << "x"
+                  << std::setw(11) << std::setprecision(1) << 100.0 * row.efficiency << "%"
+                  << std::setw(10) << std::setprecision(2) << gflops
+                  << std::setw(10) << std::setprecision(2) << row.gbs;
+        if (roof_pct < 0.0) {
+            std::cout << std::setw(8) << "-";
+        } else {
+            std::cout << std::setw(8) << std::setprecision(1) << roof_pct;
+        }
+        std::cout << (static_cast<int>(r) == sweep.best_row ? "   <- best" : "") << "\n";
+    }
+    if (!calibrated) {
+        std::cout << "(% roof: some thread counts are not calibrated, run parallel_spmv_csr --calibrate)\n";
+    }
+    std::cout << "\nBandwidth knee     : " << sweep.knee_threads << " threads";
+    if (sweep.knee_threads == sweep.rows.back().threads && sweep.rows.size() > 1) {
+        std::cout << " (not reached: still scaling at the largest count swept)";
+    } else {
+        std::cout << " (within " << std::setprecision(0) << 100.0 * SCALING_KNEE_FRACTION
+                  << "% of the best bandwidth)";
+    }
+    if (sweep.best_row >= 0) {
+        const ScalingRow& best = sweep.rows[sweep.best_row];
+        std::cout << "\nBest configuration : " << best.threads << " threads, schedule "
+                  << schedule_describe(sweep.points[best.best].sched) << " (stored in "
+                  << cache_path << ", use --schedule tuned)";
+    }
+    std::cout << "\n==========================================\n";
+}
+
+// ================= Tuning cache (key "scaling") =================
+// kernel: schedule kind, param1: chunk, param2: thread count
+
+static TuningEntry scaling_entry(uint64_t hash, int threads, const ScalingPoint& p) {
+    TuningEntry e;
+    e.hash = hash;
+    e.key = "scaling";
+    e.threads = threads;
+    e.kernel = schedule_kind_name(p.sched.kind);
+    e.param1 = p.sched.chunk;
+    e.param2 = p.threads;
+    e.time_ms = p.stats.median_ms;
+    return e;
+}
+
+bool scaling_cache_store(const std::string& path, uint64_t hash, const ScalingSweep& sweep) {
+    if (sweep.best_row < 0) return true;
+    bool ok = true;
+    for (size_t r = 0; r < sweep.rows.size(); ++r) {
+        const ScalingRow& row = sweep.rows[r];
+        ok &= tuning_cache_store(path, scaling_entry(hash, row.threads, sweep.points[row.best]));
+    }
+    const ScalingRow& best = sweep.rows[sweep.best_row];
+    ok &= tuning_cache_store(path, scaling_entry(hash, 0, sweep.points[best.best]));
+    return ok;
+}
+
+bool scaling_cache_lookup(const std::string& path, uint64_t hash, int threads,
+                          ScheduleChoice& sched, int& best_threads) {
+    TuningEntry e;
+    if (!tuning_cache_lookup(path, hash, "scaling", threads, e)) return false;
+    ScheduleChoice s;
+    if (!schedule_from_string(e.kernel, s) || e.param1 < 0 || e.param2 <= 0) return false;
+    s.chunk = e.param1;
+    sched = s;
+    best_threads = e.param2;
+    return true;
+}
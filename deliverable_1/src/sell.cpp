@@ -0,0 +1,160 @@
+#include "../include/sell.hpp"
+#include "../include/matrix_io.hpp"
+
+#include <algorithm>
+#include <omp.h>
+
+void csr_to_sell(int M, int N, const int* row_ptr, const int* col_idx,
+                 const double* values, int C, int sigma, SellMatrix& sell) {
+    if (C < 1) C = 1;
+    if (sigma < 1) sigma = 1;
+    // sorting windows must contain whole chunks
+    if (sigma > 1) sigma = ((sigma + C - 1) / C) * C;
+
+    sell.M = M;
+    sell.N = N;
+    sell.C = C;
+    sell.sigma = sigma;
+    sell.num_chunks = (M + C - 1) / C;
+    sell.nnz = row_ptr[M];
+
+    const int padded_rows = sell.num_chunks * C;
+
+    // ===== Sort rows by decreasing length inside each sigma window =====
+    sell.perm.resize(padded_rows);
+    for (int i = 0; i < padded_rows; ++i) sell.perm[i] = i;
+    if (sigma > 1) {
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int w = 0; w < M; w += sigma) {
+            int w_end = std::min(w + sigma, M);
+            std::stable_sort(sell.perm.begin() + w, sell.perm.begin() + w_end,
+                             [row_ptr](int a, int b) {
+                                 return (row_ptr[a + 1] - row_ptr[a]) > (row_ptr[b + 1] - row_ptr[b]);
+                             });
+        }
+    }
+
+    // ===== Chunk widths and offsets =====
+    sell.chunk_len.assign(sell.num_chunks, 0);
+    sell.chunk_ptr.assign(sell.num_chunks + 1, 0);
+    #pragma omp parallel for schedule(static)
+    for (int c = 0; c < sell.num_chunks; ++c) {
+        int width = 0;
+        for (int l = 0; l < C; ++l) {
+            int r = sell.perm[c * C + l];
+            if (r < M) width = std::max(width, row_ptr[r + 1] - row_ptr[r]);
+        }
+        sell.chunk_len[c] = width;
+    }
+    for (int c = 0; c < sell.num_chunks; ++c) {
+        sell.chunk_ptr[c + 1] = sell.chunk_ptr[c] + sell.chunk_len[c] * C;
+    }
+
+    // ===== Fill column-major chunks =====
+    const int stored = sell.chunk_ptr[sell.num_chunks];
+    sell.col_idx.resize(stored);
+    sell.values.resize(stored);
+    #pragma omp parallel for schedule(static)
+    for (int c = 0; c < sell.num_chunks; ++c) {
+        int base = sell.chunk_ptr[c];
+        for (int l = 0; l < C; ++l) {
+            int r = sell.perm[c * C + l];
+            int len = 0, start = 0;
+            if (r < M) {
+                start = row_ptr[r];
+                len = row_ptr[r + 1] - start;
+            }
+            int pad_col = len > 0 ? col_idx[start + len - 1] : 0;
+            for (int j = 0; j < sell.chunk_len[c]; ++j) {
+                int dest = base + j * C + l;
+                if (j < len) {
+                    sell.col_idx[dest] = col_idx[start + j];
+                    sell.values[dest] = values[start + j];
+                } else {
+                    sell.col_idx[dest] = pad_col;
+                    sell.values[dest] = 0.0;
+                }
+            }
+        }
+    }
+}
+
+void coo_to_sell(int M, int N, int nz,
+                 const std::vector<int>& row_coo, const std::vector<int>& col_coo,
+                 const std::vector<double>& val_coo,
+                 int C, int sigma, SellMatrix& sell) {
+    std::vector<int> row_ptr, col_idx;
+    std::vector<double> values;
+    coo_to_csr(M, nz, row_coo, col_coo, val_coo, row_ptr, col_idx, values);
+    csr_to_sell(M, N, row_ptr.data(), col_idx.data(), values.data(), C, sigma, sell);
+}
+
+// Chunk height known at compile time: the lane loop is fully vectorised
+// and the partial sums stay in registers.
+template <int C>
+static void spmv_sell_fixed(const SellMatrix& A, const double* x, double* y) {
+    const int* __restrict__ cols = A.col_idx.data();
+    const double* __restrict__ vals = A.values.data();
+    const int* perm = A.perm.data();
+    const int M = A.M;
+
+    #pragma omp parallel for schedule(guided, 1)
+    for (int c = 0; c < A.num_chunks; ++c) {
+        double sum[C];
+        #pragma omp simd
+        for (int l = 0; l < C; ++l) sum[l] = 0.0;
+
+        const int base = A.chunk_ptr[c];
+        const int len = A.chunk_len[c];
+        for (int j = 0; j < len; ++j) {
+            const int off = base + j * C;
+            #pragma omp simd
+            for (int l = 0; l < C; ++l) {
+                sum[l] += vals[off + l] * x[cols[off + l]];
+            }
+        }
+
+        for (int l = 0; l < C; ++l) {
+            int r = perm[c * C + l];
+            if (r < M) y[r] = sum[l];
+        }
+    }
+}
+
+// Generic fallback for chunk heights without a specialisation
+static void spmv_sell_generic(const SellMatrix& A, const double* x, double* y) {
+    const int C = A.C;
+    const int M = A.M;
+
+    #pragma omp parallel
+    {
+        std::vector<double> sum(C);
+        #pragma omp for schedule(guided, 1)
+        for (int c = 0; c < A.num_chunks; ++c) {
+            std::fill(sum.begin(), sum.end(), 0.0);
+            const int base = A.chunk_ptr[c];
+            for (int j = 0; j < A.chunk_len[c]; ++j) {
+                const int off = base + j * C;
+                #pragma omp simd
+                for (int l = 0; l < C; ++l) {
+                    sum[l] += A.values[off + l] * x[A.col_idx[off + l]];
+                }
+            }
+            for (int l = 0; l < C; ++l) {
+                int r = A.perm[c * C + l];
+                if (r < M) y[r] = sum[l];
+            }
+        }
+    }
+}
+
+void spmv_sell(const SellMatrix& A, const double* x, double* y) {
+    switch (A.C) {
+        case 2:  spmv_sell_fixed<2>(A, x, y);  break;
+        case 4:  spmv_sell_fixed<4>(A, x, y);  break;
+        case 8:  spmv_sell_fixed<8>(A, x, y);  break;
+        case 16: spmv_sell_fixed<16>(A, x, y); break;
+        case 32: spmv_sell_fixed<32>(A, x, y); break;
+        default: spmv_sell_generic(A, x, y);   break;
+    }
+}
@@ -0,0 +1,65 @@
+#include "../include/spmm.hpp"
+
+#include <omp.h>
+
+#define SPMM_BLOCK_SIZE 10
+
+// k known at compile time: the accumulator row lives in registers and the
+// k-loop is a single (or a few) vector FMA per nonzero.
+template <int K>
+static void spmm_csr_fixed(int M, const int* __restrict__ row_ptr,
+                           const int* __restrict__ col_idx, const double* __restrict__ values,
+                           const double* __restrict__ X, double* __restrict__ Y) {
+    #pragma omp parallel for schedule(guided, SPMM_BLOCK_SIZE)
+    for (int r = 0; r < M; ++r) {
+        double acc[K];
+        #pragma omp simd
+        for (int c = 0; c < K; ++c) acc[c] = 0.0;
+
+        for (int idx = row_ptr[r]; idx < row_ptr[r + 1]; ++idx) {
+            const double a = values[idx];
+            const double* xr = X + static_cast<long long>(col_idx[idx]) * K;
+            #pragma omp simd
+            for (int c = 0; c < K; ++c) {
+                acc[c] += a * xr[c];
+            }
+        }
+
+        double* yr = Y + static_cast<long long>(r) * K;
+        #pragma omp simd
+        for (int c = 0; c < K; ++c) yr[c] = acc[c];
+    }
+}
+
+// Generic k: accumulates directly into the output row
+static void spmm_csr_generic(int M, const int* __restrict__ row_ptr,
+                             const int* __restrict__ col_idx, const double* __restrict__ values,
+                             int k, const double* __restrict__ X, double* __restrict__ Y) {
+    #pragma omp parallel for schedule(guided, SPMM_BLOCK_SIZE)
+    for (int r = 0; r < M; ++r) {
+        double* yr = Y + static_cast<long long>(r) * k;
+        #pragma omp simd
+        for (int c = 0; c < k; ++c) yr[c] = 0.0;
+
+        for (int idx = row_ptr[r]; idx < row_ptr[r + 1]; ++idx) {
+            const double a = values[idx];
+            const double* xr = X + static_cast<long long>(col_idx[idx]) * k;
+            #pragma omp simd
+            for (int c = 0; c < k; ++c) {
+                yr[c] += a * xr[c];
+            }
+        }
+    }
+}
+
+void spmm_csr(int M, const int* row_ptr, const int* col_idx, const double* values,
+              int k, const double* X, double* Y) {
+    switch (k) {
+        case 1:  spmm_csr_fixed<1>(M, row_ptr, col_idx, values, X, Y);  break;
+        case 2:  spmm_csr_fixed<2>(M, row_ptr, col_idx, values, X, Y);  break;
+        case 4:  spmm_csr_fixed<4>(M, row_ptr, col_idx, values, X, Y);  break;
+        case 8:  spmm_csr_fixed<8>(M, row_ptr, col_idx, values, X, Y);  break;
+        case 16: spmm_csr_fixed<16>(M, row_ptr, col_idx, values, X, Y); break;
+        default: spmm_csr_generic(M, row_ptr, col_idx, values, k, X, Y); break;
+    }
+}
@@ -0,0 +1,359 @@
+#include "../include/spmv.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <omp.h>
+
+CsrMatrix csr_matrix_view(const LoadedCsr& A) {
+    return csr_matrix_view(A.M, A.N, A.row_ptr, A.col_idx, A.values);
+}
+
+CsrMatrix csr_matrix_view(int M, int N, const int* row_ptr, const int* col_idx, const double* values) {
+    CsrMatrix A;
+    A.M = M;
+    A.N = N;
+    A.nnz = row_ptr[M];
+    A.row_ptr = row_ptr;
+    A.col_idx = col_idx;
+    A.values = values;
+    return A;
+}
+
+// format from the tuning cache, or from trial runs (then stored)
+static void plan_autotune(const CsrMatrix& A, const SpmvOptions& opt, SpmvPlan& plan,
+                          int& param1, int& param2) {
+    auto start = std::chrono::steady_clock::now();
+    plan.tuned = true;
+    plan.hash = matrix_hash(A.M, A.N, A.row_ptr, A.col_idx);
+    compute_features(A.M, A.N, A.row_ptr, A.col_idx, plan.features);
+
+    TuningEntry entry;
+    plan.cache_hit = !opt.retune &&
+                     tuning_cache_lookup(opt.tuning_cache, plan.hash, "format", plan.num_threads, entry) &&
+                     spmv_format_from_name(entry.kernel, plan.format);
+    if (plan.cache_hit) {
+        param1 = entry.param1;
+        param2 = entry.param2;
+    } else {
+        int winner = autotune_search(A.M, A.N, A.row_ptr, A.col_idx, A.values, plan.features,
+                                     plan.num_threads, opt.trial_iters, opt.expected_iters, plan.trials);
+        plan.format = plan.trials[winner].format;
+        param1 = plan.trials[winner].param1;
+        param2 = plan.trials[winner].param2;
+
+        entry.hash = plan.hash;
+        entry.key = "format";
+        entry.threads = plan.num_threads;
+        entry.kernel = spmv_format_name(plan.format);
+        entry.param1 = param1;
+        entry.param2 = param2;
+        entry.time_ms = plan.trials[winner].spmv_ms;
+        if (!tuning_cache_store(opt.tuning_cache, entry)) {
+            std::cerr << "Warning: unable to write tuning cache " << opt.tuning_cache << "\n";
+        }
+    }
+    plan.tune_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// prefetch distance from the tuning cache, or from trial runs (then stored)
+static void plan_prefetch_tune(const CsrMatrix& A, const SpmvOptions& opt, SpmvPlan& plan) {
+    auto start = std::chrono::steady_clock::now();
+    if (plan.hash == 0) plan.hash = matrix_hash(A.M, A.N, A.row_ptr, A.col_idx);
+
+    TuningEntry entry;
+    plan.prefetch_cache_hit = !opt.retune &&
+                              tuning_cache_lookup(opt.tuning_cache, plan.hash, "prefetch", plan.num_threads, entry);
+    if (plan.prefetch_cache_hit) {
+        plan.prefetch_distance = entry.param1;
+    } else {
+        plan.prefetch_distance = prefetch_autotune(A.M, A.N, A.row_ptr, A.col_idx, A.values, plan.isa,
+                                                   opt.trial_iters, plan.prefetch_trials);
+        entry.hash = plan.hash;
+        entry.key = "prefetch";
+        entry.threads = plan.num_threads;
+        entry.kernel = "csr_prefetch";
+        entry.param1 = plan.prefetch_distance;
+        entry.param2 = 0;
+        for (const PrefetchTrial& t : plan.prefetch_trials) {
+            if (t.distance == plan.prefetch_distance) entry.time_ms = t.spmv_ms;
+        }
+        if (!tuning_cache_store(opt.tuning_cache, entry)) {
+            std::cerr << "Warning: unable to write tuning cache " << opt.tuning_cache << "\n";
+        }
+    }
+    plan.tune_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// schedule of a previous sweep of this matrix (key "scaling"); sets the thread count
+// of the overall choice when none is given
+static void plan_schedule_lookup(const CsrMatrix& A, const SpmvOptions& opt, SpmvPlan& plan, int& num_threads) {
+    plan.hash = matrix_hash(A.M, A.N, A.row_ptr, A.col_idx);
+    int best_threads = 0;
+    plan.schedule_cache_hit = scaling_cache_lookup(opt.tuning_cache, plan.hash, opt.num_threads,
+                                                   plan.schedule, best_threads);
+    if (plan.schedule_cache_hit) {
+        plan.runtime_schedule = true;
+        num_threads = best_threads;
+    } else {
+        std::cerr << "Warning: no sweep of this matrix"
+                  << (opt.num_threads > 0 ? " at " + std::to_string(opt.num_threads) + " threads" : "")
+                  << " in " << opt.tuning_cache << " (run parallel_spmv_csr --sweep), using guided" << std::endl;
+    }
+}
+
+bool spmv_plan_create(const CsrMatrix& A, const SpmvOptions& opt, SpmvPlan& plan) {
+    spmv_plan_destroy(plan);
+    const bool plain_csr = !opt.autotune && opt.format == FORMAT_CSR && !opt.numa && opt.prefetch == 0 && !opt.panels;
+    if (opt.value_type != VALUE_DOUBLE && !plain_csr) {
+        std::cerr << "Reduced-precision values are a variant of the guided CSR kernel: they cannot be "
+                  << "combined with NUMA placement, prefetching, column panels, autotuning or another format"
+                  << std::endl;
+        return false;
+    }
+    if ((opt.runtime_schedule || opt.tuned_schedule) && (!plain_csr || opt.value_type != VALUE_DOUBLE)) {
+        std::cerr << "OpenMP schedules only apply to the plain double CSR kernel" << std::endl;
+        return false;
+    }
+    if (opt.numa && (opt.autotune || opt.format != FORMAT_CSR)) {
+        std::cerr << "NUMA placement uses its own static CSR partition: it cannot be combined "
+                  << "with another format or with autotuning" << std::endl;
+        return false;
+    }
+    if (opt.prefetch != 0 && (opt.numa || (!opt.autotune && opt.format != FORMAT_CSR))) {
+        std::cerr << "Software prefetching is a variant of the guided CSR kernel: it cannot be combined "
+                  << "with NUMA placement or another format" << std::endl;
+        return false;
+    }
+
+    if (opt.panels && (opt.numa || opt.autotune || opt.format != FORMAT_CSR || opt.prefetch != 0)) {
+        std::cerr << "Column panels are a CSR layout of their own: they cannot be combined with NUMA "
+                  << "placement, autotuning, another format or prefetching" << std::endl;
+        return false;
+    }
+
+    plan.A = A;
+    plan.numa = opt.numa;
+    plan.format = opt.format;
+    plan.streaming = axpby_streaming(opt.stores, A.M);
+    plan.isa = simd_resolve(opt.simd, A.M, A.nnz);
+    plan.value_type = opt.value_type;
+    plan.runtime_schedule = opt.runtime_schedule;
+    plan.schedule = opt.schedule;
+    int num_threads = opt.num_threads;
+    if (opt.tuned_schedule) {
+        plan_schedule_lookup(A, opt, plan, num_threads);
+    }
+    plan.num_threads = num_threads > 0 ? num_threads : omp_get_max_threads();
+    omp_set_num_threads(plan.num_threads);
+
+    // pin before anything is touched in parallel
+    numa_read_topology(plan.topo);
+    if (opt.numa || opt.affinity != AFFINITY_NONE) {
+        if (!pin_threads(plan.topo, opt.affinity, plan.num_threads, plan.thread_node)) {
+            std::cerr << "Warning: could not pin every thread (" << affinity_name(opt.affinity) << ")\n";
+        }
+    }
+
+    int param1 = opt.param1, param2 = opt.param2;
+    if (opt.autotune) {
+        plan_autotune(A, opt, plan, param1, param2);
+    }
+    if (opt.prefetch == SPMV_PREFETCH_AUTO && plan.format == FORMAT_CSR) {
+        plan_prefetch_tune(A, opt, plan);
+    } else if (opt.prefetch > 0 && plan.format == FORMAT_CSR) {
+        plan.prefetch_distance = opt.prefetch;
+    }
+
+    if (plan.numa) {
+        auto start = std::chrono::steady_clock::now();
+        numa_first_touch_csr(A.M, A.N, A.row_ptr, A.col_idx, A.values, plan.num_threads, plan.numa_A);
+        numa_first_touch_vector(plan.numa_A, A.N, nullptr, plan.numa_x);
+        numa_first_touch_vector(plan.numa_A, A.M, nullptr, plan.numa_y);
+        plan.setup_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    } else {
+        plan.setup_ms = dispatch_prepare(plan.dispatch, plan.format, param1, param2, plan.num_threads,
+                                         A.M, A.N, A.row_ptr, A.col_idx, A.values);
+        // a single panel is plain CSR: keep the CSR kernel
+        const int width = opt.panels ? panel_width_for_cache(A.N, opt.panel_budget) : A.N;
+        if (width < A.N) {
+            panel_csr_build(A.M, A.N, A.row_ptr, A.col_idx, A.values, width, plan.panel);
+            plan.setup_ms += plan.panel.build_ms;
+        }
+        if (plan.value_type != VALUE_DOUBLE) {
+            mixed_values_convert(plan.value_type, A.nnz, A.values, plan.mixed);
+            plan.setup_ms += plan.mixed.convert_ms;
+        }
+        if (plan.format != FORMAT_CSR || plan.value_type != VALUE_DOUBLE || plan.runtime_schedule) {
+            plan.scratch.resize(A.M);
+        }
+    }
+    if (opt.transpose) {
+        transpose_prepare(plan.transpose, opt.transpose_method, plan.num_threads, opt.expected_iters,
+                          A.M, A.N, A.row_ptr, A.col_idx, A.values);
+    }
+    return true;
+}
+
+void spmv_execute(SpmvPlan& plan, const double* x, double* y) {
+    spmv_execute_axpby(plan, 1.0, x, 0.0, y);
+}
+
+void spmv_execute_axpby(SpmvPlan& plan, double alpha, const double* x, double beta, double* y) {
+    if (plan.panel.num_panels > 1) {
+        spmv_panel_csr(plan.panel, alpha, x, beta, y);
+        return;
+    }
+    if (plan.value_type != VALUE_DOUBLE || plan.runtime_schedule) {
+        // y = A * x kernels: the update goes through the scratch vector
+        double* out = alpha == 1.0 && beta == 0.0 ? y : plan.scratch.data();
+        if (plan.runtime_schedule) {
+            spmv_csr_schedule(plan.schedule, plan.A.M, plan.A.row_ptr, plan.A.col_idx, plan.A.values, x, out);
+        } else {
+            spmv_csr_mixed(plan.mixed, plan.A.M, plan.A.row_ptr, plan.A.col_idx, x, out);
+        }
+        if (out != y) axpby_update(plan.A.M, alpha, out, beta, y);
+        return;
+    }
+    if (!plan.numa && plan.format == FORMAT_CSR && plan.prefetch_distance > 0) {
+        spmv_csr_prefetch(plan.A.M, plan.A.row_ptr, plan.A.col_idx, plan.A.values, alpha, x, beta, y,
+                          plan.prefetch_distance, plan.streaming);
+        return;
+    }
+    if (!plan.numa && plan.format == FORMAT_CSR) {
+        spmv_csr_simd(plan.isa, plan.A.M, plan.A.row_ptr, plan.A.col_idx, plan.A.values, alpha, x, beta, y,
+                      plan.streaming);
+        return;
+    }
+    if (!plan.numa) {
+        if (alpha == 1.0 && beta == 0.0) {
+            dispatch_spmv(plan.dispatch, x, y);
+        } else {
+            dispatch_spmv(plan.dispatch, x, plan.scratch.data());
+            axpby_update(plan.A.M, alpha, plan.scratch.data(), beta, y);
+        }
+        return;
+    }
+
+    double* px = plan.numa_x.data();
+    double* py = plan.numa_y.data();
+    if (x != px) {
+        #pragma omp parallel for schedule(static) num_threads(plan.num_threads)
+        for (int i = 0; i < plan.A.N; ++i) px[i] = x[i];
+    }
+    if (y != py && beta != 0.0) {
+        #pragma omp parallel for schedule(static) num_threads(plan.num_threads)
+        for (int i = 0; i < plan.A.M; ++i) py[i] = y[i];
+    }
+    spmv_csr_numa_axpby(plan.numa_A, alpha, px, beta, py, plan.streaming);
+    if (y != py) {
+        #pragma omp parallel for schedule(static) num_threads(plan.num_threads)
+        for (int i = 0; i < plan.A.M; ++i) y[i] = py[i];
+    }
+}
+
+void spmv_execute_transpose(SpmvPlan& plan, double alpha, const double* x, double beta, double* y) {
+    spmv_transpose(plan.transpose, alpha, x, beta, y);
+}
+
+void spmv_plan_destroy(SpmvPlan& plan) {
+    dispatch_release(plan.dispatch);
+    plan.numa_A = NumaCsr();
+    first_touch_vector<double>().swap(plan.numa_x);
+    first_touch_vector<double>().swap(plan.numa_y);
+    std::vector<TrialResult>().swap(plan.trials);
+    std::vector<PrefetchTrial>().swap(plan.prefetch_trials);
+    panel_csr_release(plan.panel);
+    std::vector<double>().swap(plan.scratch);
+    transpose_release(plan.transpose);
+    plan.thread_node.clear();
+    plan.tuned = false;
+    plan.cache_hit = false;
+    plan.prefetch_cache_hit = false;
+    plan.prefetch_distance = 0;
+    plan.value_type = VALUE_DOUBLE;
+    plan.mixed = MixedValues();
+    plan.runtime_schedule = false;
+    plan.schedule = ScheduleChoice();
+    plan.schedule_cache_hit = false;
+    plan.hash = 0;
+    plan.tune_ms = 0.0;
+    plan.setup_ms = 0.0;
+}
+
+std::string spmv_plan_describe(const SpmvPlan& plan) {
+    if (plan.numa) {
+        return "csr (static nnz-balanced, NUMA first touch)";
+    }
+    std::string s = spmv_format_name(plan.format);
+    if (plan.panel.num_panels > 1) {
+        s += " (" + std::to_string(plan.panel.num_panels) + " column panels of " + std::to_string(plan.panel.width) + ")";
+    } else if (plan.runtime_schedule) {
+        s += " (schedule " + schedule_describe(plan.schedule) + (plan.schedule_cache_hit ? ", tuned)" : ")");
+    } else if (plan.value_type != VALUE_DOUBLE) {
+        s += std::string(" (") + value_type_name(plan.value_type) + " values)";
+    } else if (plan.format == FORMAT_CSR && plan.prefetch_distance > 0) {
+        s += " (prefetch distance " + std::to_string(plan.prefetch_distance) + ")";
+    } else if (plan.format == FORMAT_CSR) {
+        s += std::string(" (") + simd_isa_name(plan.isa) + " kernel)";
+    } else if (plan.format == FORMAT_CSR_MERGE && plan.dispatch.merge_plan.num_parts == 1) {
+        s += " (single part, plain CSR loop)";
+    } else if (plan.format == FORMAT_SELL) {
+        s += " (C = " + std::to_string(plan.dispatch.param1) + ", sigma = " + std::to_string(plan.dispatch.param2) + ")";
+    } else if (plan.format == FORMAT_BCSR) {
+        s += " (" + std::to_string(plan.dispatch.param1) + "x" + std::to_string(plan.dispatch.param2) + " blocks)";
+    }
+    return s;
+}
+
+std::string spmv_plan_tag(const SpmvPlan& plan) {
+    if (plan.runtime_schedule) {
+        return "csr/" + schedule_describe(plan.schedule);
+    }
+    if (plan.value_type != VALUE_DOUBLE) {
+        return std::string("csr_") + value_type_name(plan.value_type);
+    }
+    std::string tag = spmv_format_name(plan.format);
+    if (plan.numa) {
+        tag += "/numa";
+    } else if (plan.panel.num_panels > 1) {
+        tag += "/panels" + std::to_string(plan.panel.num_panels);
+    } else if (plan.prefetch_distance > 0) {
+        tag += "/prefetch" + std::to_string(plan.prefetch_distance);
+    } else if (plan.format == FORMAT_CSR) {
+        tag += std::string("/") + simd_isa_name(plan.isa);
+    }
+    return tag;
+}
+
+void spmv_print_numa_nodes(SpmvPlan& plan, double alpha, double beta, double y_bytes) {
+    // per-socket bandwidth: bytes streamed by the threads of a node over
+    // the slowest of them
+    std::vector<double> thread_ms(plan.numa_A.num_parts, 0.0);
+    const NumaCsr& numa_A = plan.numa_A;
+    spmv_csr_numa_axpby(numa_A, alpha, plan.numa_x.data(), beta, plan.numa_y.data(), plan.streaming, &thread_ms);
+    std::cout << "\n" << std::setw(6) << "Node" << std::setw(9) << "Threads"
+              << std::setw(12) << "Rows" << std::setw(14) << "nnz"
+              << std::setw(11) << "Time (ms)" << std::setw(10) << "GB/s" << "\n";
+    for (int node = 0; node < plan.topo.num_nodes; ++node) {
+        int threads = 0;
+        long long rows = 0, node_nz = 0;
+        double node_ms = 0.0;
+        for (int t = 0; t < numa_A.num_parts; ++t) {
+            const int t_node = t < static_cast<int>(plan.thread_node.size()) ? plan.thread_node[t] : 0;
+            if (t_node != node) continue;
+            threads++;
+            rows += numa_A.row_start[t + 1] - numa_A.row_start[t];
+            node_nz += numa_A.row_ptr[numa_A.row_start[t + 1]] - numa_A.row_ptr[numa_A.row_start[t]];
+            node_ms = std::max(node_ms, thread_ms[t]);
+        }
+        if (threads == 0) continue;
+        const double node_bytes = (8.0 + 4.0) * node_nz + y_bytes * rows;
+        std::cout << std::setw(6) << node << std::setw(9) << threads
+                  << std::setw(12) << rows << std::setw(14) << node_nz
+                  << std::setw(11) << std::fixed << std::setprecision(3) << node_ms
+                  << std::setw(10) << std::setprecision(2)
+                  << (node_ms > 0.0 ? node_bytes / (node_ms / 1000.0) / 1e9 : 0.0) << "\n";
+    }
+}
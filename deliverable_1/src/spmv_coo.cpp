@@ -1,23 +1,21 @@
 #include <iostream>
 #include <random>
 #include <vector>
-#include <chrono>
-#include <fstream>
+#include <algorithm>
 
 #define BLOCK_SIZE 64
-#define WARMUP_ITERS 3
-#define BENCHMARK_ITERS 10
 
-extern "C" {
-#include "../include/mmio.h"
-}
+#include "../include/matrix_io.hpp"
+#include "../include/csr_bin.hpp"
+#include "../include/bench.hpp"
+#include "../include/roofline.hpp"
 
 int main(int argc, char* argv[]) {
     bool verbose = false;
     std::string matrix_filename;
     // validate command-line arguments and print usage if incorrect
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " matrix_file.mtx" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " matrix_file.mtx|matrix_file.csrb" << std::endl;
         return 1;
     }
 
@@ -34,52 +32,44 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
-    // reads .mtx file passed as argument
-    FILE* f = fopen(matrix_filename.c_str(), "r");
-    if (f == nullptr) {
-        std::cerr << "Could not open file: " << matrix_filename << std::endl;
-        return 1;
-    }
-
-    MM_typecode matcode;
-    if (mm_read_banner(f, &matcode) != 0) {
-        std::cerr << "Could not process Matrix Market banner." << std::endl;
-        fclose(f);
-        return 1;
-    }
-
-    // check matrix type: must be real, sparse matrix
-    if (!mm_is_matrix(matcode) || !mm_is_sparse(matcode) || mm_is_complex(matcode)) {
-        std::cerr << "Only real-valued sparse matrices supported." << std::endl;
-        fclose(f);
-        return 1;
-    }
-
+    // reads .mtx file passed as argument (symmetric files are expanded)
     int M, N, nz;
-    if (mm_read_mtx_crd_size(f, &M, &N, &nz) != 0) {
-        std::cerr << "Could not read matrix size." << std::endl;
-        fclose(f);
-        return 1;
-    }
-
-    // creates row_index, col_index, and values vectors
-    std::vector<int> row_idx(nz);
-    std::vector<int> col_idx(nz);
-    std::vector<double> values(nz);
-
-    for (int i = 0; i < nz; ++i) {
-        int r, c;
-        double val;
-        if (fscanf(f, "%d %d %lf", &r, &c, &val) != 3) {
-            std::cerr << "Error reading matrix entry." << std::endl;
-            fclose(f);
+    std::vector<int> row_store, col_store;
+    std::vector<double> val_store;
+    const int* row_idx;
+    const int* col_idx;
+    const double* values;
+    MtxLoadStats load;
+    LoadedCsr A;
+    if (csr_bin_is_file(matrix_filename)) {
+        // .csrb: columns and values are used in place, only the row of every
+        // entry has to be expanded from row_ptr
+        if (!load_csr(matrix_filename, A, &load)) {
             return 1;
         }
-        row_idx[i] = r - 1; // convert 1-based to 0-based
-        col_idx[i] = c - 1;
-        values[i] = val;
+        M = A.M;
+        N = A.N;
+        nz = A.nnz;
+        row_store.resize(nz);
+        for (int r = 0; r < M; ++r) {
+            std::fill(row_store.begin() + A.row_ptr[r], row_store.begin() + A.row_ptr[r + 1], r);
+        }
+        col_idx = A.col_idx;
+        values = A.values;
+    } else {
+        if (!read_matrix_market_coo(matrix_filename, M, N, nz, row_store, col_store, val_store, nullptr, &load)) {
+            return 1;
+        }
+        col_idx = col_store.data();
+        values = val_store.data();
+    }
+    row_idx = row_store.data();
+    if (verbose && A.mapped) {
+        std::cout << "Mapped " << matrix_filename << " in " << load.total_ms << " ms (zero copy)" << std::endl;
+    } else if (verbose) {
+        std::cout << "Loaded " << matrix_filename << " in " << load.total_ms << " ms (parse "
+                  << load.parse_mb_per_s() << " MB/s on " << load.threads << " threads)" << std::endl;
     }
-    fclose(f);
 
     // generate random monodimensional array
     std::vector<double> x(N), y(M, 0.0);
@@ -90,54 +80,37 @@ int main(int argc, char* argv[]) {
         x[i] = dis(gen);
     }
 
-    // this will clear the file content
-    std::ofstream ofs("../benchmarks/COO_exec_times.txt", std::ofstream::out | std::ofstream::trunc);
-    ofs.close();
-    
-    // writes execution times to file
-    std::ofstream outfile("../benchmarks/COO_exec_times.txt", std::ios_base::app);
-    if (!outfile.is_open()) {
-        std::cerr << "Warning: unable to open exec_time file for writing \n";
-        exit(1);
-    }
-    
-    // 3 warm-up runs
-    if (verbose) {
-        std::cout << "Running 3 warm-up iterations for COO SpMV... \n";
-    }
-    for (int warmup = 0; warmup < WARMUP_ITERS; ++warmup) {
-        std::fill(y.begin(), y.end(), 0.0); // Reset y
+    // one sequential COO SpMV (y is reset untimed before every run)
+    auto reset_y = [&]() { std::fill(y.begin(), y.end(), 0.0); };
+    auto run_spmv = [&]() {
         for (int block_start = 0; block_start < nz; block_start += BLOCK_SIZE) {
             int block_end = std::min(block_start + BLOCK_SIZE, nz);
-            #pragma omp simd
+            // no simd here: consecutive entries of the same row update the same
+            // y element, so a vectorised scatter would lose contributions
             for (int k = block_start; k < block_end; ++k) {
                 y[row_idx[k]] += values[k] * x[col_idx[k]];
             }
         }
+    };
+
+    // warm-up runs until the times are stable
+    BenchConfig bench_cfg = bench_config_from_env(verbose);
+    BenchStats stats;
+    stats.warmup_iters = bench_warmup(bench_cfg, run_spmv, reset_y);
+    if (verbose) {
+        std::cout << "Ran " << stats.warmup_iters << " warm-up iterations for COO SpMV\n";
     }
-    
-    // 10 runs of SpMV multiplication
-    for (int i = 0; i < BENCHMARK_ITERS; ++i) {
-        std::fill(y.begin(), y.end(), 0.0); // reset result vector
-        auto start = std::chrono::high_resolution_clock::now();
-    
-        for (int block_start = 0; block_start < nz; block_start += BLOCK_SIZE) {
-            int block_end = std::min(block_start + BLOCK_SIZE, nz);
-            #pragma omp simd
-            for (int k = block_start; k < block_end; ++k) {
-                y[row_idx[k]] += values[k] * x[col_idx[k]];
-            }
-        }
-    
-        auto end = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double, std::milli> elapsed = end - start;
-    
-        if (verbose) {
-            std::cout << "Multiplication took " << elapsed.count() << " ms" << std::endl;
-        }
-        outfile << elapsed.count() << "\n";
+
+    bench_sample(bench_cfg, run_spmv, stats, reset_y);
+    bench_record(bench_cfg, "spmv_coo", matrix_filename, "coo/sequential", 1, stats);
+    if (verbose) {
+        std::cout << "COO SpMV: " << bench_summary(stats) << "\n";
+        // percentage of the single-thread roofline: 8B value + 2 x 4B index per
+        // nonzero (y accumulated in cache), y written once per row
+        RooflineCalib roof;
+        roofline_cache_lookup(ROOFLINE_DEFAULT_CACHE, 1, roof);
+        roofline_print(roof, 1, 2.0 * nz / (stats.min_ms / 1000.0) / 1e9, 2.0 * nz / (16.0 * nz + 8.0 * M));
     }
-    outfile.close();
     
     return 0;
 }
@@ -1,24 +1,21 @@
 #include <iostream>
 #include <vector>
-#include <chrono>
 #include <cstdio>
-#include <fstream>
 #include <random>
 
 #define BLOCK_SIZE 64
-#define WARMUP_ITERS 3
-#define BENCHMARK_ITERS 10
 
-extern "C" {
-#include "../include/mmio.h"
-}
+#include "../include/matrix_io.hpp"
+#include "../include/csr_bin.hpp"
+#include "../include/bench.hpp"
+#include "../include/roofline.hpp"
 
 int main(int argc, char* argv[]) {
     bool verbose = false;
     std::string matrix_filename;
     // validate command-line arguments and print usage if incorrect
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " matrix_file.mtx" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " matrix_file.mtx|matrix_file.csrb" << std::endl;
         return 1;
     }
     
@@ -33,74 +30,24 @@ int main(int argc, char* argv[]) {
         std::cerr << "No matrix file specified." << std::endl;
         return 1;
     }
-    // reads mtx file passed as argument
-    FILE* f = fopen(matrix_filename.c_str(), "r");
-    if (f == nullptr) {
-        std::cerr << "Could not open file: " << matrix_filename << std::endl;
-        return 1;
-    }
-
-    MM_typecode matcode;
-    if (mm_read_banner(f, &matcode) != 0) {
-        std::cerr << "Could not process Matrix Market banner." << std::endl;
-        fclose(f);
+    // reads mtx file passed as argument and converts it to CSR
+    // (symmetric files are expanded to the full matrix); .csrb files are mapped
+    LoadedCsr A;
+    MtxLoadStats load;
+    if (!load_csr(matrix_filename, A, &load)) {
         return 1;
     }
-
-    // check matrix type: must be real, sparse matrix
-    if (!mm_is_matrix(matcode) || !mm_is_sparse(matcode) || mm_is_complex(matcode)) {
-        std::cerr << "Only real-valued sparse matrices supported." << std::endl;
-        fclose(f);
-        return 1;
-    }
-
-    int M, N, nz;
-    if (mm_read_mtx_crd_size(f, &M, &N, &nz) != 0) {
-        std::cerr << "Could not read matrix size." << std::endl;
-        fclose(f);
-        return 1;
-    }
-
-    // creates coo row_index, col_index, and values vector
-    std::vector<int> row_coo(nz), col_coo(nz);
-    std::vector<double> val_coo(nz);
-    for (int i = 0; i < nz; ++i) {
-        int r, c;
-        double v;
-        if (fscanf(f, "%d %d %lf", &r, &c, &v) != 3) {
-            std::cerr << "Error reading matrix entry." << std::endl;
-            fclose(f);
-            return 1;
-        }
-        // Convert to 0-based indexing
-        row_coo[i] = r - 1;
-        col_coo[i] = c - 1;
-        val_coo[i] = v;
-    }
-    fclose(f);
-
-    // COO to CSR conversion
-    std::vector<int> row_ptr(M + 1, 0);
-    std::vector<int> col_idx(nz);
-    std::vector<double> values(nz);
-
-    // count nonzeros per row
-    for (int i = 0; i < nz; ++i)
-        row_ptr[row_coo[i] + 1]++;
-
-    // prefix sum for row_ptr
-    for (int i = 0; i < M; ++i)
-        row_ptr[i + 1] += row_ptr[i];
-
-    // insert values and columns in correct position
-    std::vector<int> fill(M, 0);
-    for (int i = 0; i < M; ++i) fill[i] = row_ptr[i];
-    for (int i = 0; i < nz; ++i) {
-        int r = row_coo[i];
-        int dest = fill[r]++;
-        col_idx[dest] = col_coo[i];
-        values[dest] = val_coo[i];
+    if (verbose && A.mapped) {
+        std::cout << "Mapped " << matrix_filename << " in " << load.total_ms << " ms (zero copy)" << std::endl;
+    } else if (verbose) {
+        std::cout << "Loaded " << matrix_filename << " in " << load.total_ms << " ms (parse "
+                  << load.parse_mb_per_s() << " MB/s on " << load.threads << " threads, CSR conversion "
+                  << load.convert_ms << " ms)" << std::endl;
     }
+    const int M = A.M, N = A.N;
+    const int* row_ptr = A.row_ptr;
+    const int* col_idx = A.col_idx;
+    const double* values = A.values;
 
     // generate random monodimensional array
     std::vector<double> x(N), y(M, 0.0);
@@ -111,39 +58,8 @@ int main(int argc, char* argv[]) {
         x[i] = dis(gen);
     }
 
-    // this will clear the file content
-    std::ofstream ofs("../benchmarks/CSR_exec_times.txt", std::ofstream::out | std::ofstream::trunc);
-    ofs.close();
-    
-    
-    // writes execution times to file
-    std::ofstream outfile("../benchmarks/CSR_exec_times.txt", std::ios_base::app);
-    if (!outfile.is_open()) {
-        std::cerr << "Warning: unable to open exec_time file for writing \n";
-    }
-    
-    // 3 warm up runs
-    if (verbose) {
-        std::cout << "Running 3 warm-up iterations for CSR SpMV...\n";
-    }
-    for (int warmup = 0; warmup < WARMUP_ITERS; ++warmup) {
-        std::fill(y.begin(), y.end(), 0.0); // Reset y
-        for (int j = 0; j < M; j += BLOCK_SIZE) {
-            int j_end = std::min(j + BLOCK_SIZE, M);
-            #pragma omp simd
-            for (int r = j; r < j_end; ++r) {
-                double sum = 0.0;
-                for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
-                    sum += values[k] * x[col_idx[k]];
-                }
-                y[r] = sum;
-            }
-        }
-    }
-    
-    for (int i = 0; i < BENCHMARK_ITERS; ++i) {
-        std::fill(y.begin(), y.end(), 0.0); // Reset y
-        auto start = std::chrono::steady_clock::now();
+    // one sequential CSR SpMV
+    auto run_spmv = [&]() {
         for (int j = 0; j < M; j += BLOCK_SIZE) {
             int j_end = std::min(j + BLOCK_SIZE, M);
             #pragma omp simd
@@ -156,18 +72,25 @@ int main(int argc, char* argv[]) {
                 y[r] = sum;
             }
         }
-        // ending measurment
-        auto end = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration<double, std::milli>(end - start);
-        
-        if (verbose) {
-            std::cout << "Multiplication took " << elapsed.count() << " ms" << std::endl;
-        }
-        
-        outfile << elapsed.count() << "\n";
+    };
+
+    // warm-up runs until the times are stable
+    BenchConfig bench_cfg = bench_config_from_env(verbose);
+    BenchStats stats;
+    stats.warmup_iters = bench_warmup(bench_cfg, run_spmv);
+    if (verbose) {
+        std::cout << "Ran " << stats.warmup_iters << " warm-up iterations for CSR SpMV\n";
     }
 
-    outfile.close();
+    bench_sample(bench_cfg, run_spmv, stats);
+    bench_record(bench_cfg, "spmv_csr", matrix_filename, "csr/sequential", 1, stats);
+    if (verbose) {
+        std::cout << "CSR SpMV: " << bench_summary(stats) << "\n";
+        // percentage of the single-thread roofline
+        RooflineCalib roof;
+        roofline_cache_lookup(ROOFLINE_DEFAULT_CACHE, 1, roof);
+        roofline_print(roof, 1, 2.0 * A.nnz / (stats.min_ms / 1000.0) / 1e9, 2.0 * A.nnz / csr_spmv_bytes(A.nnz, M));
+    }
 
     return 0;
 }
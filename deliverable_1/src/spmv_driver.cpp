@@ -0,0 +1,412 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <sstream>
+#include <random>
+#include <omp.h>
+#include <algorithm>
+#include <iomanip>
+#include <glob.h>
+
+#include "../include/spmv.hpp"
+#include "../include/bench.hpp"
+#include "../include/roofline.hpp"
+
+#define NUM_THREADS 16
+#define DRIVER_DEFAULT_GLOB "../data/*/*.mtx"
+
+extern "C" {
+#include <valgrind/callgrind.h>
+}
+
+/*
+ * One driver for every kernel of libspmv: each matrix is loaded once, then
+ * every selected kernel runs at every requested thread count through the
+ * plan API, and the runs end up in a single table (and in the result
+ * records, bench "spmv_driver").
+*/
+
+// a registered kernel: the plan options that select it
+struct DriverKernel {
+    const char* name;           // --kernels name and kernel column of the records
+    SpmvFormat format;
+    SimdIsa simd;
+    int prefetch;
+    bool panels;
+    bool numa;
+    bool autotune;
+};
+
+static const DriverKernel driver_kernels[] = {
+    {"coo",          FORMAT_COO,       SIMD_AUTO,    0,                  false, false, false},
+    {"csr",          FORMAT_CSR,       SIMD_AUTO,    0,                  false, false, false},
+    {"csr-scalar",   FORMAT_CSR,       SIMD_SCALAR,  0,                  false, false, false},
+    {"csr-avx2",     FORMAT_CSR,       SIMD_AVX2,    0,                  false, false, false},
+    {"csr-avx512",   FORMAT_CSR,       SIMD_AVX512,  0,                  false, false, false},
+    {"csr-prefetch", FORMAT_CSR,       SIMD_AUTO,    SPMV_PREFETCH_AUTO, false, false, false},
+    {"csr-panels",   FORMAT_CSR,       SIMD_AUTO,    0,                  true,  false, false},
+    {"csr-numa",     FORMAT_CSR,       SIMD_AUTO,    0,                  false, true,  false},
+    {"csr-merge",    FORMAT_CSR_MERGE, SIMD_AUTO,    0,                  false, false, false},
+    {"sell",         FORMAT_SELL,      SIMD_AUTO,    0,                  false, false, false},
+    {"bcsr",         FORMAT_BCSR,      SIMD_AUTO,    0,                  false, false, false},
+    {"autotune",     FORMAT_CSR,       SIMD_AUTO,    0,                  false, false, true},
+};
+static const int num_driver_kernels = sizeof(driver_kernels) / sizeof(driver_kernels[0]);
+
+// one row of the consolidated table
+struct DriverRun {
+    std::string matrix;
+    int M, N, nnz;
+    std::string kernel;
+    std::string plan;           // spmv_plan_describe(), or why the run was skipped
+    int threads;
+    bool ok;
+    double setup_ms;
+    double min_ms;
+    double median_ms;
+    double rel_err;
+};
+
+static bool split_list(const std::string& text, std::vector<std::string>& items) {
+    items.clear();
+    std::stringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return !items.empty();
+}
+
+// one path per line, blank lines and # comments ignored
+static bool read_matrix_list(const std::string& path, std::vector<std::string>& files) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cerr << "Unable to open matrix list " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        const size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#') continue;
+        const size_t end = line.find_last_not_of(" \t\r");
+        files.push_back(line.substr(begin, end - begin + 1));
+    }
+    return true;
+}
+
+// sorted matches of a shell pattern; a pattern that matches nothing is not an error
+static void glob_matrices(const std::string& pattern, std::vector<std::string>& files) {
+    glob_t g;
+    if (glob(pattern.c_str(), 0, nullptr, &g) == 0) {
+        for (size_t i = 0; i < g.gl_pathc; ++i) files.push_back(g.gl_pathv[i]);
+    }
+    globfree(&g);
+}
+
+// "../data/1138_bus/1138_bus.mtx" -> "1138_bus"
+static std::string matrix_label(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return dot == std::string::npos || dot == 0 ? name : name.substr(0, dot);
+}
+
+int main(int argc, char* argv[]) {
+    bool verbose = false;
+    bool sources_given = false;         // a --list or --glob, even if it yields nothing
+    std::vector<std::string> matrix_files;
+    std::vector<std::string> kernel_names;
+    std::vector<int> thread_list;
+    // validate command-line arguments and print usage if incorrect
+    if (argc > 1 && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h")) {
+        std::cerr << "Usage: " << argv[0] << " [--kernels all|name,...] [--threads 1,2,4] [--list matrices.txt] "
+                  << "[--glob '" << DRIVER_DEFAULT_GLOB << "'] [--verbose] [matrix_file ...]\n"
+                  << "Kernels:";
+        for (int k = 0; k < num_driver_kernels; ++k) std::cerr << " " << driver_kernels[k].name;
+        std::cerr << "\nWithout matrices, runs every file matching " << DRIVER_DEFAULT_GLOB << std::endl;
+        return 1;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--verbose" || arg == "-v") {
+            verbose = true;
+        } else if (arg == "--kernels" || arg == "-k") {
+            if (!split_list((i + 1 < argc) ? argv[++i] : "", kernel_names)) {
+                std::cerr << "--kernels needs 'all' or a comma separated list of kernel names" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--threads" || arg == "-t") {
+            std::vector<std::string> items;
+            split_list((i + 1 < argc) ? argv[++i] : "", items);
+            thread_list.clear();
+            for (size_t t = 0; t < items.size(); ++t) {
+                int threads = std::atoi(items[t].c_str());
+                if (threads <= 0) {
+                    thread_list.clear();
+                    break;
+                }
+                thread_list.push_back(threads);
+            }
+            if (thread_list.empty()) {
+                std::cerr << "--threads needs a comma separated list of positive integers" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--list") {
+            sources_given = true;
+            if (i + 1 >= argc || !read_matrix_list(argv[++i], matrix_files)) {
+                std::cerr << "--list needs a file with one matrix path per line" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--glob") {
+            if (i + 1 >= argc) {
+                std::cerr << "--glob needs a pattern, e.g. '" << DRIVER_DEFAULT_GLOB << "'" << std::endl;
+                return 1;
+            }
+            sources_given = true;
+            glob_matrices(argv[++i], matrix_files);
+        } else {
+            matrix_files.push_back(arg);
+        }
+    }
+    if (matrix_files.empty() && !sources_given) {
+        glob_matrices(DRIVER_DEFAULT_GLOB, matrix_files);
+    }
+    // check if no matrix file is found
+    if (matrix_files.empty()) {
+        std::cerr << "No matrix file specified (or matched)." << std::endl;
+        return 1;
+    }
+
+    // ================= Kernels =================
+    std::vector<int> selected;
+    if (kernel_names.empty() || (kernel_names.size() == 1 && kernel_names[0] == "all")) {
+        for (int k = 0; k < num_driver_kernels; ++k) selected.push_back(k);
+    } else {
+        for (size_t n = 0; n < kernel_names.size(); ++n) {
+            int found = -1;
+            for (int k = 0; k < num_driver_kernels; ++k) {
+                if (kernel_names[n] == driver_kernels[k].name) found = k;
+            }
+            if (found < 0) {
+                std::cerr << "Unknown kernel " << kernel_names[n] << " (run " << argv[0] << " --help for the list)" << std::endl;
+                return 1;
+            }
+            selected.push_back(found);
+        }
+    }
+
+    // ================= SET THREAD COUNT =================
+    if (thread_list.empty()) {
+        int num_threads = NUM_THREADS;
+        if (getenv("OMP_NUM_THREADS") != nullptr) {
+            num_threads = atoi(getenv("OMP_NUM_THREADS"));
+        }
+        thread_list.push_back(num_threads);
+    }
+    if (verbose) {
+        std::cout << "Matrices: " << matrix_files.size() << ", kernels: " << selected.size()
+                  << ", thread counts: " << thread_list.size() << "\n";
+    }
+
+    BenchConfig bench_cfg = bench_config_from_env(verbose);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<double> dis(0.0, 1.0);
+
+    std::vector<DriverRun> runs;
+    for (size_t f = 0; f < matrix_files.size(); ++f) {
+        const std::string& matrix_filename = matrix_files[f];
+
+        // loaded once, shared by every kernel and thread count
+        LoadedCsr loaded;
+        MtxLoadStats load_stats;
+        if (!load_csr(matrix_filename, loaded, &load_stats)) {
+            std::cerr << "Skipping " << matrix_filename << std::endl;
+            continue;
+        }
+        const CsrMatrix A = csr_matrix_view(loaded);
+        if (verbose) {
+            std::cout << "Loaded " << matrix_filename << " (" << A.M << " x " << A.N << ", nnz = " << A.nnz
+                      << ") in " << std::fixed << std::setprecision(3) << load_stats.total_ms << " ms\n";
+        }
+
+        // generate random monodimensional array
+        std::vector<double> x(A.N), y(A.M, 0.0), y_ref(A.M, 0.0);
+        for (int i = 0; i < A.N; ++i) {
+            x[i] = dis(gen);
+        }
+
+        // serial reference
+        for (int r = 0; r < A.M; ++r) {
+            double sum = 0.0;
+            for (int k = A.row_ptr[r]; k < A.row_ptr[r + 1]; ++k) {
+                sum += A.values[k] * x[A.col_idx[k]];
+            }
+            y_ref[r] = sum;
+        }
+
+        for (size_t t = 0; t < thread_list.size(); ++t) {
+            for (size_t s = 0; s < selected.size(); ++s) {
+                const DriverKernel& kernel = driver_kernels[selected[s]];
+                DriverRun run;
+                run.matrix = matrix_label(matrix_filename);
+                run.M = A.M;
+                run.N = A.N;
+                run.nnz = A.nnz;
+                run.kernel = kernel.name;
+                run.threads = thread_list[t];
+                run.ok = false;
+                run.setup_ms = run.min_ms = run.median_ms = run.rel_err = 0.0;
+
+                if (kernel.simd != SIMD_AUTO && !simd_supported(kernel.simd)) {
+                    run.plan = std::string("skipped: no ") + simd_isa_name(kernel.simd) + " on this CPU";
+                    runs.push_back(run);
+                    continue;
+                }
+
+                SpmvOptions opt;
+                opt.format = kernel.format;
+                opt.simd = kernel.simd;
+                opt.prefetch = kernel.prefetch;
+                opt.panels = kernel.panels;
+                opt.numa = kernel.numa;
+                opt.autotune = kernel.autotune;
+                opt.num_threads = thread_list[t];
+
+                SpmvPlan plan;
+                auto setup_start = std::chrono::steady_clock::now();
+                if (!spmv_plan_create(A, opt, plan)) {
+                    run.plan = "skipped: plan creation failed";
+                    runs.push_back(run);
+                    continue;
+                }
+                auto setup_end = std::chrono::steady_clock::now();
+                run.setup_ms = std::chrono::duration<double, std::milli>(setup_end - setup_start).count();
+                run.plan = spmv_plan_describe(plan);
+
+                // NUMA plans run on their first-touched x and y: foreign buffers cost a copy per call
+                const double* plan_x = x.data();
+                double* plan_y = y.data();
+                if (plan.numa) {
+                    std::copy(x.begin(), x.end(), plan.numa_x.begin());
+                    plan_x = plan.numa_x.data();
+                    plan_y = plan.numa_y.data();
+                }
+                auto run_spmv = [&]() { spmv_execute(plan, plan_x, plan_y); };
+
+                // ================= Warm-up (until the times are stable, not timed) =================
+                BenchStats stats;
+                stats.warmup_iters = bench_warmup(bench_cfg, run_spmv);
+                if (verbose) {
+                    std::cout << "Ran " << stats.warmup_iters << " warm-up iterations for " << kernel.name
+                              << " on " << run.matrix << " (" << run.threads << " threads)" << std::endl;
+                }
+
+                // toggles callgrind (set to false) collection here
+                CALLGRIND_TOGGLE_COLLECT;
+
+                bench_sample(bench_cfg, run_spmv, stats);
+
+                // toggles callgrind collect (set to true) here
+                CALLGRIND_TOGGLE_COLLECT;
+
+                double max_err = 0.0, max_ref = 0.0;
+                for (int r = 0; r < A.M; ++r) {
+                    max_err = std::max(max_err, std::fabs(plan_y[r] - y_ref[r]));
+                    max_ref = std::max(max_ref, std::fabs(y_ref[r]));
+                }
+                run.ok = true;
+                run.min_ms = stats.min_ms;
+                run.median_ms = stats.median_ms;
+                run.rel_err = max_ref > 0.0 ? max_err / max_ref : max_err;
+                bench_record(bench_cfg, "spmv_driver", matrix_filename, kernel.name, run.threads, stats);
+                runs.push_back(run);
+
+                spmv_plan_destroy(plan);
+            }
+        }
+    }
+    if (runs.empty()) {
+        std::cerr << "No matrix could be loaded." << std::endl;
+        return 1;
+    }
+
+    // ================= Results =================
+    // every run against the CSR traffic model of the other reports (csr_spmv_bytes()), so
+    // the columns compare formats on the work they do, not on their own bytes
+    std::cout << "\n=== SpMV Driver Benchmark Results ===\n";
+    std::cout << "Matrices           : " << matrix_files.size() << "\n";
+    std::cout << "Kernels            : " << selected.size() << "\n";
+    std::cout << "Thread counts      :";
+    for (size_t t = 0; t < thread_list.size(); ++t) std::cout << " " << thread_list[t];
+    std::cout << "\n\n";
+    std::cout << std::left << std::setw(16) << "Matrix" << std::right << std::setw(11) << "nnz"
+              << "  " << std::left << std::setw(14) << "Kernel" << std::right << std::setw(8) << "Threads"
+              << std::setw(12) << "Setup (ms)" << std::setw(12) << "Best (ms)" << std::setw(13) << "Median (ms)"
+              << std::setw(10) << "GFLOPS" << std::setw(10) << "GB/s" << std::setw(8) << "% roof"
+              << std::setw(12) << "Rel. error" << "  Plan\n";
+
+    // percentage of the triad roofline, one calibration per thread count
+    std::vector<RooflineCalib> roofs(thread_list.size());
+    bool all_calibrated = true;
+    for (size_t t = 0; t < thread_list.size(); ++t) {
+        all_calibrated &= roofline_cache_lookup(ROOFLINE_DEFAULT_CACHE, thread_list[t], roofs[t]);
+    }
+    for (size_t i = 0; i < runs.size(); ++i) {
+        const DriverRun& run = runs[i];
+        std::cout << std::left << std::setw(16) << run.matrix << std::right << std::setw(11) << run.nnz
+                  << "  " << std::left << std::setw(14) << run.kernel << std::right << std::setw(8) << run.threads;
+        if (!run.ok) {
+            std::cout << std::setw(12) << "-" << std::setw(12) << "-" << std::setw(13) << "-" << std::setw(10) << "-"
+                      << std::setw(10) << "-" << std::setw(8) << "-" << std::setw(12) << "-" << "  " << run.plan << "\n";
+            continue;
+        }
+        double best_time_s = run.min_ms / 1000.0;
+        long long flops_per_spmv = 2LL * run.nnz;
+        double bytes_per_spmv = csr_spmv_bytes(run.nnz, run.M);
+        double gflops = flops_per_spmv / best_time_s / 1e9;
+
+        std::cout << std::setw(12) << std::fixed << std::setprecision(3) << run.setup_ms
+                  << std::setw(12) << std::setprecision(3) << run.min_ms
+                  << std::setw(13) << std::setprecision(3) << run.median_ms
+                  << std::setw(10) << std::setprecision(2) << gflops
+                  << std::setw(10) << std::setprecision(2) << bytes_per_spmv / best_time_s / 1e9;
+        size_t t = std::find(thread_list.begin(), thread_list.end(), run.threads) - thread_list.begin();
+        const double roof_pct = roofline_percent(roofs[t], gflops, flops_per_spmv / bytes_per_spmv);
+        if (roof_pct < 0.0) {
+            std::cout << std::setw(8) << "-";
+        } else {
+            std::cout << std::setw(8) << std::setprecision(1) << roof_pct;
+        }
+        std::cout << std::setw(12) << std::scientific << std::setprecision(2) << run.rel_err
+                  << "  " << run.plan << "\n";
+    }
+    if (!all_calibrated) {
+        std::cout << "(% roof: some thread counts are not calibrated, run parallel_spmv_csr --calibrate)\n";
+    }
+
+    // fastest kernel of every matrix and thread count
+    std::cout << "\nBest kernel per matrix and thread count:\n";
+    for (size_t i = 0; i < runs.size(); ++i) {
+        if (!runs[i].ok) continue;
+        bool best = true;
+        for (size_t j = 0; j < runs.size(); ++j) {
+            if (!runs[j].ok || runs[j].matrix != runs[i].matrix || runs[j].threads != runs[i].threads) continue;
+            if (runs[j].median_ms < runs[i].median_ms) best = false;
+            if (j < i && runs[j].median_ms == runs[i].median_ms) best = false;
+        }
+        if (best) {
+            std::cout << "  " << std::left << std::setw(16) << runs[i].matrix << std::right << std::setw(4) << runs[i].threads
+                      << " threads: " << runs[i].kernel << " (" << std::fixed << std::setprecision(3)
+                      << runs[i].median_ms << " ms median)\n";
+        }
+    }
+    std::cout << "==========================================\n";
+
+    return 0;
+}
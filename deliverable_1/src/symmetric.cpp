@@ -0,0 +1,89 @@
+#include "../include/symmetric.hpp"
+
+#include <algorithm>
+#include <omp.h>
+
+void sym_spmv_setup(int M, const int* row_ptr, const int* col_idx,
+                    int num_parts, SymSpmvPlan& plan) {
+    if (num_parts < 1) num_parts = 1;
+    const long long nnz = row_ptr[M];
+
+    plan.M = M;
+    plan.num_parts = num_parts;
+    plan.row_start.resize(num_parts + 1);
+    plan.col_min.resize(num_parts);
+    plan.partial.resize(num_parts);
+
+    // contiguous row blocks with (about) the same number of nonzeros
+    plan.row_start[0] = 0;
+    plan.row_start[num_parts] = M;
+    for (int p = 1; p < num_parts; ++p) {
+        long long target = nnz * p / num_parts;
+        int row = static_cast<int>(std::lower_bound(row_ptr, row_ptr + M + 1, target) - row_ptr);
+        plan.row_start[p] = std::max(plan.row_start[p - 1], std::min(row, M));
+    }
+
+    // lowest column each part scatters to → size of its private buffer
+    #pragma omp parallel for schedule(static, 1)
+    for (int p = 0; p < num_parts; ++p) {
+        const int r0 = plan.row_start[p];
+        int lo = r0;
+        for (int k = row_ptr[r0]; k < row_ptr[plan.row_start[p + 1]]; ++k) {
+            lo = std::min(lo, col_idx[k]);
+        }
+        plan.col_min[p] = lo;
+        plan.partial[p].assign(r0 - lo, 0.0);
+    }
+}
+
+void spmv_sym_lower(SymSpmvPlan& plan,
+                    const int* row_ptr, const int* col_idx, const double* values,
+                    const double* x, double* y) {
+    const int M = plan.M;
+    const int num_parts = plan.num_parts;
+
+    #pragma omp parallel
+    {
+        // ===== Phase 1: own rows, scatter to own block or private buffer =====
+        #pragma omp for schedule(static, 1)
+        for (int p = 0; p < num_parts; ++p) {
+            const int r0 = plan.row_start[p];
+            const int r1 = plan.row_start[p + 1];
+            const int lo = plan.col_min[p];
+            double* buf = plan.partial[p].data();
+
+            std::fill(y + r0, y + r1, 0.0);
+            std::fill(buf, buf + (r0 - lo), 0.0);
+
+            for (int i = r0; i < r1; ++i) {
+                const double xi = x[i];
+                double sum = 0.0;
+                for (int k = row_ptr[i]; k < row_ptr[i + 1]; ++k) {
+                    const int j = col_idx[k];
+                    const double a = values[k];
+                    sum += a * x[j];
+                    if (j == i) continue;
+                    if (j >= r0) {
+                        y[j] += a * xi;
+                    } else {
+                        buf[j - lo] += a * xi;
+                    }
+                }
+                y[i] += sum;
+            }
+        }
+        // implicit barrier: all private buffers are complete
+
+        // ===== Phase 2: reduce the private buffers into y =====
+        #pragma omp for schedule(static)
+        for (int j = 0; j < M; ++j) {
+            double sum = 0.0;
+            for (int p = 0; p < num_parts; ++p) {
+                if (j >= plan.col_min[p] && j < plan.row_start[p]) {
+                    sum += plan.partial[p][j - plan.col_min[p]];
+                }
+            }
+            y[j] += sum;
+        }
+    }
+}
@@ -0,0 +1,232 @@
+#include "../include/transpose.hpp"
+#include "../include/axpby.hpp"
+#include "../include/csr_convert.hpp"
+#include "../include/numa_alloc.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <omp.h>
+
+static const char* const method_names[] = {"auto", "csc", "private"};
+
+bool transpose_method_from_name(const std::string& name, TransposeMethod& method) {
+    for (int i = 0; i <= TRANSPOSE_PRIVATE; ++i) {
+        if (name == method_names[i]) {
+            method = static_cast<TransposeMethod>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* transpose_method_name(TransposeMethod method) {
+    return (method >= TRANSPOSE_AUTO && method <= TRANSPOSE_PRIVATE) ? method_names[method] : "unknown";
+}
+
+void csr_to_csc_parallel(int M, int N, const int* row_ptr, const int* col_idx, const double* values,
+                         std::vector<int>& col_ptr, std::vector<int>& row_idx,
+                         std::vector<double>& csc_values) {
+    const int nnz = row_ptr[M];
+    col_ptr.assign(N + 1, 0);
+    row_idx.resize(nnz);
+    csc_values.resize(nnz);
+    if (N == 0) return;
+
+    // one N-sized histogram per part, capped like the COO -> CSR converter
+    const long long hist_cap = static_cast<long long>(CSR_CONVERT_HIST_RATIO) * 2 * nnz / N;
+    const int num_parts = static_cast<int>(std::max(1LL, std::min<long long>(omp_get_max_threads(), hist_cap)));
+    std::vector<int> row_start;
+    numa_partition_rows(M, row_ptr, num_parts, row_start);
+    std::unique_ptr<int[]> hist(new int[static_cast<size_t>(num_parts) * N]);
+    std::unique_ptr<int[]> counts(new int[N]);
+
+    // 1. private histograms of the column indices
+    #pragma omp parallel for schedule(static, 1)
+    for (int p = 0; p < num_parts; ++p) {
+        int* h = hist.get() + static_cast<size_t>(p) * N;
+        std::fill(h, h + N, 0);
+        for (int k = row_ptr[row_start[p]]; k < row_ptr[row_start[p + 1]]; ++k) {
+            h[col_idx[k]]++;
+        }
+    }
+
+    // 2. column lengths and their exclusive scan
+    #pragma omp parallel for schedule(static)
+    for (int c = 0; c < N; ++c) {
+        int n = 0;
+        for (int p = 0; p < num_parts; ++p) n += hist[static_cast<size_t>(p) * N + c];
+        counts[c] = n;
+    }
+    exclusive_scan_parallel(N, counts.get(), col_ptr.data());
+
+    // 3. histograms -> write offsets of every part inside every column
+    #pragma omp parallel for schedule(static)
+    for (int c = 0; c < N; ++c) {
+        int offset = col_ptr[c];
+        for (int p = 0; p < num_parts; ++p) {
+            int& h = hist[static_cast<size_t>(p) * N + c];
+            const int n = h;
+            h = offset;
+            offset += n;
+        }
+    }
+
+    // 4. scatter: parts hold increasing row blocks and walk them in order,
+    //    so the rows of every column come out sorted
+    #pragma omp parallel for schedule(static, 1)
+    for (int p = 0; p < num_parts; ++p) {
+        int* h = hist.get() + static_cast<size_t>(p) * N;
+        for (int r = row_start[p]; r < row_start[p + 1]; ++r) {
+            for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+                const int dest = h[col_idx[k]]++;
+                row_idx[dest] = r;
+                csc_values[dest] = values[k];
+            }
+        }
+    }
+}
+
+// row blocks and their column ranges; returns the extra bytes per product
+static double private_partition(TransposePlan& plan, int num_threads) {
+    plan.num_parts = std::max(1, num_threads);
+    numa_partition_rows(plan.M, plan.row_ptr, plan.num_parts, plan.row_start);
+    plan.col_lo.assign(plan.num_parts, plan.N);
+    plan.col_hi.assign(plan.num_parts, 0);
+
+    #pragma omp parallel for schedule(static, 1)
+    for (int p = 0; p < plan.num_parts; ++p) {
+        int lo = plan.N, hi = 0;
+        for (int k = plan.row_ptr[plan.row_start[p]]; k < plan.row_ptr[plan.row_start[p + 1]]; ++k) {
+            lo = std::min(lo, plan.col_idx[k]);
+            hi = std::max(hi, plan.col_idx[k] + 1);
+        }
+        plan.col_lo[p] = lo;
+        plan.col_hi[p] = std::max(lo, hi);
+    }
+
+    // one part scatters straight into y: nothing extra
+    if (plan.num_parts == 1) return 0.0;
+    long long span = 0;
+    for (int p = 0; p < plan.num_parts; ++p) span += plan.col_hi[p] - plan.col_lo[p];
+    // every buffer entry is zeroed (write) and reduced (read)
+    return 16.0 * static_cast<double>(span);
+}
+
+void transpose_prepare(TransposePlan& plan, TransposeMethod method, int num_threads, long long expected_iters,
+                       int M, int N, const int* row_ptr, const int* col_idx, const double* values) {
+    transpose_release(plan);
+    plan.M = M;
+    plan.N = N;
+    plan.row_ptr = row_ptr;
+    plan.col_idx = col_idx;
+    plan.values = values;
+
+    auto start = std::chrono::steady_clock::now();
+    if (method != TRANSPOSE_CSC) {
+        plan.private_bytes = private_partition(plan, num_threads);
+    }
+    if (method == TRANSPOSE_AUTO) {
+        // expected_iters = 0 is the limit of the amortised rule: any extra traffic pays for the conversion
+        const double matrix_bytes = 12.0 * row_ptr[M] + 4.0 * M;
+        const bool convert = expected_iters > 0
+            ? static_cast<double>(expected_iters) * plan.private_bytes > TRANSPOSE_CONVERT_COST * matrix_bytes
+            : plan.private_bytes > 0.0;
+        method = convert ? TRANSPOSE_CSC : TRANSPOSE_PRIVATE;
+    }
+    plan.method = method;
+
+    if (method == TRANSPOSE_CSC) {
+        csr_to_csc_parallel(M, N, row_ptr, col_idx, values, plan.col_ptr, plan.row_idx, plan.csc_values);
+    } else if (plan.num_parts > 1) {
+        plan.buf_start.assign(plan.num_parts + 1, 0);
+        for (int p = 0; p < plan.num_parts; ++p) {
+            plan.buf_start[p + 1] = plan.buf_start[p] + (plan.col_hi[p] - plan.col_lo[p]);
+        }
+        plan.partial.resize(plan.buf_start[plan.num_parts]);
+    }
+    plan.setup_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// y = beta * y, then every row scatters alpha * x[r] * A(r, :) into y
+static void transpose_serial(const TransposePlan& plan, double alpha, const double* __restrict__ x, double beta,
+                             double* __restrict__ y) {
+    for (int c = 0; c < plan.N; ++c) y[c] = beta == 0.0 ? 0.0 : beta * y[c];
+    for (int r = 0; r < plan.M; ++r) {
+        const double xr = alpha * x[r];
+        for (int k = plan.row_ptr[r]; k < plan.row_ptr[r + 1]; ++k) {
+            y[plan.col_idx[k]] += plan.values[k] * xr;
+        }
+    }
+}
+
+static void transpose_private(TransposePlan& plan, double alpha, const double* __restrict__ x, double beta,
+                              double* __restrict__ y) {
+    const int* __restrict__ row_ptr = plan.row_ptr;
+    const int* __restrict__ col_idx = plan.col_idx;
+    const double* __restrict__ values = plan.values;
+    const int P = plan.num_parts;
+    const int tiles = (plan.N + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+
+    // parts are distributed with a worksharing loop, so a smaller team than P still covers them all
+    #pragma omp parallel num_threads(P)
+    {
+        #pragma omp for schedule(static, 1)
+        for (int p = 0; p < P; ++p) {
+            const int lo = plan.col_lo[p];
+            const int hi = plan.col_hi[p];
+            // indexed by column
+            double* __restrict__ buf = plan.partial.data() + plan.buf_start[p] - lo;
+            std::fill(buf + lo, buf + hi, 0.0);
+            for (int r = plan.row_start[p]; r < plan.row_start[p + 1]; ++r) {
+                const double xr = x[r];
+                for (int k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+                    buf[col_idx[k]] += values[k] * xr;
+                }
+            }
+        }
+
+        // column tiles: every part adds the slice of its buffer overlapping the
+        // tile, so each buffer entry is read once (the traffic in private_bytes)
+        #pragma omp for schedule(static)
+        for (int b = 0; b < tiles; ++b) {
+            const int c0 = b * TRANSPOSE_TILE;
+            const int c1 = std::min(plan.N, c0 + TRANSPOSE_TILE);
+            double sum[TRANSPOSE_TILE] = {};
+            for (int p = 0; p < P; ++p) {
+                const int lo = std::max(c0, plan.col_lo[p]);
+                const int hi = std::min(c1, plan.col_hi[p]);
+                const double* __restrict__ buf = plan.partial.data() + plan.buf_start[p] - plan.col_lo[p];
+                for (int c = lo; c < hi; ++c) sum[c - c0] += buf[c];
+            }
+            for (int c = c0; c < c1; ++c) {
+                y[c] = beta == 0.0 ? alpha * sum[c - c0] : alpha * sum[c - c0] + beta * y[c];
+            }
+        }
+    }
+}
+
+void spmv_transpose(TransposePlan& plan, double alpha, const double* x, double beta, double* y) {
+    if (plan.method == TRANSPOSE_CSC) {
+        spmv_csr_axpby(plan.N, plan.col_ptr.data(), plan.row_idx.data(), plan.csc_values.data(),
+                       alpha, x, beta, y, false);
+    } else if (plan.num_parts == 1) {
+        transpose_serial(plan, alpha, x, beta, y);
+    } else {
+        transpose_private(plan, alpha, x, beta, y);
+    }
+}
+
+void transpose_release(TransposePlan& plan) {
+    std::vector<int>().swap(plan.col_ptr);
+    std::vector<int>().swap(plan.row_idx);
+    std::vector<double>().swap(plan.csc_values);
+    plan.row_start.clear();
+    plan.col_lo.clear();
+    plan.col_hi.clear();
+    plan.buf_start.clear();
+    std::vector<double>().swap(plan.partial);
+    plan.num_parts = 0;
+    plan.private_bytes = 0.0;
+    plan.setup_ms = 0.0;
+}
@@ -0,0 +1,108 @@
+#ifndef CSR_BIN_HPP
+#define CSR_BIN_HPP
+
+/*
+ * @file csr_bin.hpp
+ * @brief Versioned binary CSR container (.csrb) with zero-copy mmap loading
+ *
+ * Layout (little endian, every section starts on a 64-byte boundary):
+ *
+ *   [ CsrBinHeader, 128 bytes ][ row_ptr (M+1) ][ col_idx (nnz) ][ values (nnz) ]
+ *
+ * The matrix is stored in full (symmetric files are expanded by the
+ * converter, symmetry only records what the source file declared), rows in
+ * the order of the .mtx reader. Loading maps the file read-only and points
+ * row_ptr / col_idx / values straight into the mapping: no parse, no copy,
+ * pages are faulted in by the first SpMV.
+ *
+ * The checksum is a word-wise FNV-1a over everything after the header; it is
+ * only recomputed when verification is requested (it reads the whole file).
+ *
+ * Reader side of deliverable_1/include/csr_bin.hpp (the files are written by
+ * deliverable_1's mtx_to_csrb); keep the two layouts in sync.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#define CSRBIN_MAGIC "SPMVCSR"
+#define CSRBIN_VERSION 1
+#define CSRBIN_ALIGN 64
+
+enum CsrBinSymmetry {
+    CSRBIN_GENERAL = 0,
+    CSRBIN_SYMMETRIC,
+    CSRBIN_SKEW_SYMMETRIC
+};
+
+struct CsrBinHeader {
+    char magic[8];              // CSRBIN_MAGIC, '\0' terminated
+    uint32_t version;           // CSRBIN_VERSION
+    uint32_t index_width;       // bytes per row_ptr / col_idx entry (4)
+    uint32_t value_width;       // bytes per value (8)
+    uint32_t symmetry;          // CsrBinSymmetry of the source file
+    int64_t M;
+    int64_t N;
+    int64_t nnz;
+    uint64_t row_ptr_offset;    // byte offsets from the start of the file
+    uint64_t col_idx_offset;
+    uint64_t values_offset;
+    uint64_t file_size;
+    uint64_t checksum;
+    // structural stats, computed once by the writer
+    int32_t row_min;            // fewest / most nonzeros in a row
+    int32_t row_max;
+    int64_t empty_rows;
+    int64_t bandwidth;          // max |i - j|
+    int64_t diagonal;           // stored entries with i == j
+    uint8_t reserved[8];
+};
+
+/**
+ * CSR matrix mapped from a .csrb file (row_ptr / col_idx / values point into
+ * the mapping). Not copyable; the mapping is released by the destructor.
+*/
+struct LoadedCsr {
+    int M = 0;
+    int N = 0;
+    int nnz = 0;
+    const int* row_ptr = nullptr;
+    const int* col_idx = nullptr;
+    const double* values = nullptr;
+
+    bool mapped = false;
+    CsrBinHeader header;            // valid if mapped
+    void* map_base = nullptr;
+    size_t map_size = 0;
+
+    LoadedCsr() {}
+    ~LoadedCsr();
+    LoadedCsr(const LoadedCsr&) = delete;
+    LoadedCsr& operator=(const LoadedCsr&) = delete;
+};
+
+/**
+ * @brief True if the file starts with the .csrb magic
+*/
+bool csr_bin_is_file(const std::string& filename);
+
+/**
+ * @brief Maps a .csrb file read-only and points A into it
+ *
+ * The header is validated (magic, version, widths, section bounds,
+ * row_ptr[0] = 0 and row_ptr[M] = nnz), then the arrays in one parallel
+ * pass: row_ptr non-decreasing, columns in [0, N) and sorted inside every
+ * row. With verify the checksum is recomputed as well. A is only modified
+ * when every check passes.
+ *
+ * @return false (message on stderr) if the file is not a valid container
+*/
+bool csr_bin_map(const std::string& filename, LoadedCsr& A, bool verify = false);
+
+/**
+ * @brief Checksum of the sections of a mapped file (as stored in the header)
+*/
+uint64_t csr_bin_checksum(const LoadedCsr& A);
+
+#endif
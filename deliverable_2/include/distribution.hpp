@@ -68,6 +68,34 @@ void distribute_matrix(int rank, int size, int M, int nz_global,
                        std::vector<double>& local_values,
                        int& local_M, int& local_nnz);
 
+/**
+ * @brief Builds this rank's part of the cyclic row distribution directly
+ *        from a global CSR matrix every rank can read (e.g. a mapped .csrb file)
+ *
+ * Produces the same local arrays as distribute_matrix() without any
+ * communication: each rank copies only its own rows out of the global arrays.
+ *
+ * @param rank              This process's MPI rank
+ * @param size              Total number of MPI processes
+ * @param M                 Global number of rows
+ * @param global_row_ptr    Full row pointers (readable on every rank)
+ * @param global_col_idx    Full column indices
+ * @param global_values     Full nonzero values
+ * @param local_row_ptr     [out] Local CSR row pointers
+ * @param local_col_idx     [out] Local column indices (global numbering)
+ * @param local_values      [out] Local nonzero values
+ * @param local_M           [out] Number of rows this process owns
+ * @param local_nnz         [out] Number of nonzeros this process owns
+*/
+void extract_local_rows(int rank, int size, int M,
+                        const int* global_row_ptr,
+                        const int* global_col_idx,
+                        const double* global_values,
+                        std::vector<int>& local_row_ptr,
+                        std::vector<int>& local_col_idx,
+                        std::vector<double>& local_values,
+                        int& local_M, int& local_nnz);
+
 void init_local_vector(int rank, int size, int N,
                        std::vector<double>& local_x,
                        int& local_col_count);
@@ -12,11 +12,34 @@ extern "C" {
 #include "../include/mmio.h"
 }
 
+// files smaller than this per thread are parsed by fewer threads
+#define MTX_MIN_CHUNK_BYTES (1 << 20)
+
+/**
+ * Timing of the last read: parse throughput = data_bytes / parse_ms.
+*/
+struct MtxLoadStats {
+    size_t data_bytes = 0;      // bytes of the entry section (after the size line)
+    int threads = 0;            // threads that parsed the entries
+    double parse_ms = 0.0;      // count + parse of the entries
+    double total_ms = 0.0;      // whole read, banner to CSR
+
+    double parse_mb_per_s() const {
+        return parse_ms > 0.0 ? data_bytes / (parse_ms / 1000.0) / 1e6 : 0.0;
+    }
+};
+
 /**
  * @brief Reads a Matrix Market file (.mtx) and converts it to CSR format
  *
- * Only called by rank 0. The file is expected to contain a sparse real
- * general matrix in coordinate format (i j value).
+ * Only called by rank 0. The file is expected to contain a sparse real or
+ * integer matrix in coordinate format (i j value), or a pattern matrix
+ * (i j, values set to 1). The banner and size line are read with mmio.c,
+ * the entries from a read-only mapping of the file split at line
+ * boundaries across the OpenMP threads. Symmetric and skew-symmetric
+ * files store one triangle only: the other one is generated, so the
+ * returned CSR always describes the full matrix (nz_global is updated).
+ * The CSR columns are sorted inside each row, duplicate entries are summed.
  *
  * Input indices are 1-based → converted to 0-based in output arrays.
  *
@@ -27,9 +50,10 @@ extern "C" {
  * @param row_ptr       [out] CSR row pointers (size = M+1)
  * @param col_idx       [out] CSR column indices (0-based, size = nz_global)
  * @param values        [out] CSR nonzero values (size = nz_global)
+ * @param load_stats    [out] optional, parse time and throughput
  * */
 void read_matrix_market(const std::string& filename, int& M, int& N, int& nz_global,
                         std::vector<int>& row_ptr, std::vector<int>& col_idx,
-                        std::vector<double>& values);
+                        std::vector<double>& values, MtxLoadStats* load_stats = nullptr);
 
 #endif
@@ -1,5 +1,7 @@
 #include "../include/distribution.hpp"
 
+#include <algorithm>
+
 void distribute_matrix(int rank, int size, int M, int nz_global,
                        const std::vector<int>& global_row_ptr,
                        const std::vector<int>& global_col_idx,
@@ -123,6 +125,36 @@ void distribute_matrix(int rank, int size, int M, int nz_global,
                  0, MPI_COMM_WORLD);
 }
 
+void extract_local_rows(int rank, int size, int M,
+                        const int* global_row_ptr,
+                        const int* global_col_idx,
+                        const double* global_values,
+                        std::vector<int>& local_row_ptr,
+                        std::vector<int>& local_col_idx,
+                        std::vector<double>& local_values,
+                        int& local_M, int& local_nnz) {
+    // rows gi = rank, rank + size, ... (same cyclic policy as distribute_matrix)
+    local_M = (M + size - 1 - rank) / size;
+    local_row_ptr.resize(local_M + 1);
+    local_row_ptr[0] = 0;
+    for (int i = 0; i < local_M; ++i) {
+        int gi = rank + i * size;
+        local_row_ptr[i + 1] = local_row_ptr[i] + global_row_ptr[gi + 1] - global_row_ptr[gi];
+    }
+    local_nnz = local_row_ptr[local_M];
+
+    local_col_idx.resize(local_nnz);
+    local_values.resize(local_nnz);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < local_M; ++i) {
+        int gi = rank + i * size;
+        int start = global_row_ptr[gi];
+        int cnt = global_row_ptr[gi + 1] - start;
+        std::copy(global_col_idx + start, global_col_idx + start + cnt, local_col_idx.begin() + local_row_ptr[i]);
+        std::copy(global_values + start, global_values + start + cnt, local_values.begin() + local_row_ptr[i]);
+    }
+}
+
 void init_local_vector(int rank, int size, int N,
                        std::vector<double>& local_x,
                        int& local_col_count) {
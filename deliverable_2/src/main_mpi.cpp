@@ -7,6 +7,7 @@
 #include <omp.h>
 
 #include "../include/matrix_io.hpp"
+#include "../include/csr_bin.hpp"
 #include "../include/matrix_gen.hpp"
 #include "../include/distribution.hpp"
 #include "../include/communication.hpp"
@@ -79,7 +80,7 @@ int main(int argc, char ** argv) {
 
     // Checks if the selection is not for synthetic matrix if the filename is provided
     if (!use_synthetic && matrix_filename.empty()) {
-        if (rank == 0) std::cerr << "Usage: mpirun -np P ./spmv_mpi <matrix.mtx> [--synthetic base_M density] [--threads T] [--verbose]\n";
+        if (rank == 0) std::cerr << "Usage: mpirun -np P ./spmv_mpi <matrix.mtx|matrix.csrb> [--synthetic base_M density] [--threads T] [--verbose]\n";
         MPI_Finalize();
         return 1;
     }
@@ -104,7 +105,25 @@ int main(int argc, char ** argv) {
     std::vector <int> global_row_ptr, global_col_idx;
     std::vector <double> global_values;
 
-    if (use_synthetic) {
+    // .csrb files are mapped by every rank (zero copy), each rank then takes
+    // its own rows: no parse on rank 0 and no scatter
+    LoadedCsr mapped;
+    const bool use_binary = !use_synthetic && csr_bin_is_file(matrix_filename);
+
+    if (use_binary) {
+        auto map_start = std::chrono::steady_clock::now();
+        if (!csr_bin_map(matrix_filename, mapped)) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        M = mapped.M;
+        N = mapped.N;
+        nz_global = mapped.nnz;
+        if (rank == 0 && verbose) {
+            std::cout << "Mapped " << matrix_filename << " in "
+                      << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - map_start).count()
+                      << " ms (zero copy)" << std::endl;
+        }
+    } else if (use_synthetic) {
         if (rank == 0) {
             M = base_M * size; // Scale with P for weak scaling
             N = M; // Square matrix
@@ -113,8 +132,13 @@ int main(int argc, char ** argv) {
         }
     } else {
         if (rank == 0) {
+            MtxLoadStats load;
             read_matrix_market(matrix_filename, M, N, nz_global,
-                global_row_ptr, global_col_idx, global_values);
+                global_row_ptr, global_col_idx, global_values, &load);
+            if (verbose) {
+                std::cout << "Loaded " << matrix_filename << " in " << load.total_ms << " ms (parse "
+                          << load.parse_mb_per_s() << " MB/s on " << load.threads << " threads)" << std::endl;
+            }
         }
     }
 
@@ -133,10 +157,17 @@ int main(int argc, char ** argv) {
     std::vector <int> local_row_ptr, local_col_idx;
     std::vector <double> local_values;
     int local_M = 0, local_nnz = 0;
-    distribute_matrix(rank, size, M, nz_global,
-        global_row_ptr, global_col_idx, global_values,
-        local_row_ptr, local_col_idx, local_values,
-        local_M, local_nnz);
+    if (use_binary) {
+        extract_local_rows(rank, size, M,
+            mapped.row_ptr, mapped.col_idx, mapped.values,
+            local_row_ptr, local_col_idx, local_values,
+            local_M, local_nnz);
+    } else {
+        distribute_matrix(rank, size, M, nz_global,
+            global_row_ptr, global_col_idx, global_values,
+            local_row_ptr, local_col_idx, local_values,
+            local_M, local_nnz);
+    }
 
     // Free global matrix memory on rank 0 (no longer needed)
     if (rank == 0) {